@@ -3,8 +3,12 @@
 #define CONFIGURU_IMPLEMENTATION 1
 #include <../configuru.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <new>
 
 #include <boost/filesystem.hpp>
 
@@ -15,6 +19,30 @@ using namespace configuru;
 
 // ----------------------------------------------------------------------------
 
+// Bytes allocated with new and not yet deleted. See benchmark_memory.
+static std::atomic<size_t> s_heap_bytes { 0 };
+
+// noinline, or GCC warns about the size header when it sees both sides of it.
+__attribute__((noinline)) void* operator new(size_t size)
+{
+	// Remember the size in front of the block:
+	char* block = static_cast<char*>(malloc(sizeof(max_align_t) + size));
+	if (!block) { throw std::bad_alloc(); }
+	*reinterpret_cast<size_t*>(block) = size;
+	s_heap_bytes += size;
+	return block + sizeof(max_align_t);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr) noexcept
+{
+	if (!ptr) { return; }
+	char* block = static_cast<char*>(ptr) - sizeof(max_align_t);
+	s_heap_bytes -= *reinterpret_cast<size_t*>(block);
+	free(block);
+}
+
+// ----------------------------------------------------------------------------
+
 std::vector<std::string> list_file_names(fs::path directory, std::string extension)
 {
     std::vector<std::string> result;
@@ -29,14 +57,191 @@ std::vector<std::string> list_file_names(fs::path directory, std::string extensi
     return result;
 }
 
+// Many tiny messages, where the per-call setup cost matters more than the parsing itself.
+void benchmark_messages()
+{
+	const char* message = R"({"id": 1234, "type": "update", "position": [1.5, -2.25, 3.0], "valid": true})";
+	const int num_messages = 1000000;
+
+	auto time_it = [&](const char* name, const std::function<Config()>& parse) {
+		const auto start = std::chrono::steady_clock::now();
+		int64_t checksum = 0;
+		for (int i = 0; i < num_messages; ++i) {
+			checksum += (int64_t)parse()["id"];
+		}
+		const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+		std::cout << name << ": " << duration.count() << " s for " << num_messages << " messages"
+		          << " (checksum " << checksum << ")" << std::endl;
+	};
+
+	time_it("parse_string", [&]() { return parse_string(message, JSON, "message"); });
+
+	ParseSession session(JSON);
+	time_it("ParseSession", [&]() { return session.parse_string(message, "message"); });
+}
+
+// A commented .cfg file, parsed with and without keeping the comments.
+void benchmark_comments()
+{
+	std::string cfg;
+	for (int i = 0; i < 100000; ++i) {
+		cfg += "// Record number " + std::to_string(i) + "\n";
+		cfg += "// It has a few lines of description.\n";
+		cfg += "record_" + std::to_string(i) + ": {\n";
+		cfg += "\tid:    " + std::to_string(i) + " // The id\n";
+		cfg += "\tname:  \"name\" /* The name */\n";
+		cfg += "\tvalid: true\n";
+		cfg += "}\n";
+	}
+
+	auto time_it = [&](const char* name, const FormatOptions& options) {
+		const auto start = std::chrono::steady_clock::now();
+		const Config config = parse_string(cfg.c_str(), cfg.size(), options, "comments");
+		const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+		std::cout << name << ": " << duration.count() << " s for " << cfg.size() / 1e6 << " MB"
+		          << " (" << config.object_size() << " records)" << std::endl;
+	};
+
+	time_it("keep_comments = true ", CFG);
+	auto options = CFG;
+	options.keep_comments = false;
+	time_it("keep_comments = false", options);
+}
+
+// Looking up keys in, and iterating over, objects of different sizes. See CONFIGURU_FLAT_OBJECTS and Config::freeze.
+void benchmark_objects()
+{
+	const size_t num_operations = 10000000;
+
+	for (size_t size : {4, 16, 256, 4096}) {
+		Config object = Config::object();
+		std::vector<std::string> keys;
+		for (size_t i = 0; i < size; ++i) {
+			keys.push_back("key_" + std::to_string(i));
+			object[keys.back()] = i;
+		}
+		const Config& const_object = object;
+		const FrozenConfig frozen = object.freeze();
+
+		auto time_it = [&](const char* name, const std::function<int64_t()>& pass) {
+			const size_t num_passes = num_operations / size;
+			const auto start = std::chrono::steady_clock::now();
+			int64_t checksum = 0;
+			for (size_t i = 0; i < num_passes; ++i) {
+				checksum += pass();
+			}
+			const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+			std::cout << size << " keys, " << name << ": " << 1e9 * duration.count() / (num_passes * size)
+			          << " ns per key (checksum " << checksum << ")" << std::endl;
+		};
+
+		time_it("lookup ", [&]() {
+			int64_t sum = 0;
+			for (const auto& key : keys) { sum += (int64_t)const_object[key]; }
+			return sum;
+		});
+		time_it("iterate", [&]() {
+			int64_t sum = 0;
+			for (auto&& p : const_object.as_object()) { sum += (int64_t)p.value(); }
+			return sum;
+		});
+		time_it("frozen lookup ", [&]() {
+			int64_t sum = 0;
+			for (const auto& key : keys) { sum += frozen[key].get<int64_t>(); }
+			return sum;
+		});
+		time_it("frozen iterate", [&]() {
+			int64_t sum = 0;
+			for (const auto& p : frozen.as_object()) { sum += p.value().get<int64_t>(); }
+			return sum;
+		});
+	}
+}
+
+// How much memory a parsed document takes, per value in it.
+void benchmark_memory(const fs::path& in_dir)
+{
+	size_t total_values = 0;
+	size_t total_bytes  = 0;
+
+	for (const auto& filename : list_file_names(in_dir, ".json")) {
+		const size_t heap_before = s_heap_bytes;
+		Config* config = new Config(parse_file((in_dir / filename).string(), JSON));
+		const size_t bytes = s_heap_bytes - heap_before;
+
+		size_t num_values = 0;
+		visit_configs(*config, [&](const Config&) { num_values += 1; });
+		delete config;
+
+		std::cout << filename << ": " << num_values << " values, "
+		          << (double)bytes / num_values << " bytes per value" << std::endl;
+		total_values += num_values;
+		total_bytes  += bytes;
+	}
+
+	std::cout << "sizeof(Config): " << sizeof(Config) << ", heap: "
+	          << (double)total_bytes / total_values << " bytes per value" << std::endl;
+}
+
+// Parsing and destroying each document, with and without FormatOptions::arena.
+void benchmark_arena(const fs::path& in_dir)
+{
+	for (const auto& filename : list_file_names(in_dir, ".json")) {
+		auto time_it = [&](const char* name, const FormatOptions& options) {
+			const auto start = std::chrono::steady_clock::now();
+			Config* config = new Config(parse_file((in_dir / filename).string(), options));
+			const auto parsed = std::chrono::steady_clock::now();
+			const size_t heap_bytes = s_heap_bytes;
+			delete config;
+			const auto destroyed = std::chrono::steady_clock::now();
+			const std::chrono::duration<double> parse_duration = parsed - start;
+			const std::chrono::duration<double> destroy_duration = destroyed - parsed;
+			std::cout << filename << ", " << name << ": parse " << parse_duration.count() << " s, destroy "
+			          << destroy_duration.count() << " s, " << heap_bytes / 1e6 << " MB from operator new" << std::endl;
+		};
+
+		FormatOptions options = JSON;
+		time_it("heap ", options);
+		options.arena = true;
+		time_it("arena", options);
+		options.arena_huge_pages = true;
+		time_it("arena with huge pages", options);
+	}
+}
+
 int main(int argc, char* argv[])
 {
-	bool use_configuru = (argc == 1 || strcmp(argv[1], "configuru") == 0);
-	std::cout << "Using " << (use_configuru ? "configuru" : "nlohmann::json") << std::endl;
+	if (argc > 1 && strcmp(argv[1], "messages") == 0) {
+		benchmark_messages();
+		return 0;
+	}
+
+	if (argc > 1 && strcmp(argv[1], "comments") == 0) {
+		benchmark_comments();
+		return 0;
+	}
+
+	if (argc > 1 && strcmp(argv[1], "objects") == 0) {
+		benchmark_objects();
+		return 0;
+	}
 
 	const fs::path in_dir  = "../../test_suite/huge/in";
 	const fs::path out_dir = "../../test_suite/huge/out";
 
+	if (argc > 1 && strcmp(argv[1], "memory") == 0) {
+		benchmark_memory(argc > 2 ? fs::path(argv[2]) : in_dir);
+		return 0;
+	}
+
+	if (argc > 1 && strcmp(argv[1], "arena") == 0) {
+		benchmark_arena(argc > 2 ? fs::path(argv[2]) : in_dir);
+		return 0;
+	}
+
+	bool use_configuru = (argc == 1 || strcmp(argv[1], "configuru") == 0);
+	std::cout << "Using " << (use_configuru ? "configuru" : "nlohmann::json") << std::endl;
+
 	for (const auto& filename : list_file_names(in_dir, ".json")) {
 		const auto in_path  = in_dir  / filename;
 		const auto out_path = out_dir / filename;
@@ -77,13 +77,42 @@ www.github.com/emilk/configuru
 #include <utility>
 #include <vector>
 
+#if __cplusplus >= 201703L
+	#include <string_view>
+	#if defined(__has_include)
+		#if __has_include(<memory_resource>)
+			#include <memory_resource>
+			#define CONFIGURU_HAS_PMR 1
+		#endif
+	#endif
+#endif
+
 #ifdef VISITABLE_STRUCT
 	#include <unordered_map>
 #endif
 
+#ifndef CONFIGURU_EXCEPTIONS
+	/// Set to 0 to use Configuru without exceptions (e.g. with -fno-exceptions).
+	/// By default this follows whether the compiler has exceptions enabled.
+	/// Without exceptions CONFIGURU_ONERROR prints the message and aborts,
+	/// so use parse_string_noexcept/parse_file_noexcept to handle syntax errors.
+	#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+		#define CONFIGURU_EXCEPTIONS 1
+	#else
+		#define CONFIGURU_EXCEPTIONS 0
+	#endif
+#endif // CONFIGURU_EXCEPTIONS
+
 #ifndef CONFIGURU_ONERROR
-	#define CONFIGURU_ONERROR(message_str) \
-		throw std::runtime_error(message_str)
+	#if CONFIGURU_EXCEPTIONS
+		#define CONFIGURU_ONERROR(message_str) \
+			throw std::runtime_error(message_str)
+	#else
+		#include <cstdio>
+		#include <cstdlib>
+		#define CONFIGURU_ONERROR(message_str) \
+			do { fprintf(stderr, "%s\n", std::string(message_str).c_str()); abort(); } while (false)
+	#endif
 #endif // CONFIGURU_ONERROR
 
 #ifndef CONFIGURU_ASSERT
@@ -118,6 +147,24 @@ www.github.com/emilk/configuru
 	#define CONFIGURU_VALUE_SEMANTICS 0
 #endif
 
+#ifndef CONFIGURU_SIMD
+	/// Set to 0 to make the parser scan its input one byte at a time instead of using SSE2/AVX2.
+	#define CONFIGURU_SIMD 1
+#endif
+
+#ifndef CONFIGURU_LOCATIONS
+	/// Set to 0 to not remember where in the source each value is (see Config::where()).
+	/// Makes every Config 8 bytes smaller, and parsing a little faster.
+	#define CONFIGURU_LOCATIONS 1
+#endif
+
+#ifndef CONFIGURU_FLAT_OBJECTS
+	/// Set to 1 to store the entries of an object in a vector, in insertion order, with a hash index
+	/// for lookups, instead of in a std::map. Iterating over an object then gives the keys in the order
+	/// they were added rather than sorted. Uses less memory, and lookups and iteration are faster.
+	#define CONFIGURU_FLAT_OBJECTS 0
+#endif
+
 #undef Bool // Needed on Ubuntu 14.04 with GCC 4.8.5
 #undef check // Needed on OSX
 
@@ -127,6 +174,9 @@ namespace configuru
 	struct DocInfo;
 	using DocInfo_SP = std::shared_ptr<DocInfo>;
 
+	struct ParseFailure;
+	struct ParseInfo;
+
 	using Index = unsigned;
 	const Index BAD_INDEX = static_cast<Index>(-1);
 
@@ -140,6 +190,7 @@ namespace configuru
 	};
 
 	/// Helper for describing a document.
+	/// A Config only stores the id of its document, which keeps the DocInfo alive (see DocTable).
 	struct DocInfo
 	{
 		std::vector<Include> includers;
@@ -149,9 +200,162 @@ namespace configuru
 		DocInfo(const std::string& fn) : filename(fn) { }
 
 		void append_include_info(std::string& ret, const std::string& indent="    ") const;
+
+	private:
+		friend struct DocTable;
+		uint16_t _id = 0; // While some Config is tagged with us, else 0. Guarded by DocTable::mutex.
 	};
 
 	struct BadLookupInfo;
+	class FrozenConfig;
+
+	/// Where in the source the contents of an array/object are, until they are parsed. See parse_file_lazy.
+	struct LazyRange;
+	using LazyRange_SP = std::shared_ptr<const LazyRange>;
+
+	/// What we know about an interned key. See Key.
+	struct KeyInfo
+	{
+		size_t                hash          = 0;
+		bool                  is_identifier = false;
+		std::atomic<unsigned> ref_count { 0 };
+	};
+
+	/// An object key. Keys are interned: all equal keys share one string in a global table,
+	/// so an array of a million records with the same few keys only stores each key once,
+	/// and equal keys can be told apart from different ones by comparing pointers.
+	/// A Key converts to `const std::string&`, so it can mostly be used as one.
+	class Key
+	{
+	public:
+		Key(const std::string& str);
+		Key(const char* str) : Key(std::string(str)) {}
+
+		Key(const Key& o) noexcept : _str(o._str), _info(o._info)
+		{
+			if (_info) { _info->ref_count.fetch_add(1, std::memory_order_relaxed); }
+		}
+
+		Key(Key&& o) noexcept : _str(o._str), _info(o._info) { o._info = nullptr; }
+
+		~Key() { if (_info) { release(); } }
+
+		Key& operator=(Key o) noexcept
+		{
+			std::swap(_str,  o._str);
+			std::swap(_info, o._info);
+			return *this;
+		}
+
+		/// For looking up `str` in an object, without interning it. Must not outlive `str`.
+		static Key lookup(const std::string& str) { return Key(&str); }
+
+		const std::string& str()   const { return *_str; }
+		const char*        c_str() const { return _str->c_str(); }
+		size_t             size()  const { return _str->size(); }
+		operator const std::string&() const { return *_str; }
+
+		size_t hash() const;
+
+		/// Can it be written without quotes, e.g. `foo_bar`?
+		bool is_identifier() const;
+
+		friend bool operator==(const Key& a, const Key& b)
+		{
+			// Two different interned keys are never equal:
+			return a._str == b._str || ((!a._info || !b._info) && *a._str == *b._str);
+		}
+
+		friend bool operator!=(const Key& a, const Key& b) { return !(a == b); }
+
+		friend bool operator<(const Key& a, const Key& b) { return a._str != b._str && *a._str < *b._str; }
+
+	private:
+		friend struct KeyTable;
+
+		Key() : _str(nullptr), _info(nullptr) {}
+		explicit Key(const std::string* not_interned) : _str(not_interned), _info(nullptr) {}
+
+		void release();
+
+		const std::string* _str;
+		KeyInfo*           _info; // nullptr unless interned (and not moved from)
+	};
+
+	/// Where the memory of Configs comes from: arrays, objects, longer strings, and the storage inside
+	/// arrays and objects. Works like std::pmr::memory_resource (see PmrResource), so it can be a pool,
+	/// a monotonic buffer, NUMA-local memory, or count the allocations.
+	/// Wherever a MemoryResource* is asked for, nullptr means the heap (operator new and delete).
+	/// A resource must outlive the Configs using it, and may be called on any thread that changes or frees them.
+	class MemoryResource
+	{
+	public:
+		virtual ~MemoryResource() = default;
+		virtual void* allocate(size_t size, size_t alignment) = 0;
+		virtual void deallocate(void* ptr, size_t size, size_t alignment) = 0;
+
+		/// What a copy of a value allocated from us allocates from.
+		/// The arena of a document (see FormatOptions::arena) gives its upstream, so copies do not keep the document alive.
+		virtual MemoryResource* resource_for_copies() { return this; }
+	};
+
+#if CONFIGURU_HAS_PMR
+	/// Lets Configs use a std::pmr::memory_resource.
+	class PmrResource : public MemoryResource
+	{
+	public:
+		explicit PmrResource(std::pmr::memory_resource* upstream) : _upstream(upstream) {}
+
+		void* allocate(size_t size, size_t alignment) override { return _upstream->allocate(size, alignment); }
+		void deallocate(void* ptr, size_t size, size_t alignment) override { _upstream->deallocate(ptr, size, alignment); }
+
+	private:
+		std::pmr::memory_resource* _upstream;
+	};
+#endif
+
+	/// Helper: an allocator for a MemoryResource, like std::pmr::polymorphic_allocator,
+	/// except that it goes along with the contents when a container is swapped or assigned.
+	template<typename T>
+	class Allocator
+	{
+	public:
+		using value_type = T;
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap            = std::true_type;
+
+		Allocator(MemoryResource* resource = nullptr) noexcept : _resource(resource) {}
+
+		template<typename U>
+		Allocator(const Allocator<U>& other) noexcept : _resource(other.resource()) {}
+
+		T* allocate(size_t n)
+		{
+			const size_t size = n * sizeof(T);
+			return static_cast<T*>(_resource ? _resource->allocate(size, alignof(T)) : ::operator new(size));
+		}
+
+		void deallocate(T* ptr, size_t n) noexcept
+		{
+			if (_resource) {
+				_resource->deallocate(ptr, n * sizeof(T), alignof(T));
+			} else {
+				::operator delete(ptr);
+			}
+		}
+
+		MemoryResource* resource() const noexcept { return _resource; }
+
+		template<typename U>
+		bool operator==(const Allocator<U>& other) const noexcept { return _resource == other.resource(); }
+
+		template<typename U>
+		bool operator!=(const Allocator<U>& other) const noexcept { return _resource != other.resource(); }
+
+	private:
+		MemoryResource* _resource;
+	};
 
 	/// Helper: value in an object.
 	template<typename Config_T>
@@ -163,6 +367,158 @@ namespace configuru
 
 		Config_Entry() {}
 		Config_Entry(Config_T value, Index nr) : _value(std::move(value)), _nr(nr) {}
+
+		/// Swaps everything, including the comments and location of the values
+		/// (assigning a Config keeps those of the target when the source has none).
+		friend void swap(Config_Entry& a, Config_Entry& b) noexcept
+		{
+			a._value.swap(b._value);
+			std::swap(a._nr,       b._nr);
+			std::swap(a._accessed, b._accessed);
+		}
+	};
+
+	/// Helper: the storage of an object when CONFIGURU_FLAT_OBJECTS is set.
+	/// The entries are kept in a vector, in the order they were added, and found through an
+	/// open-addressing hash index into it. Small maps have no index and are searched linearly,
+	/// which is faster for the few keys of a typical record (interned keys compare by pointer).
+	/// Has the parts of the std::map interface that Config uses. Erasing is O(size).
+	template<typename Value>
+	class FlatMap
+	{
+	public:
+		using value_type     = std::pair<Key, Value>;
+		using allocator_type = Allocator<value_type>;
+		using iterator       = typename std::vector<value_type, allocator_type>::iterator;
+		using const_iterator = typename std::vector<value_type, allocator_type>::const_iterator;
+
+		explicit FlatMap(const allocator_type& allocator = allocator_type())
+			: _entries(allocator), _slots(Allocator<uint64_t>(allocator)) {}
+
+		FlatMap(const FlatMap& o) = default;
+
+		FlatMap(const FlatMap& o, const allocator_type& allocator)
+			: _entries(o._entries, allocator), _slots(o._slots, Allocator<uint64_t>(allocator)) {}
+
+		allocator_type get_allocator() const { return _entries.get_allocator(); }
+
+		iterator       begin()        { return _entries.begin();  }
+		iterator       end()          { return _entries.end();    }
+		const_iterator begin()  const { return _entries.begin();  }
+		const_iterator end()    const { return _entries.end();    }
+		const_iterator cbegin() const { return _entries.cbegin(); }
+		const_iterator cend()   const { return _entries.cend();   }
+
+		size_t size()  const { return _entries.size();  }
+		bool   empty() const { return _entries.empty(); }
+
+		iterator       find(const Key& key)       { return _entries.begin() + static_cast<std::ptrdiff_t>(find_index(key)); }
+		const_iterator find(const Key& key) const { return _entries.begin() + static_cast<std::ptrdiff_t>(find_index(key)); }
+		size_t         count(const Key& key) const { return find_index(key) != _entries.size() ? 1 : 0; }
+
+		/// Adds the entry unless there already is one with that key. Returns where the entry is, and if it was added.
+		std::pair<iterator, bool> emplace(Key key, Value value)
+		{
+			const bool indexed = !_slots.empty();
+			const size_t hash = indexed ? key.hash() : 0;
+			const size_t found = indexed ? find_indexed(key, hash) : find_linear(key);
+			if (found != _entries.size()) {
+				return {_entries.begin() + static_cast<std::ptrdiff_t>(found), false};
+			}
+
+			_entries.emplace_back(std::move(key), std::move(value));
+			if (indexed && 2 * _entries.size() <= _slots.size()) {
+				add_to_index(_entries.size() - 1, hash);
+			} else if (_entries.size() > LINEAR_MAX) {
+				rebuild_index();
+			}
+			return {_entries.end() - 1, true};
+		}
+
+		Value& operator[](const Key& key)
+		{
+			const size_t found = find_index(key);
+			if (found != _entries.size()) {
+				return _entries[found].second;
+			}
+			return emplace(key, Value()).first->second;
+		}
+
+		iterator erase(iterator it)
+		{
+			// Swapped down rather than move-assigned, so that nothing of the erased entry sticks to the next one:
+			const auto i = it - _entries.begin();
+			for (auto next = it + 1; next != _entries.end(); ++it, ++next) {
+				using std::swap;
+				swap(*it, *next);
+			}
+			_entries.pop_back();
+			if (!_slots.empty()) { rebuild_index(); }
+			return _entries.begin() + i;
+		}
+
+		void swap(FlatMap& other)
+		{
+			_entries.swap(other._entries);
+			_slots.swap(other._slots);
+		}
+
+		void clear()
+		{
+			_entries.clear();
+			_slots.clear();
+		}
+
+	private:
+		static const size_t LINEAR_MAX = 8; // Bigger maps get an index.
+
+		size_t find_index(const Key& key) const
+		{
+			return _slots.empty() ? find_linear(key) : find_indexed(key, key.hash());
+		}
+
+		size_t find_linear(const Key& key) const
+		{
+			for (size_t i = 0; i < _entries.size(); ++i) {
+				if (_entries[i].first == key) { return i; }
+			}
+			return _entries.size();
+		}
+
+		size_t find_indexed(const Key& key, size_t hash) const
+		{
+			const size_t mask = _slots.size() - 1;
+			const uint32_t tag = static_cast<uint32_t>(hash);
+			for (size_t s = hash & mask; _slots[s] != 0; s = (s + 1) & mask) {
+				const size_t i = static_cast<uint32_t>(_slots[s]) - 1;
+				if ((_slots[s] >> 32) == tag && _entries[i].first == key) { return i; }
+			}
+			return _entries.size();
+		}
+
+		void add_to_index(size_t i, size_t hash)
+		{
+			const size_t mask = _slots.size() - 1;
+			size_t s = hash & mask;
+			while (_slots[s] != 0) { s = (s + 1) & mask; }
+			_slots[s] = (static_cast<uint64_t>(static_cast<uint32_t>(hash)) << 32) | (i + 1);
+		}
+
+		// Makes room for twice as many entries as we have, so the probe sequences stay short.
+		void rebuild_index()
+		{
+			_slots.clear();
+			if (_entries.size() <= LINEAR_MAX) { return; }
+			size_t num_slots = 4 * LINEAR_MAX;
+			while (num_slots < 4 * _entries.size()) { num_slots *= 2; }
+			_slots.resize(num_slots, 0);
+			for (size_t i = 0; i < _entries.size(); ++i) {
+				add_to_index(i, _entries[i].first.hash());
+			}
+		}
+
+		std::vector<value_type, allocator_type>   _entries;
+		std::vector<uint64_t, Allocator<uint64_t>> _slots; // Hash in the high 32 bits, entry index + 1 in the low (0 = empty slot).
 	};
 
 	using Comment = std::string;
@@ -183,6 +539,13 @@ namespace configuru
 		void append(ConfigComments&& other);
 	};
 
+	/// The comments of a Config that has any, in the CommentStore of its document.
+	struct CommentEntry
+	{
+		Index          line = BAD_INDEX; ///< Of the Config, which keeps our index where it otherwise keeps its line.
+		ConfigComments comments;
+	};
+
 	/// A dynamic config variable.
 	class Config;
 
@@ -211,7 +574,7 @@ namespace configuru
 	class Config
 	{
 	public:
-		enum Type
+		enum Type : uint8_t
 		{
 			Uninitialized, ///< Accessing a Config of this type is always an error.
 			BadLookupType, ///< We are the result of a key-lookup in a Object with no hit. We are in effect write-only.
@@ -220,14 +583,25 @@ namespace configuru
 
 		using ObjectEntry = Config_Entry<Config>;
 
-		using ConfigArrayImpl = std::vector<Config>;
-		using ConfigObjectImpl = std::map<std::string, ObjectEntry>;
+		using ConfigArrayImpl = std::vector<Config, Allocator<Config>>;
+		#if CONFIGURU_FLAT_OBJECTS
+			using ConfigObjectImpl = FlatMap<ObjectEntry>;
+		#else
+			using ConfigObjectImpl = std::map<Key, ObjectEntry, std::less<Key>, Allocator<std::pair<const Key, ObjectEntry>>>;
+		#endif
 		struct ConfigArray
 		{
 			#if !CONFIGURU_VALUE_SEMANTICS
 				std::atomic<unsigned> _ref_count { 1 };
 			#endif
-			ConfigArrayImpl _impl;
+			ConfigArrayImpl   _impl;
+			LazyRange_SP      _lazy;                  ///< Set until _impl has been parsed.
+			std::atomic<bool> _is_lazy { false };     ///< _lazy is set. Read without a lock, see parse_lazy.
+			bool              _lazy_accessed = false; ///< mark_accessed before _impl was parsed.
+			MemoryResource*   _resource;              ///< We were allocated from this, as is _impl (nullptr: the heap).
+
+			explicit ConfigArray(MemoryResource* resource) : _impl(Allocator<Config>(resource)), _resource(resource) {}
+			ConfigArray(const ConfigArray& o, MemoryResource* resource);
 		};
 		struct ConfigObject;
 
@@ -253,7 +627,8 @@ namespace configuru
 			_u.i = static_cast<int64_t>(i);
 		}
 		Config(const char* str);
-		Config(std::string str);
+		Config(const std::string& str);
+		Config(const char* str, size_t size); ///< The string may contain zeros.
 
 		/** This constructor is a short-form for Config::object(...).
 		    We have no short-form for Config::array(...),
@@ -309,29 +684,48 @@ namespace configuru
 		}
 
 		/// Used by the parser - no need to use directly.
-		void make_object();
+		void make_object(MemoryResource* resource = nullptr);
+
+		/// Used by the parser - no need to use directly.
+		void make_array(MemoryResource* resource = nullptr);
 
 		/// Used by the parser - no need to use directly.
-		void make_array();
+		/// Makes this a String. Unless it fits in the Config itself, it is allocated from the resource.
+		void make_string(const char* str, size_t size, MemoryResource* resource);
 
 		/// Used by the parser - no need to use directly.
 		void tag(const DocInfo_SP& doc, Index line, Index column);
 
+		/// Used by the parser - no need to use directly.
+		/// Makes this an array/object whose contents are parsed on first access.
+		void make_lazy(bool is_object, LazyRange_SP range);
+
+		/// Used by the parser - no need to use directly.
+		/// Fully parses the lazy arrays/objects in this array/object, on up to num_threads threads.
+		void parse_lazy_children(unsigned num_threads) const;
+
 		/// Preferred way to create an empty object.
 		static Config object();
 
+		/// An empty object whose memory, and that of its contents, comes from the given resource.
+		static Config object(MemoryResource* resource);
+
 		/// Preferred way to create an object.
 		static Config object(std::initializer_list<std::pair<std::string, Config>> values);
 
 		/// Preferred way to create an empty array.
 		static Config array();
 
+		/// An empty array whose memory, and that of its contents, comes from the given resource.
+		static Config array(MemoryResource* resource);
+
 		/// Preferred way to create an array.
 		static Config array(std::initializer_list<Config> values);
 
 		/// Preferred way to create an array from an STL container.
 		template<typename Container>
-		static Config array(const Container& container)
+		static typename std::enable_if<!std::is_pointer<Container>::value, Config>::type
+		array(const Container& container)
 		{
 			Config ret;
 			ret.make_array();
@@ -379,12 +773,22 @@ namespace configuru
 		/// Returns file:line iff available.
 		std::string where() const;
 
-		/// BAD_INDEX if not set.
-		Index line() const { return _line; }
-
-		/// Handle to document.
-		const DocInfo_SP& doc() const { return _doc; }
-		void set_doc(const DocInfo_SP& doc) { _doc = doc; }
+		#if CONFIGURU_LOCATIONS
+			/// BAD_INDEX if not set.
+			Index line() const { return (_flags & HasComments) ? comment_entry().line : _line; }
+
+			/// Handle to document, or nullptr if none.
+			DocInfo_SP doc() const;
+			void set_doc(const DocInfo_SP& doc);
+
+			/// Identifies doc() without looking it up. 0 if none.
+			uint32_t doc_id() const { return _doc_id; }
+		#else
+			Index line() const { return BAD_INDEX; }
+			DocInfo_SP doc() const { return nullptr; }
+			void set_doc(const DocInfo_SP&) { }
+			uint32_t doc_id() const { return 0; }
+		#endif
 
 		// ----------------------------------------
 		// Convertors:
@@ -485,8 +889,16 @@ namespace configuru
 		}
 #endif
 
-		const std::string& as_string() const { assert_type(String); return *_u.str; }
-		const char* c_str() const { assert_type(String); return _u.str->c_str(); }
+		/// c_str() and string_size() (or as_string_view()) read a string without copying it.
+		/// as_string() returns a copy, which allocates unless the string is short.
+		/// Short strings are stored inside of the Config, so what c_str() returns
+		/// is only valid until the Config is changed, moved or destroyed.
+		const char* c_str() const { assert_type(String); return string_data(); }
+		size_t string_size() const { assert_type(String); return string_length(); }
+		std::string as_string() const { assert_type(String); return std::string(string_data(), string_length()); }
+		#if __cplusplus >= 201703L
+			std::string_view as_string_view() const { assert_type(String); return {string_data(), string_length()}; }
+		#endif
 
 		/// The Config must be a boolean.
 		bool as_bool() const
@@ -552,6 +964,7 @@ namespace configuru
 		ConfigArrayImpl& as_array()
 		{
 			assert_type(Array);
+			if (_u.array->_is_lazy.load(std::memory_order_acquire)) { parse_lazy(); }
 			return _u.array->_impl;
 		}
 
@@ -559,6 +972,7 @@ namespace configuru
 		const ConfigArrayImpl& as_array() const
 		{
 			assert_type(Array);
+			if (_u.array->_is_lazy.load(std::memory_order_acquire)) { parse_lazy(); }
 			return _u.array->_impl;
 		}
 
@@ -592,19 +1006,11 @@ namespace configuru
 
 		/// Only use this for iterating over an object:
 		/// `for (auto& p : cfg.as_object()) { p.value() = p.key(); }`
-		ConfigObject& as_object()
-		{
-			assert_type(Object);
-			return *_u.object;
-		}
+		ConfigObject& as_object();
 
 		/// Only use this for iterating over an object:
 		/// `for (const auto& p : cfg.as_object()) { cout << p.key() << ": " << p.value(); }`
-		const ConfigObject& as_object() const
-		{
-			assert_type(Object);
-			return *_u.object;
-		}
+		const ConfigObject& as_object() const;
 
 		/// Look up a value in an Object. Returns a BadLookupType Config if the key does not exist.
 		const Config& operator[](const std::string& key) const;
@@ -625,7 +1031,7 @@ namespace configuru
 		size_t count(const std::string& key) const { return has_key(key) ? 1 : 0; }
 
 		/// Returns true iff the value was inserted, false if they key was already there.
-		bool emplace(std::string key, Config value);
+		bool emplace(Key key, Config value);
 
 		/// Like `foo[key] = value`, but faster.
 		void insert_or_assign(const std::string& key, Config&& value);
@@ -670,6 +1076,10 @@ namespace configuru
 		Config deep_clone() const;
 #endif
 
+		/// An immutable copy of this value, laid out for fast reads. See FrozenConfig.
+		/// Does not mark anything as accessed.
+		FrozenConfig freeze() const;
+
 		// ----------------------------------------
 
 		/// Visit dangling (unaccessed) object keys recursively.
@@ -686,32 +1096,22 @@ namespace configuru
 		/// Was there any comments about this value in the input?
 		bool has_comments() const
 		{
-			return _comments && !_comments->empty();
+			return (_flags & HasComments) && !comments().empty();
 		}
 
 		/// Read/write of comments.
-		ConfigComments& comments()
-		{
-			if (!_comments) {
-				_comments.reset(new ConfigComments());
-			}
-			return *_comments;
-		}
+		ConfigComments& comments();
 
 		/// Read comments.
-		const ConfigComments& comments() const
-		{
-			static const ConfigComments s_empty {};
-			if (_comments) {
-				return *_comments;
-			} else {
-				return s_empty;
-			}
-		}
+		const ConfigComments& comments() const;
 
 		/// Returns either "true", "false", the constained string, or the type name.
 		const char* debug_descr() const;
 
+		/// Where the memory of this array, object or longer string comes from (see MemoryResource).
+		/// Copies of it, and deep_clone, use the same resource (see MemoryResource::resource_for_copies). nullptr means the heap.
+		MemoryResource* memory_resource() const;
+
 		/// Human-readable version of the type ("integer", "bool", etc).
 		static const char* type_str(Type t);
 
@@ -732,22 +1132,90 @@ namespace configuru
 	private:
 		void free();
 
-		using ConfigComments_UP = std::unique_ptr<ConfigComments>;
+		// Parses the contents of a lazy array/object. May throw ParseError.
+		// Arrays/objects inside of it stay lazy, unless recursive is set.
+		void parse_lazy(bool recursive = false) const;
 
+		// Like parse_lazy, but returns false (and leaves the array/object lazy) on a syntax error.
+		// #includes already in info are not parsed again.
+		bool try_parse_lazy(bool recursive, ParseInfo& info, ParseFailure& out_failure) const;
+
+		#if CONFIGURU_LOCATIONS
+			friend class DocTagger;
+
+			// The document our comments are stored with (see CommentStore).
+			uint32_t comment_doc() const { return _doc_id; }
+
+			// Where we keep the index of our CommentEntry while we have one.
+			Index& comment_index() { return _line; }
+			Index comment_index() const { return _line; }
+
+			// Tags us with doc_id, which the caller has pinned for us (see DocTable).
+			void set_location(uint16_t doc_id, Index line);
+
+			// Swaps _doc_id and line() with o.
+			void swap_location(Config& o) noexcept;
+		#else
+			uint32_t comment_doc() const { return 0; }
+			Index& comment_index() { return _comment_index; }
+			Index comment_index() const { return _comment_index; }
+		#endif
+
+		// Our entry in the CommentStore of our document. Only while HasComments.
+		CommentEntry& comment_entry() const;
+
+		// Gives us a CommentEntry, unless we have one.
+		CommentEntry& add_comment_entry();
+
+		// Frees our CommentEntry, if we have one, and returns its comments.
+		ConfigComments take_comments();
+
+		// Swaps our comments with those of o.
+		void swap_comments(Config& o) noexcept;
+
+		// Swaps our location and comments with those of o, which are stored together.
+		void swap_extras(Config& o) noexcept;
+
+		// Swaps _type and _u with o.
+		void swap_value(Config& o) noexcept;
+
+		// Makes us a String. We must not hold a value already.
+		void set_string(const char* str, size_t size);
+
+		// Frees a String that is not in _u.small.
+		void free_long_string();
+
+		const char* string_data() const { return (_flags & SmallString) ? _u.small : _u.str; }
+		size_t string_length() const;
+
+		// Bits of _flags:
+		enum Flags : uint8_t
+		{
+			HasComments = 1, ///< We have a CommentEntry (see comment_index).
+			SmallString = 2, ///< The String is in _u.small.
+			InResource  = 4, ///< The String is from a MemoryResource, whose address is in front of the length.
+		};
+
+		// 16 bytes in all. Comments are rare, so they are kept with our document (see CommentStore).
 		union {
 			bool               b;
 			int64_t            i;
 			double             f;
-			const std::string* str;
+			char               small[8];   // Strings shorter than 8. small[7] is 7 minus the length, so also the final zero.
+			char*              str;        // Longer strings. The length is in the size_t just before (see InResource).
 			ConfigObject*      object;
 			ConfigArray*       array;
 			BadLookupInfo*     bad_lookup;
 		} _u;
 
-		DocInfo_SP        _doc; // So we can name the file
-		ConfigComments_UP _comments;
-		Index             _line = BAD_INDEX; // Where in the source, or BAD_INDEX. Lines are 1-indexed.
+		#if CONFIGURU_LOCATIONS
+			Index         _line = BAD_INDEX; // Where in the source, or BAD_INDEX. Lines are 1-indexed. See HasComments.
+			uint16_t      _doc_id = 0;       // So we can name the file. Pinned in DocTable.
+		#else
+			Index         _comment_index = 0; // See HasComments
+		#endif
 		Type              _type = Uninitialized;
+		uint8_t           _flags = 0; // See Flags
 	};
 
 	// ------------------------------------------------------------------------
@@ -758,6 +1226,13 @@ namespace configuru
 			std::atomic<unsigned> _ref_count { 1 };
 		#endif
 		ConfigObjectImpl      _impl;
+		LazyRange_SP          _lazy;                  ///< Set until _impl has been parsed.
+		std::atomic<bool>     _is_lazy { false };     ///< _lazy is set. Read without a lock, see parse_lazy.
+		bool                  _lazy_accessed = false; ///< mark_accessed before _impl was parsed.
+		MemoryResource*       _resource;              ///< We were allocated from this, as is _impl (nullptr: the heap).
+
+		explicit ConfigObject(MemoryResource* resource) : _impl(ConfigObjectImpl::allocator_type(resource)), _resource(resource) {}
+		ConfigObject(const ConfigObject& o, MemoryResource* resource);
 
 		class iterator
 		{
@@ -783,7 +1258,7 @@ namespace configuru
 				return a._it != b._it;
 			}
 
-			const std::string& key()   const { return _it->first;         }
+			const std::string& key()   const { return _it->first.str();   }
 			Config&            value() const { return _it->second._value; }
 
 		private:
@@ -814,7 +1289,7 @@ namespace configuru
 				return a._it != b._it;
 			}
 
-			const std::string& key()   const { return _it->first;         }
+			const std::string& key()   const { return _it->first.str();   }
 			const Config&      value() const { return _it->second._value; }
 
 		private:
@@ -829,6 +1304,20 @@ namespace configuru
 		const_iterator cend()   const { return const_iterator{_impl.cend()};   }
 	};
 
+	inline Config::ConfigObject& Config::as_object()
+	{
+		assert_type(Object);
+		if (_u.object->_is_lazy.load(std::memory_order_acquire)) { parse_lazy(); }
+		return *_u.object;
+	}
+
+	inline const Config::ConfigObject& Config::as_object() const
+	{
+		assert_type(Object);
+		if (_u.object->_is_lazy.load(std::memory_order_acquire)) { parse_lazy(); }
+		return *_u.object;
+	}
+
 	// ------------------------------------------------------------------------
 
 	inline bool operator==(const Config& a, const Config& b)
@@ -856,8 +1345,11 @@ namespace configuru
 	template<> inline unsigned long long             Config::get() const { return as_integer<unsigned long long>(); }
 	template<> inline float                          Config::get() const { return as_float();  }
 	template<> inline double                         Config::get() const { return as_double(); }
-	template<> inline const std::string&             Config::get() const { return as_string(); }
 	template<> inline std::string                    Config::get() const { return as_string(); }
+	template<> inline const char*                    Config::get() const { return c_str();     }
+#if __cplusplus >= 201703L
+	template<> inline std::string_view               Config::get() const { return as_string_view(); }
+#endif
 	template<> inline const Config::ConfigArrayImpl& Config::get() const { return as_array();  }
 	// template<> inline std::vector<std::string>     Config::get() const { return as_vector<T>();   }
 
@@ -873,7 +1365,7 @@ namespace configuru
 	T Config::get_or(const std::string& key, const T& default_value) const
 	{
 		auto&& object = as_object()._impl;
-		auto it = object.find(key);
+		auto it = object.find(Key::lookup(key));
 		if (it == object.end()) {
 			return default_value;
 		} else {
@@ -951,75 +1443,509 @@ namespace configuru
 
 	// ----------------------------------------------------------
 
-	/// Thrown on a syntax error.
-	class ParseError : public std::exception
+	/// Used by FrozenValue - no need to use directly.
+	/// 16 bytes, like a Config.
+	struct FrozenNode
 	{
-	public:
-		ParseError(const DocInfo_SP& doc, Index line, Index column, const std::string& msg)
-			: _line(line), _column(column)
-		{
-			_what = doc->filename + ":" + std::to_string(line) + ":" + std::to_string(column);
-			doc->append_include_info(_what);
-			_what += ": " + msg;
-		}
-
-		/// Will name the file name, line number, column and description.
-		const char* what() const noexcept override
-		{
-			return _what.c_str();
-		}
+		union {
+			bool    b;
+			int64_t i;
+			double  f;
+			struct {
+				uint32_t offset; // String: into FrozenBlock::chars. Array: index of the first value. Object: of the first FrozenEntry.
+				uint32_t size;
+			} ref;
+		} u;
+		#if CONFIGURU_LOCATIONS
+			Index    line;
+			uint16_t doc_id;
+		#endif
+		Config::Type type;
+	};
 
-		Index line()   const noexcept { return _line; }
-		Index column() const noexcept { return _column; }
+	/// Used by FrozenValue - no need to use directly.
+	/// A key of an object. The entries of an object are sorted by key.
+	struct FrozenEntry
+	{
+		uint32_t hash;     // See FrozenValue::key_hash.
+		uint32_t key;      // Into FrozenBlock::chars.
+		uint32_t key_size;
+		uint32_t value;    // Index of the FrozenNode.
+	};
 
-	private:
-		Index _line, _column;
-		std::string _what;
+	/// Used by FrozenValue - no need to use directly.
+	struct FrozenBlock
+	{
+		std::unique_ptr<uint64_t[]> memory;  // The nodes, then the entries, then the slots, then the zero-ended strings.
+		const FrozenNode*           nodes   = nullptr;
+		const FrozenEntry*          entries = nullptr;
+		const uint32_t*             slots   = nullptr; // The hash index of the object whose entries start at i is at 2*i, with 2 slots per entry.
+		const char*                 chars   = nullptr;
+		std::vector<uint16_t>       doc_ids; // Pinned in DocTable, so that where() can still name them.
+
+		FrozenBlock() = default;
+		FrozenBlock(const FrozenBlock&) = delete;
+		FrozenBlock& operator=(const FrozenBlock&) = delete;
+		~FrozenBlock();
 	};
 
-	// ----------------------------------------------------------
+	class FrozenArray;
+	class FrozenObject;
 
-	/// This struct basically contain all the way we can tweak the file format.
-	struct FormatOptions
+	/// A value in a FrozenConfig, with the read API of Config.
+	/// It only points into the FrozenConfig, so it is cheap to copy, but must not outlive it.
+	/// Looking up a missing key is an error right away (use has_key or get_or to check first).
+	class FrozenValue
 	{
-		/// Indentation should be a single tab,
-		/// multiple spaces or an empty string.
-		/// An empty string means the output will be compact.
-		std::string indentation              = "\t";
-		bool        enforce_indentation      = true;  ///< Must have correct indentation?
-		bool        end_with_newline         = true;  ///< End each file with a newline (unless compact).
+	public:
+		/// An uninitialized value.
+		FrozenValue() : _block(nullptr), _node(&uninitialized_node()) {}
 
-		// Top file:
-		bool        empty_file               = false; ///< If true, an empty file is an empty object.
-		bool        implicit_top_object      = true;  ///< Ok with key-value pairs top-level?
-		bool        implicit_top_array       = true;  ///< Ok with several values top-level?
+		Config::Type type() const { return _node->type; }
 
-		// Comments:
-		bool        single_line_comments     = true;  ///< Allow this?
-		bool        block_comments           = true;  /* Allow this? */
-		bool        nesting_block_comments   = true;  ///< /* Allow /*    this? */ */
+		bool is_uninitialized() const { return type() == Config::Uninitialized; }
+		bool is_null()          const { return type() == Config::Null;          }
+		bool is_bool()          const { return type() == Config::Bool;          }
+		bool is_int()           const { return type() == Config::Int;           }
+		bool is_float()         const { return type() == Config::Float;         }
+		bool is_string()        const { return type() == Config::String;        }
+		bool is_object()        const { return type() == Config::Object;        }
+		bool is_array()         const { return type() == Config::Array;         }
+		bool is_number()        const { return is_int() || is_float();          }
 
-		// Numbers:
-		bool        inf                      = true;  ///< Allow +inf, -inf
-		bool        nan                      = true;  ///< Allow +NaN
-		bool        hexadecimal_integers     = true;  ///< Allow 0xff
-		bool        binary_integers          = true;  ///< Allow 0b1010
-		bool        unary_plus               = true;  ///< Allow +42
-		bool        distinct_floats          = true;  ///< Print 9.0 as "9.0", not just "9". A must for round-tripping.
+		/// Returns file:line iff available.
+		std::string where() const;
 
-		// Arrays
-		bool        array_omit_comma         = true;  ///< Allow [1 2 3]
-		bool        array_trailing_comma     = true;  ///< Allow [1, 2, 3,]
+		#if CONFIGURU_LOCATIONS
+			Index line() const { return _node->line; }
+		#else
+			Index line() const { return BAD_INDEX; }
+		#endif
 
-		// Objects:
-		bool        identifiers_keys         = true;  ///< { is_this_ok: true }
-		bool        object_separator_equal   = false; ///< { "is_this_ok" = true }
-		bool        allow_space_before_colon = false; ///< { "is_this_ok" : true }
-		bool        omit_colon_before_object = false; ///< { "nested_object" { } }
-		bool        object_omit_comma        = true;  ///< Allow {a:1 b:2}
-		bool        object_trailing_comma    = true;  ///< Allow {a:1, b:2,}
-		bool        object_duplicate_keys    = false; ///< Allow {"a":1, "a":2}
-		bool        object_align_values      = true;  ///< Add spaces after keys to align subsequent values.
+		// ----------------------------------------
+
+		/// Explicit casting, for the types get<T>() knows.
+		template<typename T>
+		explicit operator T() const { return get<T>(); }
+
+		/// The string stays put for as long as the FrozenConfig does.
+		const char* c_str() const { assert_type(Config::String); return _block->chars + _node->u.ref.offset; }
+		size_t string_size() const { assert_type(Config::String); return _node->u.ref.size; }
+		std::string as_string() const { assert_type(Config::String); return std::string(c_str(), string_size()); }
+		#if __cplusplus >= 201703L
+			std::string_view as_string_view() const { return {c_str(), string_size()}; }
+		#endif
+
+		bool as_bool() const
+		{
+			assert_type(Config::Bool);
+			return _node->u.b;
+		}
+
+		template<typename IntT>
+		IntT as_integer() const
+		{
+			static_assert(std::is_integral<IntT>::value, "Not an integer.");
+			assert_type(Config::Int);
+			check(static_cast<int64_t>(static_cast<IntT>(_node->u.i)) == _node->u.i, "Integer out of range");
+			return static_cast<IntT>(_node->u.i);
+		}
+
+		float as_float() const { return static_cast<float>(as_double()); }
+
+		double as_double() const
+		{
+			if (type() == Config::Int) {
+				return static_cast<double>(_node->u.i);
+			} else {
+				assert_type(Config::Float);
+				return _node->u.f;
+			}
+		}
+
+		/// Extract the value.
+		template<typename T>
+		T get() const;
+
+		// ----------------------------------------
+		// Array:
+
+		size_t array_size() const { assert_type(Config::Array); return _node->u.ref.size; }
+
+		/// For iterating over an array: `for (FrozenValue e : frozen.as_array()) { ... }`
+		FrozenArray as_array() const;
+
+		FrozenValue operator[](size_t ix) const
+		{
+			check(ix < array_size(), "Array index out of range");
+			return FrozenValue(_block, _block->nodes + _node->u.ref.offset + ix);
+		}
+
+		// ----------------------------------------
+		// Object:
+
+		size_t object_size() const { assert_type(Config::Object); return _node->u.ref.size; }
+
+		/// For iterating over an object, in the order of the keys:
+		/// `for (const auto& p : frozen.as_object()) { cout << p.key() << ": " << p.value().where(); }`
+		FrozenObject as_object() const;
+
+		FrozenValue operator[](const std::string& key) const { return at(key.data(), key.size()); }
+
+		/// The key ends at the first zero, so this takes a char buffer as well as a literal, without a strlen for the latter.
+		template<std::size_t N>
+		FrozenValue operator[](const char (&key)[N]) const { return at(key, static_cast<size_t>(std::find(key, key + N, '\0') - key)); }
+
+		bool has_key(const std::string& key) const { return find(key.data(), key.size()) != nullptr; }
+
+		size_t count(const std::string& key) const { return has_key(key) ? 1 : 0; }
+
+		template<typename T>
+		T get(const std::string& key) const { return (*this)[key].get<T>(); }
+
+		/// Look for the given key in this object, and return default_value on failure.
+		template<typename T>
+		T get_or(const std::string& key, const T& default_value) const
+		{
+			const FrozenNode* node = find(key.data(), key.size());
+			return node ? FrozenValue(_block, node).get<T>() : default_value;
+		}
+
+		std::string get_or(const std::string& key, const char* default_value) const
+		{
+			return get_or<std::string>(key, default_value);
+		}
+
+		/// frozen.get_or({"a", "b". "c"}, 42) - like frozen["a"]["b"]["c"], but returns 42 if any of the keys are *missing*.
+		template<typename T>
+		T get_or(std::initializer_list<std::string> keys, const T& default_value) const
+		{
+			FrozenValue value = *this;
+			for (const auto& key : keys) {
+				const FrozenNode* node = value.find(key.data(), key.size());
+				if (!node) { return default_value; }
+				value._node = node;
+			}
+			return value.get<T>();
+		}
+
+		std::string get_or(std::initializer_list<std::string> keys, const char* default_value) const
+		{
+			return get_or<std::string>(keys, default_value);
+		}
+
+		// ----------------------------------------
+
+		/// A mutable copy, e.g. for writing it with dump_string.
+		Config to_config() const;
+
+		inline void check(bool b, const char* msg) const
+		{
+			if (!b) {
+				on_error(msg);
+			}
+		}
+
+		void assert_type(Config::Type t) const
+		{
+			if (type() != t) {
+				on_error(std::string("Expected ") + Config::type_str(t) + ", got " + Config::type_str(type()));
+			}
+		}
+
+		void on_error(const std::string& msg) const CONFIGURU_NORETURN;
+
+	protected:
+		friend class Config;
+		friend class FrozenArray;
+		friend class FrozenObject;
+
+		FrozenValue(const FrozenBlock* block, const FrozenNode* node) : _block(block), _node(node) {}
+
+		static const FrozenNode& uninitialized_node()
+		{
+			static const FrozenNode s_node = []{
+				FrozenNode node = FrozenNode();
+				#if CONFIGURU_LOCATIONS
+					node.line = BAD_INDEX;
+				#endif
+				return node;
+			}();
+			return s_node;
+		}
+
+		// Reads eight bytes at a time, without making a std::string of the key.
+		static uint32_t key_hash(const char* key, size_t size)
+		{
+			uint64_t h = 0x9E3779B97F4A7C15ull ^ size;
+			for (; size >= 8; key += 8, size -= 8) {
+				uint64_t word;
+				memcpy(&word, key, 8);
+				h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+				h ^= h >> 32;
+			}
+			uint64_t word = 0; // The last 0-7 bytes, without a variable-sized memcpy
+			if (size >= 4) {
+				uint32_t first, last; // May overlap
+				memcpy(&first, key, 4);
+				memcpy(&last, key + size - 4, 4);
+				word = (static_cast<uint64_t>(first) << 32) | last;
+			} else if (size > 0) {
+				word = (static_cast<uint64_t>(static_cast<uint8_t>(key[0])) << 16)
+				     | (static_cast<uint64_t>(static_cast<uint8_t>(key[size / 2])) << 8)
+				     | static_cast<uint8_t>(key[size - 1]);
+			}
+			h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+			h ^= h >> 29;
+			h *= 0xC4CEB9FE1A85EC53ull;
+			return static_cast<uint32_t>(h >> 32);
+		}
+
+		// Where to start looking in a hash index of num_slots.
+		static uint32_t first_slot(uint32_t hash, uint32_t num_slots)
+		{
+			return static_cast<uint32_t>((static_cast<uint64_t>(hash) * num_slots) >> 32);
+		}
+
+		// nullptr if there is no such key. We must be an object.
+		const FrozenNode* find(const char* key, size_t size) const
+		{
+			assert_type(Config::Object);
+			const uint32_t num_slots = 2 * _node->u.ref.size;
+			if (num_slots == 0) { return nullptr; }
+			const FrozenEntry* entries = _block->entries + _node->u.ref.offset;
+			const uint32_t*    slots   = _block->slots + 2 * static_cast<size_t>(_node->u.ref.offset);
+			const uint32_t     hash    = key_hash(key, size);
+			for (uint32_t s = first_slot(hash, num_slots); slots[s] != 0; s = s + 1 == num_slots ? 0 : s + 1) {
+				const FrozenEntry& entry = entries[slots[s] - 1];
+				if (entry.hash == hash && entry.key_size == size && memcmp(_block->chars + entry.key, key, size) == 0) {
+					return _block->nodes + entry.value;
+				}
+			}
+			return nullptr;
+		}
+
+		FrozenValue at(const char* key, size_t size) const
+		{
+			const FrozenNode* node = find(key, size);
+			if (!node) { on_error("Failed to find key '" + std::string(key, size) + "'"); }
+			return FrozenValue(_block, node);
+		}
+
+		const FrozenBlock* _block;
+		const FrozenNode*  _node;
+	};
+
+	template<> inline bool               FrozenValue::get() const { return as_bool();   }
+	template<> inline signed char        FrozenValue::get() const { return as_integer<signed char>();        }
+	template<> inline unsigned char      FrozenValue::get() const { return as_integer<unsigned char>();      }
+	template<> inline signed short       FrozenValue::get() const { return as_integer<signed short>();       }
+	template<> inline unsigned short     FrozenValue::get() const { return as_integer<unsigned short>();     }
+	template<> inline signed int         FrozenValue::get() const { return as_integer<signed int>();         }
+	template<> inline unsigned int       FrozenValue::get() const { return as_integer<unsigned int>();       }
+	template<> inline signed long        FrozenValue::get() const { return as_integer<signed long>();        }
+	template<> inline unsigned long      FrozenValue::get() const { return as_integer<unsigned long>();      }
+	template<> inline signed long long   FrozenValue::get() const { return as_integer<signed long long>();   }
+	template<> inline unsigned long long FrozenValue::get() const { return as_integer<unsigned long long>(); }
+	template<> inline float              FrozenValue::get() const { return as_float();  }
+	template<> inline double             FrozenValue::get() const { return as_double(); }
+	template<> inline std::string        FrozenValue::get() const { return as_string(); }
+	template<> inline const char*        FrozenValue::get() const { return c_str();     }
+#if __cplusplus >= 201703L
+	template<> inline std::string_view   FrozenValue::get() const { return as_string_view(); }
+#endif
+
+	/// The values of a frozen array, which are next to each other in memory.
+	class FrozenArray
+	{
+	public:
+		class iterator
+		{
+		public:
+			iterator(const FrozenBlock* block, const FrozenNode* node) : _block(block), _node(node) {}
+
+			FrozenValue operator*() const { return FrozenValue(_block, _node); }
+
+			iterator& operator++() {
+				++_node;
+				return *this;
+			}
+
+			friend bool operator==(const iterator& a, const iterator& b) { return a._node == b._node; }
+			friend bool operator!=(const iterator& a, const iterator& b) { return a._node != b._node; }
+
+		private:
+			const FrozenBlock* _block;
+			const FrozenNode*  _node;
+		};
+
+		FrozenArray(const FrozenBlock* block, const FrozenNode* first, size_t size) : _block(block), _first(first), _size(size) {}
+
+		size_t      size()                  const { return _size; }
+		bool        empty()                 const { return _size == 0; }
+		FrozenValue operator[](size_t ix)   const { return FrozenValue(_block, _first + ix); }
+		iterator    begin()                 const { return iterator(_block, _first); }
+		iterator    end()                   const { return iterator(_block, _first + _size); }
+
+	private:
+		const FrozenBlock* _block;
+		const FrozenNode*  _first;
+		size_t             _size;
+	};
+
+	/// The keys and values of a frozen object, ordered by key.
+	class FrozenObject
+	{
+	public:
+		class iterator
+		{
+		public:
+			iterator(const FrozenBlock* block, const FrozenEntry* entry) : _block(block), _entry(entry) {}
+
+			const iterator& operator*() const { return *this; }
+
+			iterator& operator++() {
+				++_entry;
+				return *this;
+			}
+
+			friend bool operator==(const iterator& a, const iterator& b) { return a._entry == b._entry; }
+			friend bool operator!=(const iterator& a, const iterator& b) { return a._entry != b._entry; }
+
+			std::string key()       const { return std::string(key_c_str(), _entry->key_size); }
+			const char* key_c_str() const { return _block->chars + _entry->key; }
+			FrozenValue value()     const { return FrozenValue(_block, _block->nodes + _entry->value); }
+
+		private:
+			const FrozenBlock* _block;
+			const FrozenEntry* _entry;
+		};
+
+		FrozenObject(const FrozenBlock* block, const FrozenEntry* first, size_t size) : _block(block), _first(first), _size(size) {}
+
+		size_t   size()  const { return _size; }
+		bool     empty() const { return _size == 0; }
+		iterator begin() const { return iterator(_block, _first); }
+		iterator end()   const { return iterator(_block, _first + _size); }
+
+	private:
+		const FrozenBlock* _block;
+		const FrozenEntry* _first;
+		size_t             _size;
+	};
+
+	inline FrozenArray FrozenValue::as_array() const
+	{
+		assert_type(Config::Array);
+		return FrozenArray(_block, _block->nodes + _node->u.ref.offset, _node->u.ref.size);
+	}
+
+	inline FrozenObject FrozenValue::as_object() const
+	{
+		assert_type(Config::Object);
+		return FrozenObject(_block, _block->entries + _node->u.ref.offset, _node->u.ref.size);
+	}
+
+	/// An immutable copy of a Config, made with Config::freeze(), for a config that is only read once loaded.
+	/// All of it is in one block of memory: the values breadth-first, so that those of an array or object
+	/// are next to each other, then the sorted keys of each object with a hash index for lookups, then each distinct string once.
+	/// Reading it writes nothing (no accessed flags, no reference counts), so any number of threads can read it at once.
+	/// Copying a FrozenConfig shares the block. The FrozenValues found in it are valid while some copy of it is around.
+	class FrozenConfig : public FrozenValue
+	{
+	public:
+		/// An uninitialized value.
+		FrozenConfig() = default;
+
+		/// The top value.
+		const FrozenValue& root() const { return *this; }
+
+	private:
+		friend class Config;
+
+		explicit FrozenConfig(std::shared_ptr<const FrozenBlock> block)
+			: FrozenValue(block.get(), block->nodes), _owner(std::move(block)) {}
+
+		std::shared_ptr<const FrozenBlock> _owner;
+	};
+
+	// ----------------------------------------------------------
+
+	/// Thrown on a syntax error.
+	class ParseError : public std::exception
+	{
+	public:
+		ParseError(const DocInfo_SP& doc, Index line, Index column, const std::string& msg)
+			: _line(line), _column(column)
+		{
+			_what = doc->filename + ":" + std::to_string(line) + ":" + std::to_string(column);
+			doc->append_include_info(_what);
+			_what += ": " + msg;
+		}
+
+		/// Will name the file name, line number, column and description.
+		const char* what() const noexcept override
+		{
+			return _what.c_str();
+		}
+
+		Index line()   const noexcept { return _line; }
+		Index column() const noexcept { return _column; }
+
+	private:
+		Index _line, _column;
+		std::string _what;
+	};
+
+	// ----------------------------------------------------------
+
+	/// This struct basically contain all the way we can tweak the file format.
+	struct FormatOptions
+	{
+		/// Indentation should be a single tab,
+		/// multiple spaces or an empty string.
+		/// An empty string means the output will be compact.
+		std::string indentation              = "\t";
+		bool        enforce_indentation      = true;  ///< Must have correct indentation?
+		bool        end_with_newline         = true;  ///< End each file with a newline (unless compact).
+
+		// Top file:
+		bool        empty_file               = false; ///< If true, an empty file is an empty object.
+		bool        implicit_top_object      = true;  ///< Ok with key-value pairs top-level?
+		bool        implicit_top_array       = true;  ///< Ok with several values top-level?
+
+		/// Most arrays/objects inside of each other (a top-level object without braces counts too).
+		/// Deeper is a syntax error. The parser does not recurse, but writing, comparing and
+		/// deep_clone:ing a Config does, so this keeps a hostile document from overflowing the stack later. 0 means no limit.
+		unsigned    max_depth                = 1024;
+
+		// Comments:
+		bool        single_line_comments     = true;  ///< Allow this?
+		bool        block_comments           = true;  /* Allow this? */
+		bool        nesting_block_comments   = true;  ///< /* Allow /*    this? */ */
+		bool        keep_comments            = true;  ///< Store comments in the Config. Off is faster if you never write them back.
+
+		// Numbers:
+		bool        inf                      = true;  ///< Allow +inf, -inf
+		bool        nan                      = true;  ///< Allow +NaN
+		bool        hexadecimal_integers     = true;  ///< Allow 0xff
+		bool        binary_integers          = true;  ///< Allow 0b1010
+		bool        unary_plus               = true;  ///< Allow +42
+		bool        distinct_floats          = true;  ///< Print 9.0 as "9.0", not just "9". A must for round-tripping.
+
+		// Arrays
+		bool        array_omit_comma         = true;  ///< Allow [1 2 3]
+		bool        array_trailing_comma     = true;  ///< Allow [1, 2, 3,]
+
+		// Objects:
+		bool        identifiers_keys         = true;  ///< { is_this_ok: true }
+		bool        object_separator_equal   = false; ///< { "is_this_ok" = true }
+		bool        allow_space_before_colon = false; ///< { "is_this_ok" : true }
+		bool        omit_colon_before_object = false; ///< { "nested_object" { } }
+		bool        object_omit_comma        = true;  ///< Allow {a:1 b:2}
+		bool        object_trailing_comma    = true;  ///< Allow {a:1, b:2,}
+		bool        object_duplicate_keys    = false; ///< Allow {"a":1, "a":2}
+		bool        object_align_values      = true;  ///< Add spaces after keys to align subsequent values.
 
 		// Strings
 		bool        str_csharp_verbatim      = true;  ///< Allow @"Verbatim\strings"
@@ -1030,6 +1956,25 @@ namespace configuru
 		// Special
 		bool        allow_macro              = true;  ///< Allow `#include "some_other_file.cfg"`
 
+		/// parse_file reads the #include:d files (and the files they include, and so on) on this many threads
+		/// before it starts parsing, instead of reading each one when the parser gets to it.
+		/// Worth it for configs spread over many files. 0 turns it off.
+		unsigned    include_threads          = 0;
+
+		/// Where the memory of the parsed document comes from (see MemoryResource). nullptr is the heap.
+		MemoryResource* memory_resource      = nullptr;
+
+		/// Allocate the arrays, objects and longer strings of the parsed document from big chunks of memory
+		/// (taken from memory_resource), which are all freed at once when the last value using them is gone.
+		/// Parsing and destroying a big document is faster. Destroying it still visits every value (to release
+		/// its key and its pin of the document), but hands the blocks back to the arena in one go rather than
+		/// one by one under a lock. The document can still be changed afterwards,
+		/// and what is freed is reused for its arrays and objects as they grow. Copies of its values come from
+		/// memory_resource instead, so they do not keep the chunks alive. A value moved out of the document does,
+		/// as does an array or object shared with it (without CONFIGURU_VALUE_SEMANTICS).
+		bool        arena                    = false;
+		bool        arena_huge_pages         = false; ///< With arena, ask Linux to back the chunks with huge pages.
+
 		// When writing:
 		bool        write_comments           = true;
 
@@ -1165,30 +2110,253 @@ namespace configuru
 	/// A very forgiving file format, when parsing stuff that is not strict.
 	static const FormatOptions FORGIVING = make_forgiving_options();
 
+	class FileContents;
+	class IncludeCache;
+
 	struct ParseInfo
 	{
-		std::map<std::string, Config> parsed_files; // Two #include gives same Config tree.
+		std::map<std::string, Config> parsed_files;  // Two #include gives same Config tree.
+		std::map<std::string, std::shared_ptr<const FileContents>> preloaded_files; // See FormatOptions::include_threads
+		IncludeCache*                 include_cache = nullptr; // If set, #includes are looked up here first.
+		std::string                   key_scratch;   // Reused when decoding keys.
+		std::string                   value_scratch; // Reused when decoding string values.
+	};
+
+	/// Receives the contents of a document as the parser finds them, without a Config tree being built.
+	/// Override the events you are interested in; the rest are ignored.
+	/// The strings passed are only valid during the call.
+	/// `line` is where the value starts (1-indexed).
+	///
+	/// Keys and values come in document order, e.g. `{ "a": [1, true] }` gives
+	/// begin_object, key("a"), begin_array, int_value(1), bool_value(true), end_array, end_object.
+	/// The top level of a document is a sequence of values, normally just one.
+	/// A CFG file without braces at the top is reported as an object.
+	/// An empty document (see FormatOptions::empty_file) is reported as nothing at all.
+	class ParseHandler
+	{
+	public:
+		/// Which part of ConfigComments a comment belongs to.
+		enum CommentKind
+		{
+			Prefix,      ///< Before the next key or value.
+			Postfix,     ///< After the previous value, on the same line.
+			PreEndBrace, ///< Before the end of the innermost array/object.
+		};
+
+		virtual ~ParseHandler() {}
+
+		virtual void null_value(Index /*line*/) {}
+		virtual void bool_value(Index /*line*/, bool /*value*/) {}
+		virtual void int_value(Index /*line*/, int64_t /*value*/) {}
+		virtual void float_value(Index /*line*/, double /*value*/) {}
+		virtual void string_value(Index /*line*/, const std::string& /*value*/) {}
+
+		/// A value that is already a Config: an #include, or an unparsed array/object when parsing lazily.
+		/// Each #include:d file is only parsed once (per ParseInfo) and then shared.
+		virtual void config_value(Index /*line*/, Config&& /*value*/) {}
+
+		virtual void begin_object(Index /*line*/) {}
+		virtual void key(const std::string& /*key*/) {}
+		virtual void end_object() {}
+
+		virtual void begin_array(Index /*line*/) {}
+		virtual void end_array() {}
+
+		/// A // or /* */ comment, with the slashes and stars. Not reported unless FormatOptions::keep_comments.
+		virtual void comment(CommentKind /*kind*/, const std::string& /*comment*/) {}
+
+		/// Called before key() unless FormatOptions::object_duplicate_keys is set.
+		/// Return true if the innermost object already has this key, and set out_where to where it was set.
+		/// The default does not keep track of keys, and so accepts duplicates.
+		virtual bool is_duplicate_key(const std::string& /*key*/, std::string& /*out_where*/) { return false; }
 	};
 
-	/// The parser may throw ParseError.
+	/// The parser may throw ParseError. An #include:d file that cannot be read is a ParseError at the #include.
 	/// `str` should be a zero-ended Utf-8 encoded string of characters.
 	/// The `name` should be something akin to a filename. It is only for error reporting.
 	Config parse_string(const char* str, const FormatOptions& options, const char* name);
 	Config parse_file(const std::string& path, const FormatOptions& options);
 
-	/// Advanced usage:
-	Config parse_string(const char* str, const FormatOptions& options, DocInfo _doc, ParseInfo& info);
-	Config parse_file(const std::string& path, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info);
+	/// Like above, but `str` does not need to be zero-ended: the parser never reads outside of [str, str + length).
+	/// A zero byte inside of the range is an error.
+	Config parse_string(const char* str, size_t length, const FormatOptions& options, const char* name);
 
-	// ----------------------------------------------------------
-	/// Writes the config as a string in the given format.
-	/// May call CONFIGURU_ONERROR if the given config is invalid. This can happen if
-	/// a Config is unitialized (and options write_uninitialized is not set) or
-	/// a Config contains inf/nan (and options.inf/options.nan aren't set).
-	std::string dump_string(const Config& config, const FormatOptions& options);
+#if __cplusplus >= 201703L
+	inline Config parse_string(std::string_view str, const FormatOptions& options, const char* name)
+	{
+		return parse_string(str.data(), str.size(), options, name);
+	}
+#endif
 
-	/// Writes the config to a file. Like dump_string, but can may also call CONFIGURU_ONERROR
-	/// if it fails to write to the given path.
+	/// What parse_string_noexcept/parse_file_noexcept found: the document, or where the first syntax error is.
+	struct ParseResult
+	{
+		Config      config;     ///< The document. Uninitialized if there was an error.
+		bool        ok = false; ///< True if there were no errors.
+		std::string filename;   ///< The file with the error. This is an #include:d file if the error is in one.
+		Index       line   = 0; ///< 1-indexed line of the error. Zero if the file itself could not be read.
+		Index       column = 0; ///< 1-indexed column of the error. Zero if the file itself could not be read.
+		std::string message;    ///< Same as ParseError::what(): file, line, column, description and the line in question.
+
+		explicit operator bool() const { return ok; }
+	};
+
+	/// Like parse_string/parse_file, but errors are returned instead of thrown.
+	/// A syntax error is much cheaper this way, and these work without exceptions (see CONFIGURU_EXCEPTIONS).
+	/// Errors from a file that cannot be read (including #include:d files) are returned too.
+	ParseResult parse_string_noexcept(const char* str, const FormatOptions& options, const char* name);
+	ParseResult parse_string_noexcept(const char* str, size_t length, const FormatOptions& options, const char* name);
+	ParseResult parse_file_noexcept(const std::string& path, const FormatOptions& options);
+
+#if __cplusplus >= 201703L
+	inline ParseResult parse_string_noexcept(std::string_view str, const FormatOptions& options, const char* name)
+	{
+		return parse_string_noexcept(str.data(), str.size(), options, name);
+	}
+#endif
+
+	/// Like parse_file, but arrays and objects are only parsed once you reach into them with
+	/// operator[], as_array() or as_object(). Until then they are just a range of the file,
+	/// so loading a large file you only need parts of is much cheaper.
+	/// Syntax errors inside of an array/object are only found (and thrown as ParseError) when it is parsed.
+	/// The file is kept in memory for as long as any part of the returned Config is.
+	/// Several threads may read the result at once: each array/object is parsed by the first to reach into it, while the others wait.
+	Config parse_file_lazy(const std::string& path, const FormatOptions& options);
+
+	/// Like parse_file_lazy, for a document in memory.
+	Config parse_string_lazy(std::string str, const FormatOptions& options, const char* name);
+
+	/// Like parse_file, but the arrays/objects in the top-level array/object are parsed on
+	/// `num_threads` threads (0 means std::thread::hardware_concurrency()).
+	/// A quick scan of the top level finds where each of them start and end, and they are then parsed in parallel.
+	/// Good for a large file with many records. The result (line numbers, comments, key order) is the same as parse_file.
+	/// If there are several syntax errors, the first one in the document is thrown.
+	/// Each thread has its own ParseInfo, so a file #include:d by several records is parsed once per thread.
+	Config parse_file_parallel(const std::string& path, const FormatOptions& options, unsigned num_threads = 0);
+
+	/// Like parse_file_parallel, for a document in memory.
+	Config parse_string_parallel(std::string str, const FormatOptions& options, const char* name, unsigned num_threads = 0);
+
+	/// Like parse_string/parse_file, but reports the contents to the handler instead of building a Config.
+	/// This is much cheaper if you only want to validate a document, or pick out a few values.
+	void parse_string(const char* str, size_t length, const FormatOptions& options, const char* name, ParseHandler& handler);
+	void parse_file(const std::string& path, const FormatOptions& options, ParseHandler& handler);
+
+	/// Advanced usage:
+	Config parse_string(const char* str, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info);
+	Config parse_file(const std::string& path, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info);
+	Config parse_string(const char* str, size_t length, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info);
+	void parse_string(const char* str, size_t length, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info, ParseHandler& handler);
+
+	/// For parsing many documents with the same options, e.g. lots of small JSON messages.
+	/// Keeps its buffers between calls, so it is cheaper than calling parse_string/parse_file repeatedly.
+	/// Not thread safe: use one ParseSession per thread.
+	class ParseSession
+	{
+	public:
+		explicit ParseSession(const FormatOptions& options) : _options(options) {}
+
+		/// Same as parse_string(str, options, name).
+		Config parse_string(const char* str, const char* name);
+
+		/// Same as parse_string(str, length, options, name).
+		Config parse_string(const char* str, size_t length, const char* name);
+
+		/// Same as parse_file(path, options).
+		Config parse_file(const std::string& path);
+
+		const FormatOptions& options() const { return _options; }
+
+	private:
+		FormatOptions _options;
+		ParseInfo     _info;
+		DocInfo_SP    _doc;         // Reused as long as the name stays the same.
+	};
+
+	/// Keeps #include:d files between calls to parse_file, so configs that include the same files
+	/// (or the same config, loaded again) do not parse them again.
+	/// Files are told apart by canonical path and inode, so "a/../b.cfg" and "b.cfg" are the same file.
+	/// A file is read and parsed again if its modification time or size has changed, or that of any file it includes.
+	/// Each #include of a cached file gets its own copy of it (still much cheaper than parsing), with DocInfos
+	/// of its own, so changing a result does not change the cache, and the error messages of earlier results
+	/// keep saying where they included it.
+	/// On platforms without POSIX stat/realpath nothing is cached.
+	/// Not thread safe: use one IncludeCache per thread.
+	class IncludeCache
+	{
+	public:
+		explicit IncludeCache(const FormatOptions& options);
+		~IncludeCache();
+
+		IncludeCache(const IncludeCache&) = delete;
+		IncludeCache& operator=(const IncludeCache&) = delete;
+
+		/// Same as parse_file(path, options), but unchanged #include:d files come from the cache.
+		Config parse_file(const std::string& path);
+
+		/// Number of files in the cache.
+		size_t size() const;
+
+		/// Forget all files.
+		void clear();
+
+		const FormatOptions& options() const { return _options; }
+
+	private:
+		friend struct Parser;
+		struct Impl;
+
+		// Parses (or finds in the cache) the file at `path`, #include:d from line `line` of `includer`.
+		// Returns false on a syntax error in it.
+		bool include(const std::string& path, const DocInfo_SP& includer, Index line, ParseInfo& info,
+		             Config& out, ParseFailure& out_failure);
+
+		// `path` was #include:d again in the same parse, so whatever is being parsed depends on it too.
+		void include_again(const std::string& path);
+
+		FormatOptions         _options;
+		std::unique_ptr<Impl> _impl;
+	};
+
+	/// For parsing a document that arrives in chunks, e.g. over a socket or a pipe.
+	/// Every value is parsed as soon as all of it has arrived, so most of the work is done while waiting for the rest.
+	/// The result (or ParseError) is the same as when parsing the whole document with parse_string.
+	/// Example:
+	///     configuru::IncrementalParser parser(configuru::JSON, "socket");
+	///     while (size_t n = read(fd, buffer, sizeof(buffer))) { parser.feed(buffer, n); }
+	///     configuru::Config config = parser.finish();
+	class IncrementalParser
+	{
+	public:
+		/// The `name` is only for error reporting.
+		IncrementalParser(const FormatOptions& options, const char* name);
+		~IncrementalParser();
+
+		IncrementalParser(const IncrementalParser&) = delete;
+		IncrementalParser& operator=(const IncrementalParser&) = delete;
+
+		/// Add the next chunk of the document. Syntax errors are not reported until finish().
+		/// Input is let go of once it has been parsed, so only the unfinished values are kept in memory.
+		void feed(const char* data, size_t length);
+
+		/// Call once all input has been fed. Returns the parsed document, or throws ParseError.
+		/// Calling feed or finish after this is an error (CONFIGURU_ONERROR).
+		Config finish();
+
+	private:
+		struct Impl;
+		std::unique_ptr<Impl> _impl;
+	};
+
+	// ----------------------------------------------------------
+	/// Writes the config as a string in the given format.
+	/// May call CONFIGURU_ONERROR if the given config is invalid. This can happen if
+	/// a Config is unitialized (and options write_uninitialized is not set) or
+	/// a Config contains inf/nan (and options.inf/options.nan aren't set).
+	std::string dump_string(const Config& config, const FormatOptions& options);
+
+	/// Writes the config to a file. Like dump_string, but can may also call CONFIGURU_ONERROR
+	/// if it fails to write to the given path.
 	void dump_file(const std::string& path, const Config& config, const FormatOptions& options);
 
 	// ----------------------------------------------------------
@@ -1331,7 +2499,7 @@ namespace configuru
 
 		inline void deserialize(std::string* some_string, const Config& config, const ConversionError& on_error)
 		{
-			*some_string = config.as_string();
+			some_string->assign(config.c_str(), config.string_size()); // Reuses its buffer
 		}
 
 		template<typename T>
@@ -1451,7 +2619,15 @@ This will define all the Configuru functions so that the linker may find them.
 
 #include <algorithm>
 #include <limits>
+#include <mutex>
+#include <new>
 #include <ostream>
+#include <tuple>
+#include <unordered_map>
+
+#if defined(__linux__)
+	#include <sys/mman.h> // For FormatOptions::arena_huge_pages
+#endif
 
 // ----------------------------------------------------------------------------
 namespace configuru
@@ -1469,1669 +2645,5938 @@ namespace configuru
 		}
 	}
 
-	struct BadLookupInfo
+	bool is_identifier(const char* p)
 	{
-		const DocInfo_SP      doc;      // Of parent object
-		const unsigned        line;     // Of parent object
-		const std::string     key;
+		if (*p == '_'
+			 || ('a' <= *p && *p <= 'z')
+			 || ('A' <= *p && *p <= 'Z'))
+		{
+			++p;
+			while (*p) {
+				if (*p == '_'
+					 || ('a' <= *p && *p <= 'z')
+					 || ('A' <= *p && *p <= 'Z')
+					 || ('0' <= *p && *p <= '9'))
+				{
+					++p;
+				} else {
+					return false;
+				}
+			}
+			return true;
+		} else {
+			return false;
+		}
+	}
 
-		#if !CONFIGURU_VALUE_SEMANTICS
-			std::atomic<unsigned> _ref_count { 1 };
-		#endif
+	// All interned keys. Never destroyed, since a Key in a static Config may outlive any other static.
+	struct KeyTable
+	{
+		std::mutex                               mutex;
+		std::unordered_map<std::string, KeyInfo> keys;
 
-		BadLookupInfo(DocInfo_SP doc_, Index line_, std::string key_)
-			: doc(std::move(doc_)), line(line_), key(std::move(key_)) {}
-	};
+		static KeyTable& instance()
+		{
+			static KeyTable* s_table = new KeyTable();
+			return *s_table;
+		}
 
-	Config::Config(const char* str) : _type(String)
-	{
-		CONFIGURU_ASSERT(str != nullptr);
-		_u.str = new std::string(str);
-	}
+		// Most keys are one of a few seen recently, so look among those first, without locking:
+		static Key& recent(size_t hash)
+		{
+			static thread_local Key s_recent[64];
+			return s_recent[hash % 64];
+		}
+	};
 
-	Config::Config(std::string str) : _type(String)
+	Key::Key(const std::string& str)
 	{
-		_u.str = new std::string(move(str));
-	}
+		const size_t hash = std::hash<std::string>()(str);
 
-	Config::Config(std::initializer_list<std::pair<std::string, Config>> values) : _type(Uninitialized)
-	{
-		make_object();
-		for (auto&& v : values) {
-			(*this)[v.first] = std::move(v.second);
+		Key& recent = KeyTable::recent(hash);
+		if (recent._info && recent._info->hash == hash && *recent._str == str) {
+			_str  = recent._str;
+			_info = recent._info;
+			_info->ref_count.fetch_add(1, std::memory_order_relaxed);
+			return;
 		}
-	}
 
-	void Config::make_object()
-	{
-		assert_type(Uninitialized);
-		_type = Object;
-		_u.object = new ConfigObject();
-	}
+		KeyTable& table = KeyTable::instance();
+		{
+			std::lock_guard<std::mutex> lock(table.mutex);
+			auto it = table.keys.find(str);
+			if (it == table.keys.end()) {
+				it = table.keys.emplace(std::piecewise_construct, std::forward_as_tuple(str), std::forward_as_tuple()).first;
+				it->second.hash          = hash;
+				it->second.is_identifier = configuru::is_identifier(str.c_str());
+			}
+			it->second.ref_count.fetch_add(1, std::memory_order_relaxed);
+			_str  = &it->first;
+			_info = &it->second;
+		}
 
-	void Config::make_array()
-	{
-		assert_type(Uninitialized);
-		_type = Array;
-		_u.array = new ConfigArray();
+		recent = *this;
 	}
 
-	Config Config::object()
+	void Key::release()
 	{
-		Config ret;
-		ret.make_object();
-		return ret;
-	}
+		unsigned count = _info->ref_count.load(std::memory_order_relaxed);
+		while (count > 1) {
+			if (_info->ref_count.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel)) {
+				return;
+			}
+		}
 
-	Config Config::object(std::initializer_list<std::pair<std::string, Config>> values)
-	{
-		Config ret;
-		ret.make_object();
-		for (auto&& p : values) {
-			ret[static_cast<std::string>(p.first)] = std::move(p.second);
+		// We may hold the last reference. Then the key goes away, under the lock so no one interns it meanwhile:
+		KeyTable& table = KeyTable::instance();
+		std::lock_guard<std::mutex> lock(table.mutex);
+		if (_info->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			table.keys.erase(table.keys.find(*_str));
 		}
-		return ret;
 	}
 
-	Config Config::array()
+	// The CommentEntries of the Configs of one document (see DocTable::comments). A Config only changes its own
+	// entry, and entries never move, so reading one takes no lock. Adding or freeing one locks this document only.
+	class CommentStore
 	{
-		Config ret;
-		ret.make_array();
-		return ret;
-	}
+	public:
+		CommentStore() = default;
+		CommentStore(const CommentStore&) = delete;
+		CommentStore& operator=(const CommentStore&) = delete;
 
-	Config Config::array(std::initializer_list<Config> values)
-	{
-		Config ret;
-		ret.make_array();
-		ret._u.array->_impl.reserve(values.size());
-		for (auto&& v : values) {
-			ret.push_back(std::move(v));
+		~CommentStore()
+		{
+			CommentEntry** entries = _entries.load(std::memory_order_relaxed);
+			for (uint32_t i = 0; i < _size; ++i) {
+				delete entries[i];
+			}
 		}
-		return ret;
-	}
 
-	void Config::tag(const DocInfo_SP& doc, Index line, Index column)
-	{
-		_doc = doc;
-		_line = line;
-		(void)column; // TODO: include this info too.
-	}
+		CommentEntry& operator[](Index index) const
+		{
+			return *_entries.load(std::memory_order_acquire)[index];
+		}
 
-	// ------------------------------------------------------------------------
+		// Returns the index of a new entry for a Config on this line.
+		Index add(Index line)
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			Index index;
+			if (!_free.empty()) {
+				index = _free.back();
+				_free.pop_back();
+			} else {
+				if (_size == _capacity) {
+					grow();
+				}
+				_arrays.back()[_size] = new CommentEntry();
+				index = _size++;
+			}
+			(*this)[index].line = line;
+			return index;
+		}
 
-	Config::Config(const Config& o) : _type(Uninitialized)
-	{
-		*this = o;
-	}
+		// Frees an entry, which must have no comments left. Returns its line.
+		Index free(Index index)
+		{
+			const Index line = (*this)[index].line;
+			std::lock_guard<std::mutex> lock(_mutex);
+			_free.push_back(index);
+			return line;
+		}
 
-	Config::Config(Config&& o) noexcept : _type(Uninitialized)
-	{
-		this->swap(o);
-	}
+	private:
+		void grow()
+		{
+			const uint32_t capacity = _capacity == 0 ? 16 : 2 * _capacity;
+			std::unique_ptr<CommentEntry*[]> entries(new CommentEntry*[capacity]);
+			if (_size != 0) {
+				std::copy(_arrays.back().get(), _arrays.back().get() + _size, entries.get());
+			}
+			_entries.store(entries.get(), std::memory_order_release);
+			_arrays.push_back(std::move(entries));
+			_capacity = capacity;
+		}
+
+		std::mutex                                     _mutex;
+		std::atomic<CommentEntry**>                    _entries { nullptr };
+		std::vector<std::unique_ptr<CommentEntry*[]>> _arrays;  // The last is _entries. The others are kept, as a reader may still be in one.
+		std::vector<Index>                             _free;    // Indices of entries no Config has
+		uint32_t                                       _size     = 0;
+		uint32_t                                       _capacity = 0;
+	};
 
-	void Config::swap(Config& o) noexcept
+	// The documents Configs are tagged with, by id, so that a Config only needs to store a small integer
+	// to name its document. Each value tagged with an id pins it (as do FrozenConfigs and bad lookups),
+	// and the id keeps its DocInfo alive until the last pin is gone. Only then is the id reused, so an id
+	// always names the document it was given for. A DocTagger pins an id once for all the values it tags.
+	// Each id also has the comments of the values of its document. Those of values without a document are under 0.
+	// Never destroyed, for the same reason as KeyTable.
+	struct DocTable
 	{
-		if (&o == this) { return; }
-		std::swap(_type,     o._type);
-		std::swap(_u,        o._u);
-		std::swap(_doc,      o._doc);
-		std::swap(_line,     o._line);
-		std::swap(_comments, o._comments);
-	}
+		static const size_t PAGE_SIZE = 256;
 
-	Config& Config::operator=(Config&& o) noexcept
-	{
-		if (&o == this) { return *this; }
+		struct Slot
+		{
+			std::atomic<uint64_t>      pins { 0 };
+			DocInfo_SP                 doc;                 // Only changed under the mutex while there are no pins.
+			std::atomic<CommentStore*> comments { nullptr }; // Made when first needed
+		};
 
-		std::swap(_type, o._type);
-		std::swap(_u,    o._u);
+		std::mutex            mutex;
+		std::atomic<Slot*>    pages[0x10000 / PAGE_SIZE] = {}; // Allocated as the ids are first used
+		std::vector<uint16_t> free_ids;
+		uint32_t              next_id = 1; // The first id never handed out. 0 means no document.
 
-		// Remember where we come from even when assigned a new value:
-		if (o._doc || o._line != BAD_INDEX) {
-			std::swap(_doc,  o._doc);
-			std::swap(_line, o._line);
+		DocTable()
+		{
+			pages[0].store(new Slot[PAGE_SIZE], std::memory_order_relaxed); // For 0
 		}
 
-		if (o._comments) {
-			std::swap(_comments, o._comments);
+		static DocTable& instance()
+		{
+			static DocTable* s_table = new DocTable();
+			return *s_table;
 		}
 
-		return *this;
-	}
-
-	Config& Config::operator=(const Config& o)
-	{
-		if (&o == this) { return *this; }
-
-		free();
+		static Slot& slot(uint32_t id)
+		{
+			return instance().pages[id / PAGE_SIZE].load(std::memory_order_acquire)[id % PAGE_SIZE];
+		}
 
-		_type = o._type;
+		// Adds count pins to the id of doc, giving it one first if it has none.
+		// 0 if doc is nullptr, or all ids are pinned (its values will only know their line).
+		static uint16_t pin(const DocInfo_SP& doc, uint64_t count)
+		{
+			if (!doc) { return 0; }
+			DocTable& table = instance();
+			std::lock_guard<std::mutex> lock(table.mutex);
+			uint16_t id = doc->_id;
+			if (id == 0) {
+				if (!table.free_ids.empty()) {
+					id = table.free_ids.back();
+					table.free_ids.pop_back();
+				} else if (table.next_id <= 0xFFFF) {
+					id = static_cast<uint16_t>(table.next_id++);
+					if (!table.pages[id / PAGE_SIZE].load(std::memory_order_relaxed)) {
+						table.pages[id / PAGE_SIZE].store(new Slot[PAGE_SIZE], std::memory_order_release);
+					}
+				} else {
+					return 0;
+				}
+				slot(id).doc = doc;
+				doc->_id = id;
+			}
+			slot(id).pins.fetch_add(count, std::memory_order_relaxed);
+			return id;
+		}
 
-		#if CONFIGURU_VALUE_SEMANTICS
-			if (_type == String) {
-				_u.str = new std::string(*o._u.str);
-			} else if (_type == BadLookupType) {
-				_u.bad_lookup = new BadLookupInfo(*o._u.bad_lookup);
-			} else if (_type == Object) {
-				_u.object = new ConfigObject(*o._u.object);
-			} else if (_type == Array) {
-				_u.array = new ConfigArray(*o._u.array);
-			} else {
-				memcpy(&_u, &o._u, sizeof(_u));
+		// One more pin for an id that is already pinned (by what it is copied from).
+		static void pin(uint32_t id)
+		{
+			if (id != 0) {
+				slot(id).pins.fetch_add(1, std::memory_order_relaxed);
 			}
-		#else // !CONFIGURU_VALUE_SEMANTICS:
-			if (_type == String) {
-				_u.str = new std::string(*o._u.str);
-			} else {
-				memcpy(&_u, &o._u, sizeof(_u));
-				if (_type == BadLookupType) { ++_u.bad_lookup->_ref_count; }
-				if (_type == Array)         { ++_u.array->_ref_count; }
-				if (_type == Object)        { ++_u.object->_ref_count; }
+		}
+
+		static void unpin(uint32_t id, uint64_t count = 1)
+		{
+			if (id == 0 || slot(id).pins.fetch_sub(count, std::memory_order_acq_rel) != count) { return; }
+			DocInfo_SP doc; // Released after the lock, as it may hold the last references to its includers
+			std::unique_ptr<CommentStore> comments;
+			DocTable& table = instance();
+			std::lock_guard<std::mutex> lock(table.mutex);
+			Slot& s = slot(id);
+			if (s.pins.load(std::memory_order_relaxed) == 0 && s.doc) { // Unless pinned again meanwhile
+				doc = std::move(s.doc);
+				doc->_id = 0;
+				comments.reset(s.comments.exchange(nullptr, std::memory_order_relaxed)); // No value has any entry left
+				table.free_ids.push_back(static_cast<uint16_t>(id));
+			}
+		}
+
+		// The comments of the values with this id (pinned by the caller), or of those without a document for 0.
+		static CommentStore& comments(uint32_t id)
+		{
+			Slot& s = slot(id);
+			CommentStore* store = s.comments.load(std::memory_order_acquire);
+			if (!store) {
+				std::lock_guard<std::mutex> lock(instance().mutex);
+				store = s.comments.load(std::memory_order_relaxed);
+				if (!store) {
+					store = new CommentStore();
+					s.comments.store(store, std::memory_order_release);
+				}
 			}
-		#endif // !CONFIGURU_VALUE_SEMANTICS
+			return *store;
+		}
 
-		// Remember where we come from even when assigned a new value:
-		if (o._doc || o._line != BAD_INDEX) {
-			_doc  = o._doc;
-			_line = o._line;
+		// The document of an id we hold a pin for, or nullptr for 0.
+		static DocInfo_SP find(uint32_t id)
+		{
+			return id == 0 ? nullptr : slot(id).doc;
+		}
+	};
+
+	// Tags the values of a document as they are parsed. Pins the id of the document once for all of them
+	// (with a bias, so it cannot run out while values are still being tagged and freed), not once per value.
+	class DocTagger
+	{
+	public:
+		explicit DocTagger(const DocInfo_SP& doc) : _doc(doc)
+		{
+			#if CONFIGURU_LOCATIONS
+				_id = DocTable::pin(doc, BIAS);
+			#endif
 		}
 
-		if (o._comments) {
-			_comments.reset(new ConfigComments(*o._comments));
+		~DocTagger()
+		{
+			DocTable::unpin(_id, BIAS - _count);
 		}
 
-		#if CONFIGURU_VALUE_SEMANTICS
-			o.mark_accessed(true);
-		#endif
+		DocTagger(const DocTagger&) = delete;
+		DocTagger& operator=(const DocTagger&) = delete;
 
-		return *this;
-	}
+		const DocInfo_SP& doc() const { return _doc; }
 
-	Config::~Config()
-	{
-		free();
-	}
+		void tag(Config& config, Index line)
+		{
+			#if CONFIGURU_LOCATIONS
+				config.set_location(_id, line);
+				_count += _id != 0;
+			#else
+				(void)config;
+				(void)line;
+			#endif
+		}
 
-	void Config::free()
+	private:
+		static const uint64_t BIAS = uint64_t(1) << 62; // More values than we will ever tag
+
+		DocInfo_SP _doc;
+		uint16_t   _id    = 0;
+		uint64_t   _count = 0;
+	};
+
+	// The memory of a document parsed with FormatOptions::arena. Blocks are cut off the current chunk,
+	// and each holds a reference to the arena, so that all chunks are freed together when the last block is.
+	// Big blocks (like the storage of a long array) come from upstream instead, so they are not wasted as the
+	// array grows. Freed small blocks are reused. While the document is built only its builder allocates.
+	// Once sealed, the document is in the hands of the user, who may change and free it on any thread, so then we lock.
+	class DocArena : public MemoryResource
 	{
-		#if CONFIGURU_VALUE_SEMANTICS
-			if (_type == BadLookupType) {
-				delete _u.bad_lookup;
-			} else if (_type == Object) {
-				delete _u.object;
-			} else if (_type == Array) {
-				delete _u.array;
-			} else if (_type == String) {
-				delete _u.str;
+	public:
+		DocArena(MemoryResource* upstream, bool huge_pages) : _upstream(upstream), _huge_pages(huge_pages) {}
+
+		DocArena(const DocArena&) = delete;
+		DocArena& operator=(const DocArena&) = delete;
+
+		void* allocate(size_t size, size_t alignment) override
+		{
+			if (size == 0) { size = 1; } // Still a block of its own
+			_ref_count.fetch_add(1, std::memory_order_relaxed);
+			if (size > MAX_SMALL || alignment > ALIGNMENT) {
+				return _upstream ? _upstream->allocate(size, alignment) : ::operator new(size);
 			}
-		#else // !CONFIGURU_VALUE_SEMANTICS:
-			if (_type == BadLookupType) {
-				if (--_u.bad_lookup->_ref_count == 0) {
-					delete _u.bad_lookup;
+			if (_sealed.load(std::memory_order_relaxed)) {
+				std::lock_guard<std::mutex> lock(_mutex);
+				return allocate_small(size);
+			}
+			return allocate_small(size);
+		}
+
+		void deallocate(void* ptr, size_t size, size_t alignment) override
+		{
+			if (size == 0) { size = 1; }
+			Teardown* teardown = Teardown::of(this);
+			if (size > MAX_SMALL || alignment > ALIGNMENT) {
+				if (_upstream) {
+					_upstream->deallocate(ptr, size, alignment);
+				} else {
+					::operator delete(ptr);
 				}
-			} else if (_type == Object) {
-				if (--_u.object->_ref_count == 0) {
-					delete _u.object;
+			} else if (teardown) {
+				teardown->free_small(ptr, size);
+			} else if (_sealed.load(std::memory_order_relaxed)) {
+				std::lock_guard<std::mutex> lock(_mutex);
+				free_small(ptr, size);
+			} else {
+				free_small(ptr, size);
+			}
+
+			if (teardown) {
+				teardown->count += 1;
+			} else {
+				release(); // Last, as it may delete us
+			}
+		}
+
+		MemoryResource* resource_for_copies() override { return _upstream; }
+
+		// The builder is done. Called on its thread before the document leaves it.
+		void seal() { _sealed.store(true, std::memory_order_relaxed); }
+
+		void release(size_t count = 1)
+		{
+			if (_ref_count.fetch_sub(count, std::memory_order_acq_rel) == count) {
+				delete this;
+			}
+		}
+
+		// Around deleting a tree of values on this thread (see delete_container).
+		static void begin_teardown() { Teardown::current().active = true; }
+
+		static void end_teardown()
+		{
+			Teardown& teardown = Teardown::current();
+			teardown.active = false;
+			if (DocArena* arena = teardown.arena) {
+				teardown.arena = nullptr;
+				arena->finish(teardown);
+			}
+		}
+
+	private:
+		struct Chunk
+		{
+			char*  memory;
+			size_t size;
+			bool   mapped; // Else from upstream
+		};
+
+		static const size_t ALIGNMENT   = alignof(void*);
+		static const size_t MAX_SMALL   = 1024;
+		static const size_t FIRST_CHUNK = 4096;
+		static const size_t MAX_CHUNK   = 4 << 20;
+		static const size_t HUGE_PAGE   = 2 << 20;
+		static const size_t NUM_SIZES   = MAX_SMALL / ALIGNMENT + 1;
+
+		// What a thread frees of one arena while it deletes a tree, typically a whole document.
+		// The blocks go on lists of our own, without a lock or a change of the reference count each.
+		// Once the tree is gone they are handed back in one go, or, if nothing else uses the arena, its chunks are just freed.
+		struct Teardown
+		{
+			bool      active = false;   // Between begin_teardown and end_teardown
+			DocArena* arena  = nullptr; // The first arena freed from, the only one we keep blocks of
+			size_t    count  = 0;       // Blocks freed, each holding a reference to arena
+			void*     head[NUM_SIZES] = {};
+			void*     tail[NUM_SIZES] = {};
+
+			// Trivially destructible, like s_delete_depth.
+			static Teardown& current()
+			{
+				static thread_local Teardown s_teardown;
+				return s_teardown;
+			}
+
+			// Where to put what is freed of arena, or nullptr for the usual way.
+			static Teardown* of(DocArena* arena)
+			{
+				Teardown& teardown = current();
+				if (!teardown.active) { return nullptr; }
+				if (!teardown.arena) { teardown.arena = arena; }
+				return teardown.arena == arena ? &teardown : nullptr;
+			}
+
+			void free_small(void* ptr, size_t size)
+			{
+				const size_t index = (size + ALIGNMENT - 1) / ALIGNMENT;
+				*static_cast<void**>(ptr) = head[index];
+				if (!head[index]) { tail[index] = ptr; }
+				head[index] = ptr;
+			}
+		};
+
+		void finish(Teardown& teardown)
+		{
+			const size_t count = teardown.count;
+			teardown.count = 0;
+			// If the blocks we freed hold the only references, nobody else can allocate from us any more:
+			const bool last = _ref_count.load(std::memory_order_acquire) == count;
+
+			std::unique_lock<std::mutex> lock(_mutex, std::defer_lock);
+			if (!last && _sealed.load(std::memory_order_relaxed)) {
+				lock.lock();
+			}
+			for (size_t index = 0; index < NUM_SIZES; ++index) {
+				if (!teardown.head[index]) { continue; }
+				if (!last) {
+					*static_cast<void**>(teardown.tail[index]) = _free[index];
+					_free[index] = teardown.head[index];
 				}
-			} else if (_type == Array) {
-				if (--_u.array->_ref_count == 0) {
-					delete _u.array;
+				teardown.head[index] = nullptr;
+			}
+			if (lock.owns_lock()) { lock.unlock(); }
+
+			release(count); // Last, as it may delete us
+		}
+
+		~DocArena()
+		{
+			for (const Chunk& chunk : _chunks) {
+				#if defined(__linux__)
+					if (chunk.mapped) {
+						munmap(chunk.memory, chunk.size);
+						continue;
+					}
+				#endif
+				if (_upstream) {
+					_upstream->deallocate(chunk.memory, chunk.size, ALIGNMENT);
+				} else {
+					::operator delete(chunk.memory);
 				}
-			} else if (_type == String) {
-				delete _u.str;
 			}
-		#endif // !CONFIGURU_VALUE_SEMANTICS
+		}
 
-		_type = Uninitialized;
+		void* allocate_small(size_t size)
+		{
+			const size_t index = (size + ALIGNMENT - 1) / ALIGNMENT;
+			if (void* block = _free[index]) {
+				_free[index] = *static_cast<void**>(block);
+				return block;
+			}
+			size = index * ALIGNMENT;
+			if (size > static_cast<size_t>(_end - _next)) {
+				add_chunk();
+			}
+			void* block = _next;
+			_next += size;
+			return block;
+		}
+
+		// The next block of the same size can have it:
+		void free_small(void* ptr, size_t size)
+		{
+			const size_t index = (size + ALIGNMENT - 1) / ALIGNMENT;
+			*static_cast<void**>(ptr) = _free[index];
+			_free[index] = ptr;
+		}
+
+		void add_chunk()
+		{
+			const size_t size = _chunk_size;
+			if (_chunk_size < MAX_CHUNK) { _chunk_size *= 2; }
+
+			#if defined(__linux__) && defined(MADV_HUGEPAGE)
+				if (_huge_pages) {
+					// Huge pages need to be aligned, so map one more and skip to the first one:
+					const size_t huge_size = (size + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1);
+					void* memory = mmap(nullptr, huge_size + HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+					if (memory != MAP_FAILED) {
+						_chunks.push_back(Chunk{static_cast<char*>(memory), huge_size + HUGE_PAGE, true});
+						_next = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(memory) + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1));
+						_end  = _next + huge_size;
+						madvise(_next, huge_size, MADV_HUGEPAGE); // Just a hint
+						return;
+					}
+				}
+			#endif
+
+			void* memory = _upstream ? _upstream->allocate(size, ALIGNMENT) : ::operator new(size);
+			_chunks.push_back(Chunk{static_cast<char*>(memory), size, false});
+			_next = _chunks.back().memory;
+			_end  = _next + size;
+		}
+
+		MemoryResource*     _upstream;
+		const bool          _huge_pages;
+		std::atomic<size_t> _ref_count { 1 }; // One for whoever created us
+		std::atomic<bool>   _sealed { false };
+		std::mutex          _mutex;           // For allocating once sealed
+		char*               _next       = nullptr;
+		char*               _end        = nullptr;
+		size_t              _chunk_size = FIRST_CHUNK; // Of the next one
+		std::vector<Chunk>  _chunks;
+		void*               _free[NUM_SIZES] = {}; // Freed blocks by size, linked through their first bytes
+	};
 
-		// Keep _doc, _line, _comments until overwritten/destructor.
+	size_t Key::hash() const
+	{
+		return _info ? _info->hash : std::hash<std::string>()(*_str);
 	}
 
-	// ------------------------------------------------------------------------
+	bool Key::is_identifier() const
+	{
+		return _info ? _info->is_identifier : configuru::is_identifier(_str->c_str());
+	}
 
-	size_t Config::object_size() const
+	static MemoryResource* copy_resource(MemoryResource* resource)
 	{
-		return as_object()._impl.size();
+		return resource ? resource->resource_for_copies() : nullptr;
 	}
 
-	const Config& Config::operator[](const std::string& key) const
+	// Like new and delete, but with memory from the resource, unless that is nullptr.
+	template<typename T, typename... Args>
+	static T* create(MemoryResource* resource, Args&&... args)
 	{
-		auto&& object = as_object()._impl;
-		auto it = object.find(key);
-		if (it == object.end()) {
-			on_error("Key '" + key + "' not in object");
-		} else {
-			const auto& entry = it->second;
-			entry._accessed = true;
-			return entry._value;
-		}
+		if (!resource) { return new T(std::forward<Args>(args)...); }
+		return new (resource->allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
 	}
 
-	Config& Config::operator[](const std::string& key)
+	template<typename T>
+	static void destroy(MemoryResource* resource, T* ptr)
 	{
-		auto&& object = as_object()._impl;
-		auto&& entry = object[key];
-		if (entry._nr == BAD_INDEX) {
-			// New entry
-			entry._nr = static_cast<Index>(object.size()) - 1;
-			entry._value._type = BadLookupType;
-			entry._value._u.bad_lookup = new BadLookupInfo{_doc, _line, key};
+		if (!resource) {
+			delete ptr;
 		} else {
-			entry._accessed = true;
+			ptr->~T();
+			resource->deallocate(ptr, sizeof(T), alignof(T));
 		}
-		return entry._value;
 	}
 
-	bool Config::has_key(const std::string& key) const
+	struct BadLookupInfo
 	{
-		return as_object()._impl.count(key) != 0;
-	}
+		const uint32_t        doc_id;   // Of parent object. Pinned in DocTable.
+		const unsigned        line;     // Of parent object
+		const std::string     key;
+		MemoryResource* const resource; // Of parent object, and where we were allocated
+
+		#if !CONFIGURU_VALUE_SEMANTICS
+			std::atomic<unsigned> _ref_count { 1 };
+		#endif
+
+		BadLookupInfo(uint32_t doc_id_, Index line_, std::string key_, MemoryResource* resource_)
+			: doc_id(doc_id_), line(line_), key(std::move(key_)), resource(resource_) { DocTable::pin(doc_id); }
+
+		BadLookupInfo(const BadLookupInfo&) = delete;
 
-	bool Config::emplace(std::string key, Config value)
+		~BadLookupInfo() { DocTable::unpin(doc_id); }
+	};
+
+	Config::Config(const char* str)
 	{
-		auto&& object = as_object()._impl;
-		return object.emplace(
-			std::move(key),
-			Config::ObjectEntry{std::move(value), (unsigned)object.size()}).second;
+		CONFIGURU_ASSERT(str != nullptr);
+		set_string(str, strlen(str));
 	}
 
-	void Config::insert_or_assign(const std::string& key, Config&& config)
+	Config::Config(const std::string& str)
 	{
-		auto&& object = as_object()._impl;
-		auto&& entry = object[key];
-		if (entry._nr == BAD_INDEX) {
-			// New entry
-			entry._nr = static_cast<Index>(object.size()) - 1;
-		} else {
-			entry._accessed = true;
-		}
-		entry._value = std::move(config);
+		set_string(str.data(), str.size());
 	}
 
-	bool Config::erase(const std::string& key)
+	Config::Config(const char* str, size_t size)
 	{
-		auto& object = as_object()._impl;
-		auto it = object.find(key);
-		if (it == object.end()) {
-			return false;
-		} else {
-			object.erase(it);
-			return true;
-		}
+		set_string(str, size);
 	}
 
-	bool Config::deep_eq(const Config& a, const Config& b)
+	void Config::set_string(const char* str, size_t size)
 	{
-		if (a._type != b._type) { return false; }
-		if (a._type == Null)   { return true; }
-		if (a._type == Bool)   { return a._u.b    == b._u.b;    }
-		if (a._type == Int)    { return a._u.i    == b._u.i;    }
-		if (a._type == Float)  { return a._u.f    == b._u.f;    }
-		if (a._type == String) { return *a._u.str == *b._u.str; }
-		if (a._type == Object)    {
-			if (a._u.object == b._u.object) { return true; }
-			auto&& a_object = a.as_object()._impl;
-			auto&& b_object = b.as_object()._impl;
-			if (a_object.size() != b_object.size()) { return false; }
-			for (auto&& p: a_object) {
-				auto it = b_object.find(p.first);
-				if (it == b_object.end()) { return false; }
-				if (!deep_eq(p.second._value, it->second._value)) { return false; }
-			}
-			return true;
-		}
-		if (a._type == Array)    {
-			if (a._u.array == b._u.array) { return true; }
-			auto&& a_array = a.as_array();
-			auto&& b_array = b.as_array();
-			if (a_array.size() != b_array.size()) { return false; }
-			for (size_t i=0; i<a_array.size(); ++i) {
-				if (!deep_eq(a_array[i], b_array[i])) {
-					return false;
-				}
-			}
-			return true;
+		const size_t SMALL = sizeof(_u.small);
+		if (size < SMALL) {
+			memcpy(_u.small, str, size);
+			memset(_u.small + size, 0, SMALL - 1 - size);
+			_u.small[SMALL - 1] = static_cast<char>(SMALL - 1 - size);
+			_flags |= SmallString;
+		} else {
+			char* block = static_cast<char*>(::operator new(sizeof(size_t) + size + 1));
+			memcpy(block, &size, sizeof(size_t));
+			_u.str = block + sizeof(size_t);
+			memcpy(_u.str, str, size);
+			_u.str[size] = '\0';
 		}
-
-		return false;
+		_type = String;
 	}
 
-#if !CONFIGURU_VALUE_SEMANTICS
-	Config Config::deep_clone() const
+	void Config::make_string(const char* str, size_t size, MemoryResource* resource)
 	{
-		Config ret = *this;
-		if (ret._type == Object) {
-			ret = Config::object();
-			for (auto&& p : this->as_object()._impl) {
-				auto& dst = ret._u.object->_impl[p.first];
-				dst._nr    = p.second._nr;
-				dst._value = p.second._value.deep_clone();
-			}
-		}
-		if (ret._type == Array) {
-			ret = Config::array();
-			for (auto&& value : this->as_array()) {
-				ret.push_back( value.deep_clone() );
-			}
+		assert_type(Uninitialized);
+		if (!resource || size < sizeof(_u.small)) {
+			set_string(str, size);
+			return;
 		}
-		return ret;
+		const size_t header = sizeof(MemoryResource*) + sizeof(size_t);
+		char* block = static_cast<char*>(resource->allocate(header + size + 1, alignof(size_t)));
+		memcpy(block, &resource, sizeof(MemoryResource*));
+		memcpy(block + sizeof(MemoryResource*), &size, sizeof(size_t));
+		_u.str = block + header;
+		memcpy(_u.str, str, size);
+		_u.str[size] = '\0';
+		_flags |= InResource;
+		_type = String;
 	}
-#endif
 
-	void Config::visit_dangling(const std::function<void(const std::string& key, const Config& value)>& visitor) const
+	size_t Config::string_length() const
 	{
-		if (is_object()) {
-			for (auto&& p : as_object()._impl) {
-				auto&& entry = p.second;
-				auto&& value = entry._value;
-				if (entry._accessed) {
-					value.check_dangling();
-				} else {
-					visitor(p.first, value);
-				}
-			}
-		} else if (is_array()) {
-			for (auto&& e : as_array()) {
-				e.check_dangling();
-			}
+		if (_flags & SmallString) {
+			return sizeof(_u.small) - 1 - static_cast<size_t>(_u.small[sizeof(_u.small) - 1]);
 		}
+		size_t size;
+		memcpy(&size, _u.str - sizeof(size_t), sizeof(size_t));
+		return size;
 	}
 
-	void Config::check_dangling() const
+	void Config::free_long_string()
 	{
-		std::string message = "";
-
-		visit_dangling([&](const std::string& key, const Config& value){
-			message += "\n    " + value.where() + "Key '" + key + "' never accessed.";
-		});
-
-		if (!message.empty()) {
-			message = "Dangling keys:" + message;
-			CONFIGURU_ON_DANGLING(message);
+		if (_flags & InResource) {
+			const size_t header = sizeof(MemoryResource*) + sizeof(size_t);
+			memory_resource()->deallocate(_u.str - header, header + string_length() + 1, alignof(size_t));
+		} else {
+			::operator delete(_u.str - sizeof(size_t));
 		}
 	}
 
-	void Config::mark_accessed(bool v) const
+	Config::Config(std::initializer_list<std::pair<std::string, Config>> values) : _type(Uninitialized)
 	{
-		if (is_object()) {
-			for (auto&& p : as_object()._impl) {
-				auto&& entry = p.second;
-				entry._accessed = v;
-				entry._value.mark_accessed(v);
-			}
-		} else if (is_array()) {
-			for (auto&& e : as_array()) {
-				e.mark_accessed(v);
-			}
+		make_object();
+		for (auto&& v : values) {
+			(*this)[v.first] = std::move(v.second);
 		}
 	}
 
-	const char* Config::debug_descr() const
+	void Config::make_object(MemoryResource* resource)
 	{
-		switch (_type) {
-			case Bool:   return _u.b ? "true" : "false";
-			case String: return _u.str->c_str();
-			default:     return type_str(_type);
-		}
+		assert_type(Uninitialized);
+		_type = Object;
+		_u.object = create<ConfigObject>(resource, resource);
 	}
 
-	const char* Config::type_str(Type t)
+	void Config::make_array(MemoryResource* resource)
 	{
-		switch (t) {
-			case Uninitialized: return "uninitialized";
-			case BadLookupType: return "undefined";
-			case Null:          return "null";
-			case Bool:          return "bool";
-			case Int:           return "integer";
-			case Float:         return "float";
-			case String:        return "string";
-			case Array:         return "array";
-			case Object:        return "object";
-		}
-		return "BROKEN Config";
+		assert_type(Uninitialized);
+		_type = Array;
+		_u.array = create<ConfigArray>(resource, resource);
 	}
 
-	std::string where_is(const DocInfo_SP& doc, Index line)
+	void Config::make_lazy(bool is_object, LazyRange_SP range)
 	{
-		if (doc) {
-			std::string ret = doc->filename;
-			if (line != BAD_INDEX) {
-				ret += ":" + std::to_string(line);
-			}
-			doc->append_include_info(ret);
-			ret += ": ";
-			return ret;
-		} else if (line != BAD_INDEX) {
-			return "line " + std::to_string(line) + ": ";
+		if (is_object) {
+			make_object();
+			_u.object->_lazy = std::move(range);
+			_u.object->_is_lazy = true;
 		} else {
-			return "";
+			make_array();
+			_u.array->_lazy = std::move(range);
+			_u.array->_is_lazy = true;
 		}
 	}
 
-	std::string Config::where() const
+	// Guards the parsing of a lazy array/object, so that it is parsed once even if several threads reach into it.
+	// The mutexes are shared, so that they cost no memory per array/object.
+	static std::mutex& lazy_mutex(const void* container)
 	{
-		return where_is(_doc, _line);
+		static std::mutex s_mutexes[64];
+		return s_mutexes[(reinterpret_cast<uintptr_t>(container) / 64) % 64];
 	}
 
-	void Config::on_error(const std::string& msg) const
+	// Once parsed, an array/object is never lazy again, so there is nothing to guard.
+	static std::unique_lock<std::mutex> lock_if_lazy(const std::atomic<bool>& is_lazy, const void* container)
 	{
-		CONFIGURU_ONERROR(where() + msg);
-		abort(); // We shouldn't get here.
+		if (!is_lazy.load(std::memory_order_acquire)) { return {}; }
+		return std::unique_lock<std::mutex>(lazy_mutex(container));
 	}
 
-	void Config::assert_type(Type exepected) const
+	Config::ConfigArray::ConfigArray(const ConfigArray& o, MemoryResource* resource)
+		: ConfigArray(resource)
 	{
-		if (_type == BadLookupType) {
-			auto where = where_is(_u.bad_lookup->doc, _u.bad_lookup->line);
-			CONFIGURU_ONERROR(where + "Failed to find key '" + _u.bad_lookup->key + "'");
-		} else if (_type != exepected) {
-			const auto message = where() + "Expected " + type_str(exepected) + ", got " + type_str(_type);
-			if (_type == Uninitialized && exepected == Object) {
-				CONFIGURU_ONERROR(message + ". Did you forget to call Config::object()?");
-			} else if (_type == Uninitialized && exepected == Array) {
-				CONFIGURU_ONERROR(message + ". Did you forget to call Config::array()?");
-			} else {
-				CONFIGURU_ONERROR(message);
-			}
-		}
+		auto lock = lock_if_lazy(o._is_lazy, &o);
+		ConfigArrayImpl(o._impl, _impl.get_allocator()).swap(_impl);
+		_lazy          = o._lazy;
+		_is_lazy       = o._is_lazy.load(std::memory_order_relaxed);
+		_lazy_accessed = o._lazy_accessed;
 	}
 
-	std::ostream& operator<<(std::ostream& os, const Config& cfg)
+	Config::ConfigObject::ConfigObject(const ConfigObject& o, MemoryResource* resource)
+		: ConfigObject(resource)
 	{
-		auto format = JSON;
-		// Make sure that all config types are serializable:
-		format.inf                 = true;
-		format.nan                 = true;
-		format.write_uninitialized = true;
-		format.end_with_newline    = false;
-		format.mark_accessed       = false;
-		return os << dump_string(cfg, format);
+		auto lock = lock_if_lazy(o._is_lazy, &o);
+		ConfigObjectImpl(o._impl, _impl.get_allocator()).swap(_impl);
+		_lazy          = o._lazy;
+		_is_lazy       = o._is_lazy.load(std::memory_order_relaxed);
+		_lazy_accessed = o._lazy_accessed;
 	}
-}
 
-// ----------------------------------------------------------------------------
-// 88""Yb    db    88""Yb .dP"Y8 888888 88""Yb
-// 88__dP   dPYb   88__dP `Ybo." 88__   88__dP
-// 88"""   dP__Yb  88"Yb  o.`Y8b 88""   88"Yb
-// 88     dP""""Yb 88  Yb 8bodP' 888888 88  Yb
+	Config Config::object()
+	{
+		Config ret;
+		ret.make_object();
+		return ret;
+	}
 
-#include <cerrno>
-#include <cstdlib>
+	Config Config::object(MemoryResource* resource)
+	{
+		Config ret;
+		ret.make_object(resource);
+		return ret;
+	}
 
-namespace configuru
-{
-	void append(Comments& a, Comments&& b)
+	Config Config::object(std::initializer_list<std::pair<std::string, Config>> values)
 	{
-		for (auto&& entry : b) {
-			a.emplace_back(std::move(entry));
+		Config ret;
+		ret.make_object();
+		for (auto&& p : values) {
+			ret[static_cast<std::string>(p.first)] = std::move(p.second);
 		}
+		return ret;
 	}
 
-	bool ConfigComments::empty() const
+	Config Config::array()
 	{
-		return prefix.empty()
-			&& postfix.empty()
-			&& pre_end_brace.empty();
+		Config ret;
+		ret.make_array();
+		return ret;
 	}
 
-	void ConfigComments::append(ConfigComments&& other)
+	Config Config::array(MemoryResource* resource)
 	{
-		configuru::append(this->prefix,        std::move(other.prefix));
-		configuru::append(this->postfix,       std::move(other.postfix));
-		configuru::append(this->pre_end_brace, std::move(other.pre_end_brace));
+		Config ret;
+		ret.make_array(resource);
+		return ret;
 	}
 
-	// Returns the number of bytes written, or 0 on error
-	size_t encode_utf8(std::string& dst, uint64_t c)
+	Config Config::array(std::initializer_list<Config> values)
 	{
-		if (c <= 0x7F)  // 0XXX XXXX - one byte
-		{
-			dst += static_cast<char>(c);
-			return 1;
+		Config ret;
+		ret.make_array();
+		ret._u.array->_impl.reserve(values.size());
+		for (auto&& v : values) {
+			ret.push_back(std::move(v));
 		}
-		else if (c <= 0x7FF)  // 110X XXXX - two bytes
+		return ret;
+	}
+
+	void Config::tag(const DocInfo_SP& doc, Index line, Index column)
+	{
+		#if CONFIGURU_LOCATIONS
+			set_location(DocTable::pin(doc, 1), line);
+		#else
+			(void)doc;
+			(void)line;
+		#endif
+		(void)column; // TODO: include this info too.
+	}
+
+	#if CONFIGURU_LOCATIONS
+		DocInfo_SP Config::doc() const
 		{
-			dst += static_cast<char>( 0xC0 | (c >> 6) );
-			dst += static_cast<char>( 0x80 | (c & 0x3F) );
-			return 2;
+			return DocTable::find(_doc_id);
 		}
-		else if (c <= 0xFFFF)  // 1110 XXXX - three bytes
+
+		void Config::set_doc(const DocInfo_SP& doc)
 		{
-			dst += static_cast<char>(0xE0 | (c >> 12));
-			dst += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
-			dst += static_cast<char>(0x80 | (c & 0x3F));
-			return 3;
+			set_location(DocTable::pin(doc, 1), line());
 		}
-		else if (c <= 0x1FFFFF)  // 1111 0XXX - four bytes
+
+		void Config::set_location(uint16_t doc_id, Index line)
 		{
-			dst += static_cast<char>(0xF0 | (c >> 18));
-			dst += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
-			dst += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
-			dst += static_cast<char>(0x80 | (c & 0x3F));
-			return 4;
+			if ((_flags & HasComments) && doc_id != _doc_id) {
+				// Our comments are stored with our document, so they move along:
+				ConfigComments comments = take_comments();
+				set_location(doc_id, line);
+				add_comment_entry().comments = std::move(comments);
+				return;
+			}
+			if (_flags & HasComments) {
+				comment_entry().line = line;
+			} else {
+				_line = line;
+			}
+			DocTable::unpin(_doc_id);
+			_doc_id = doc_id;
 		}
-		else if (c <= 0x3FFFFFF)  // 1111 10XX - five bytes
+
+		void Config::swap_location(Config& o) noexcept
 		{
-			dst += static_cast<char>(0xF8 | (c >> 24));
-			dst += static_cast<char>(0x80 | (c >> 18));
-			dst += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
-			dst += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
-			dst += static_cast<char>(0x80 | (c & 0x3F));
-			return 5;
+			const bool ours = (_flags & HasComments) != 0;
+			const bool theirs = (o._flags & HasComments) != 0;
+			if (!ours && !theirs) {
+				std::swap(_doc_id, o._doc_id);
+				std::swap(_line,   o._line);
+			} else {
+				// Our comments stay with us:
+				swap_extras(o);
+				swap_comments(o);
+			}
 		}
-		else if (c <= 0x7FFFFFFF)  // 1111 110X - six bytes
-		{
-			dst += static_cast<char>(0xFC | (c >> 30));
-			dst += static_cast<char>(0x80 | ((c >> 24) & 0x3F));
-			dst += static_cast<char>(0x80 | ((c >> 18) & 0x3F));
-			dst += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
-			dst += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
-			dst += static_cast<char>(0x80 | (c & 0x3F));
-			return 6;
+	#endif // CONFIGURU_LOCATIONS
+
+	CommentEntry& Config::comment_entry() const
+	{
+		return DocTable::comments(comment_doc())[comment_index()];
+	}
+
+	CommentEntry& Config::add_comment_entry()
+	{
+		if (!(_flags & HasComments)) {
+			comment_index() = DocTable::comments(comment_doc()).add(comment_index());
+			_flags |= HasComments;
 		}
-		else {
-			return 0; // Error
+		return comment_entry();
+	}
+
+	ConfigComments Config::take_comments()
+	{
+		if (!(_flags & HasComments)) { return {}; }
+		ConfigComments comments = std::move(comment_entry().comments);
+		comment_index() = DocTable::comments(comment_doc()).free(comment_index());
+		_flags &= ~HasComments;
+		return comments;
+	}
+
+	void Config::swap_comments(Config& o) noexcept
+	{
+		const bool ours = (_flags & HasComments) != 0;
+		const bool theirs = (o._flags & HasComments) != 0;
+		if (ours && theirs) {
+			std::swap(comment_entry().comments, o.comment_entry().comments);
+		} else if (ours || theirs) {
+			Config& from = ours ? *this : o;
+			Config& to   = ours ? o : *this;
+			if (from.comment_doc() == to.comment_doc()) {
+				// Hand over the entry, and with it the comments:
+				CommentEntry& entry = from.comment_entry();
+				const Index index = from.comment_index();
+				from.comment_index() = entry.line;
+				entry.line = to.comment_index();
+				to.comment_index() = index;
+				from._flags &= ~HasComments;
+				to._flags   |= HasComments;
+			} else {
+				to.add_comment_entry().comments = from.take_comments();
+			}
 		}
 	}
 
-	std::string quote(char c)
+	void Config::swap_extras(Config& o) noexcept
 	{
-		if (c == 0)    { return "<eof>";   }
-		if (c == ' ')  { return "<space>"; }
-		if (c == '\n') { return "'\\n'";   }
-		if (c == '\t') { return "'\\t'";   }
-		if (c == '\r') { return "'\\r'";   }
-		if (c == '\b') { return "'\\b'";   }
-		return std::string("'") + c + "'";
+		#if CONFIGURU_LOCATIONS
+			std::swap(_doc_id, o._doc_id);
+			std::swap(_line,   o._line);
+		#else
+			std::swap(_comment_index, o._comment_index);
+		#endif
+		const uint8_t comments = _flags & HasComments;
+		_flags   = static_cast<uint8_t>((_flags & ~HasComments) | (o._flags & HasComments));
+		o._flags = static_cast<uint8_t>((o._flags & ~HasComments) | comments);
 	}
 
-	struct State
+	// ------------------------------------------------------------------------
+
+	Config::Config(const Config& o) : _type(Uninitialized)
 	{
-		const char* ptr;
-		unsigned    line_nr;
-		const char* line_start;
-	};
+		*this = o;
+	}
 
-	struct Parser
+	Config::Config(Config&& o) noexcept : _type(Uninitialized)
 	{
-		Parser(const char* str, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info);
+		this->swap(o);
+	}
 
-		bool skip_white(Comments* out_comments, int& out_indentation, bool break_on_newline);
+	void Config::swap(Config& o) noexcept
+	{
+		if (&o == this) { return; }
+		swap_value(o);
+		swap_extras(o);
+	}
 
-		bool skip_white_ignore_comments()
-		{
-			int indentation;
-			return skip_white(nullptr, indentation, false);
-		}
+	Config& Config::operator=(Config&& o) noexcept
+	{
+		if (&o == this) { return *this; }
 
-		bool skip_pre_white(Config* config, int& out_indentation)
-		{
-			if (!MAYBE_WHITE[static_cast<uint8_t>(_ptr[0])]) {
-				// Early out
-				out_indentation = -1;
-				return false;
-			}
+		swap_value(o);
 
-			Comments comments;
-			bool did_skip = skip_white(&comments, out_indentation, false);
-			if (!comments.empty()) {
-				append(config->comments().prefix, std::move(comments));
+		// Remember where we come from even when assigned a new value:
+		const bool comments = (o._flags & HasComments) != 0;
+		#if CONFIGURU_LOCATIONS
+			if (o._doc_id || o.line() != BAD_INDEX) {
+				if (comments) {
+					swap_extras(o);
+				} else {
+					swap_location(o);
+				}
+				return *this;
 			}
-			return did_skip;
+		#endif
+
+		if (comments) {
+			swap_comments(o);
 		}
 
-		bool skip_post_white(Config* config)
-		{
-			if (!MAYBE_WHITE[static_cast<uint8_t>(_ptr[0])]) {
-				// Early out
-				return false;
-			}
+		return *this;
+	}
 
-			Comments comments;
-			int indentation;
-			bool did_skip = skip_white(&comments, indentation, true);
-			if (!comments.empty()) {
-				append(config->comments().postfix, std::move(comments));
-			}
-			return did_skip;
-		}
+	Config& Config::operator=(const Config& o)
+	{
+		if (&o == this) { return *this; }
 
-		Config top_level();
-		void parse_value(Config& out, bool* out_did_skip_postwhites);
-		void parse_array(Config& dst);
-		void parse_array_contents(Config& dst);
-		void parse_object(Config& dst);
-		void parse_object_contents(Config& dst);
-		void parse_int(Config& out);
-		void parse_float(Config& out);
-		void parse_finite_number(Config& dst);
-		std::string parse_string();
-		std::string parse_c_sharp_string();
-		uint64_t parse_hex(int count);
-		void parse_macro(Config& dst);
+		free();
 
-		void tag(Config& var)
-		{
-			var.tag(_doc, _line_nr, column());
+		// Copies use the same MemoryResource as the original (see MemoryResource::resource_for_copies):
+		if (o._type == String) {
+			make_string(o.string_data(), o.string_length(), copy_resource(o.memory_resource()));
+		} else {
+			_type = o._type;
+			#if CONFIGURU_VALUE_SEMANTICS
+				if (_type == BadLookupType) {
+					const BadLookupInfo& info = *o._u.bad_lookup;
+					MemoryResource* resource = copy_resource(info.resource);
+					_u.bad_lookup = create<BadLookupInfo>(resource, info.doc_id, info.line, info.key, resource);
+				} else if (_type == Object) {
+					MemoryResource* resource = copy_resource(o._u.object->_resource);
+					_u.object = create<ConfigObject>(resource, *o._u.object, resource);
+				} else if (_type == Array) {
+					MemoryResource* resource = copy_resource(o._u.array->_resource);
+					_u.array = create<ConfigArray>(resource, *o._u.array, resource);
+				} else {
+					memcpy(&_u, &o._u, sizeof(_u));
+				}
+			#else // !CONFIGURU_VALUE_SEMANTICS:
+				memcpy(&_u, &o._u, sizeof(_u));
+				if (_type == BadLookupType) { ++_u.bad_lookup->_ref_count; }
+				if (_type == Array)         { ++_u.array->_ref_count; }
+				if (_type == Object)        { ++_u.object->_ref_count; }
+			#endif // !CONFIGURU_VALUE_SEMANTICS
 		}
 
-		State get_state() const
-		{
-			return { _ptr, _line_nr, _line_start };
+		// Remember where we come from even when assigned a new value:
+		#if CONFIGURU_LOCATIONS
+			if (o._doc_id || o.line() != BAD_INDEX) {
+				DocTable::pin(o._doc_id);
+				set_location(o._doc_id, o.line());
+			}
+		#endif
+
+		if (o._flags & HasComments) {
+			comments() = o.comments();
 		}
 
-		void set_state(State s) {
-			_ptr        = s.ptr;
-			_line_nr    = s.line_nr;
-			_line_start = s.line_start;
+		#if CONFIGURU_VALUE_SEMANTICS
+			o.mark_accessed(true);
+		#endif
+
+		return *this;
+	}
+
+	ConfigComments& Config::comments()
+	{
+		return add_comment_entry().comments;
+	}
+
+	const ConfigComments& Config::comments() const
+	{
+		static const ConfigComments s_empty {};
+		return (_flags & HasComments) ? comment_entry().comments : s_empty;
+	}
+
+	void Config::swap_value(Config& o) noexcept
+	{
+		std::swap(_type, o._type);
+		std::swap(_u,    o._u);
+		const uint8_t differ = (_flags ^ o._flags) & (SmallString | InResource);
+		_flags   ^= differ;
+		o._flags ^= differ;
+	}
+
+	// Deleting an array/object deletes everything in it, which takes a few stack frames per level.
+	// Past this depth the arrays/objects are instead deleted by the outermost delete_container,
+	// so that a deep tree does not overflow the stack.
+	const unsigned MAX_DELETE_DEPTH = 128;
+
+	struct PendingDeletes
+	{
+		std::vector<Config::ConfigObject*> objects;
+		std::vector<Config::ConfigArray*>  arrays;
+		uint32_t                           unpin_id    = 0; // The values deleted are mostly of one document,
+		uint64_t                           unpin_count = 0; // so we unpin it once at the end
+	};
+
+	// Trivially destructible, so Configs destroyed after the thread_locals of this thread are fine too:
+	static thread_local unsigned        s_delete_depth = 0;
+	static thread_local PendingDeletes* s_pending_deletes = nullptr; // Owned by the outermost delete_container
+
+	template<typename Container>
+	static void delete_container(Container* container, std::vector<Container*> PendingDeletes::* pending)
+	{
+		if (s_delete_depth >= MAX_DELETE_DEPTH) {
+			(s_pending_deletes->*pending).push_back(container);
+			return;
 		}
 
-		Index column() const
-		{
-			return static_cast<unsigned>(_ptr - _line_start + 1);
+		if (s_delete_depth > 0) {
+			s_delete_depth += 1;
+			destroy(container->_resource, container);
+			s_delete_depth -= 1;
+			return;
 		}
 
-		const char* start_of_line() const
-		{
-			return _line_start;
+		PendingDeletes deletes;
+		s_pending_deletes = &deletes;
+		s_delete_depth = 1;
+		DocArena::begin_teardown();
+		destroy(container->_resource, container);
+		while (!deletes.objects.empty() || !deletes.arrays.empty()) {
+			if (!deletes.objects.empty()) {
+				Config::ConfigObject* object = deletes.objects.back();
+				deletes.objects.pop_back();
+				destroy(object->_resource, object);
+			} else {
+				Config::ConfigArray* array = deletes.arrays.back();
+				deletes.arrays.pop_back();
+				destroy(array->_resource, array);
+			}
+		}
+		DocArena::end_teardown();
+		s_delete_depth = 0;
+		s_pending_deletes = nullptr;
+		DocTable::unpin(deletes.unpin_id, deletes.unpin_count);
+	}
+
+	static void delete_container(Config::ConfigObject* object) { delete_container(object, &PendingDeletes::objects); }
+	static void delete_container(Config::ConfigArray* array)   { delete_container(array,  &PendingDeletes::arrays); }
+
+	Config::~Config()
+	{
+		free();
+		take_comments(); // Before unpinning the document they are stored with
+		#if CONFIGURU_LOCATIONS
+			PendingDeletes* deletes = s_pending_deletes;
+			if (deletes && _doc_id != 0 && (deletes->unpin_count == 0 || deletes->unpin_id == _doc_id)) {
+				deletes->unpin_id = _doc_id;
+				deletes->unpin_count += 1;
+			} else {
+				DocTable::unpin(_doc_id);
+			}
+		#endif
+	}
+
+	void Config::free()
+	{
+		#if CONFIGURU_VALUE_SEMANTICS
+			if (_type == BadLookupType) {
+				destroy(_u.bad_lookup->resource, _u.bad_lookup);
+			} else if (_type == Object) {
+				delete_container(_u.object);
+			} else if (_type == Array) {
+				delete_container(_u.array);
+			} else if (_type == String && !(_flags & SmallString)) {
+				free_long_string();
+			}
+		#else // !CONFIGURU_VALUE_SEMANTICS:
+			if (_type == BadLookupType) {
+				if (--_u.bad_lookup->_ref_count == 0) {
+					destroy(_u.bad_lookup->resource, _u.bad_lookup);
+				}
+			} else if (_type == Object) {
+				if (--_u.object->_ref_count == 0) {
+					delete_container(_u.object);
+				}
+			} else if (_type == Array) {
+				if (--_u.array->_ref_count == 0) {
+					delete_container(_u.array);
+				}
+			} else if (_type == String && !(_flags & SmallString)) {
+				free_long_string();
+			}
+		#endif // !CONFIGURU_VALUE_SEMANTICS
+
+		_type = Uninitialized;
+		_flags &= ~(SmallString | InResource);
+
+		// Keep _doc_id, _line and comments until overwritten/destructor.
+	}
+
+	// ------------------------------------------------------------------------
+
+	size_t Config::object_size() const
+	{
+		return as_object()._impl.size();
+	}
+
+	const Config& Config::operator[](const std::string& key) const
+	{
+		auto&& object = as_object()._impl;
+		auto it = object.find(Key::lookup(key));
+		if (it == object.end()) {
+			on_error("Key '" + key + "' not in object");
+		} else {
+			const auto& entry = it->second;
+			entry._accessed = true;
+			return entry._value;
+		}
+	}
+
+	Config& Config::operator[](const std::string& key)
+	{
+		auto&& object = as_object()._impl;
+		auto&& entry = object[key];
+		if (entry._nr == BAD_INDEX) {
+			// New entry
+			entry._nr = static_cast<Index>(object.size()) - 1;
+			entry._value._type = BadLookupType;
+			entry._value._u.bad_lookup = create<BadLookupInfo>(_u.object->_resource, doc_id(), line(), key, _u.object->_resource);
+		} else {
+			entry._accessed = true;
+		}
+		return entry._value;
+	}
+
+	bool Config::has_key(const std::string& key) const
+	{
+		return as_object()._impl.count(Key::lookup(key)) != 0;
+	}
+
+	bool Config::emplace(Key key, Config value)
+	{
+		auto&& object = as_object()._impl;
+		return object.emplace(
+			std::move(key),
+			Config::ObjectEntry{std::move(value), (unsigned)object.size()}).second;
+	}
+
+	void Config::insert_or_assign(const std::string& key, Config&& config)
+	{
+		auto&& object = as_object()._impl;
+		auto&& entry = object[key];
+		if (entry._nr == BAD_INDEX) {
+			// New entry
+			entry._nr = static_cast<Index>(object.size()) - 1;
+		} else {
+			entry._accessed = true;
+		}
+		entry._value = std::move(config);
+	}
+
+	bool Config::erase(const std::string& key)
+	{
+		auto& object = as_object()._impl;
+		auto it = object.find(Key::lookup(key));
+		if (it == object.end()) {
+			return false;
+		} else {
+			object.erase(it);
+			return true;
+		}
+	}
+
+	bool Config::deep_eq(const Config& a, const Config& b)
+	{
+		if (a._type != b._type) { return false; }
+		if (a._type == Null)   { return true; }
+		if (a._type == Bool)   { return a._u.b    == b._u.b;    }
+		if (a._type == Int)    { return a._u.i    == b._u.i;    }
+		if (a._type == Float)  { return a._u.f    == b._u.f;    }
+		if (a._type == String) {
+			const size_t size = a.string_length();
+			return size == b.string_length() && memcmp(a.string_data(), b.string_data(), size) == 0;
+		}
+		if (a._type == Object)    {
+			if (a._u.object == b._u.object) { return true; }
+			auto&& a_object = a.as_object()._impl;
+			auto&& b_object = b.as_object()._impl;
+			if (a_object.size() != b_object.size()) { return false; }
+			for (auto&& p: a_object) {
+				auto it = b_object.find(p.first);
+				if (it == b_object.end()) { return false; }
+				if (!deep_eq(p.second._value, it->second._value)) { return false; }
+			}
+			return true;
+		}
+		if (a._type == Array)    {
+			if (a._u.array == b._u.array) { return true; }
+			auto&& a_array = a.as_array();
+			auto&& b_array = b.as_array();
+			if (a_array.size() != b_array.size()) { return false; }
+			for (size_t i=0; i<a_array.size(); ++i) {
+				if (!deep_eq(a_array[i], b_array[i])) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		return false;
+	}
+
+#if !CONFIGURU_VALUE_SEMANTICS
+	Config Config::deep_clone() const
+	{
+		Config ret = *this;
+		if (ret._type == Object) {
+			ret = Config::object(copy_resource(_u.object->_resource));
+			for (auto&& p : this->as_object()._impl) {
+				auto& dst = ret._u.object->_impl[p.first];
+				dst._nr    = p.second._nr;
+				dst._value = p.second._value.deep_clone();
+			}
+		}
+		if (ret._type == Array) {
+			ret = Config::array(copy_resource(_u.array->_resource));
+			for (auto&& value : this->as_array()) {
+				ret.push_back( value.deep_clone() );
+			}
+		}
+		return ret;
+	}
+#endif
+
+	void Config::visit_dangling(const std::function<void(const std::string& key, const Config& value)>& visitor) const
+	{
+		if (is_object()) {
+			for (auto&& p : as_object()._impl) {
+				auto&& entry = p.second;
+				auto&& value = entry._value;
+				if (entry._accessed) {
+					value.check_dangling();
+				} else {
+					visitor(p.first, value);
+				}
+			}
+		} else if (is_array()) {
+			for (auto&& e : as_array()) {
+				e.check_dangling();
+			}
+		}
+	}
+
+	void Config::check_dangling() const
+	{
+		std::string message = "";
+
+		visit_dangling([&](const std::string& key, const Config& value){
+			message += "\n    " + value.where() + "Key '" + key + "' never accessed.";
+		});
+
+		if (!message.empty()) {
+			message = "Dangling keys:" + message;
+			CONFIGURU_ON_DANGLING(message);
+		}
+	}
+
+	void Config::mark_accessed(bool v) const
+	{
+		// Don't parse lazy contents just to mark them:
+		if (is_object()) {
+			auto lock = lock_if_lazy(_u.object->_is_lazy, _u.object);
+			if (_u.object->_lazy) {
+				_u.object->_lazy_accessed = v;
+				return;
+			}
+		} else if (is_array()) {
+			auto lock = lock_if_lazy(_u.array->_is_lazy, _u.array);
+			if (_u.array->_lazy) {
+				_u.array->_lazy_accessed = v;
+				return;
+			}
+		}
+
+		if (is_object()) {
+			for (auto&& p : as_object()._impl) {
+				auto&& entry = p.second;
+				entry._accessed = v;
+				entry._value.mark_accessed(v);
+			}
+		} else if (is_array()) {
+			for (auto&& e : as_array()) {
+				e.mark_accessed(v);
+			}
+		}
+	}
+
+	MemoryResource* Config::memory_resource() const
+	{
+		if (_type == Object) { return _u.object->_resource; }
+		if (_type == Array)  { return _u.array->_resource;  }
+		if (_type == String && (_flags & InResource)) {
+			MemoryResource* resource;
+			memcpy(&resource, _u.str - sizeof(size_t) - sizeof(MemoryResource*), sizeof(MemoryResource*));
+			return resource;
+		}
+		return nullptr;
+	}
+
+	const char* Config::debug_descr() const
+	{
+		switch (_type) {
+			case Bool:   return _u.b ? "true" : "false";
+			case String: return string_data();
+			default:     return type_str(_type);
+		}
+	}
+
+	const char* Config::type_str(Type t)
+	{
+		switch (t) {
+			case Uninitialized: return "uninitialized";
+			case BadLookupType: return "undefined";
+			case Null:          return "null";
+			case Bool:          return "bool";
+			case Int:           return "integer";
+			case Float:         return "float";
+			case String:        return "string";
+			case Array:         return "array";
+			case Object:        return "object";
+		}
+		return "BROKEN Config";
+	}
+
+	std::string where_is(uint32_t doc_id, Index line)
+	{
+		if (auto doc = DocTable::find(doc_id)) {
+			std::string ret = doc->filename;
+			if (line != BAD_INDEX) {
+				ret += ":" + std::to_string(line);
+			}
+			doc->append_include_info(ret);
+			ret += ": ";
+			return ret;
+		} else if (line != BAD_INDEX) {
+			return "line " + std::to_string(line) + ": ";
+		} else {
+			return "";
+		}
+	}
+
+	std::string Config::where() const
+	{
+		return where_is(doc_id(), line());
+	}
+
+	void Config::on_error(const std::string& msg) const
+	{
+		CONFIGURU_ONERROR(where() + msg);
+		abort(); // We shouldn't get here.
+	}
+
+	void Config::assert_type(Type exepected) const
+	{
+		if (_type == BadLookupType) {
+			auto where = where_is(_u.bad_lookup->doc_id, _u.bad_lookup->line);
+			CONFIGURU_ONERROR(where + "Failed to find key '" + _u.bad_lookup->key + "'");
+		} else if (_type != exepected) {
+			const auto message = where() + "Expected " + type_str(exepected) + ", got " + type_str(_type);
+			if (_type == Uninitialized && exepected == Object) {
+				CONFIGURU_ONERROR(message + ". Did you forget to call Config::object()?");
+			} else if (_type == Uninitialized && exepected == Array) {
+				CONFIGURU_ONERROR(message + ". Did you forget to call Config::array()?");
+			} else {
+				CONFIGURU_ONERROR(message);
+			}
+		}
+	}
+
+	// ------------------------------------------------------------------------
+
+	FrozenBlock::~FrozenBlock()
+	{
+		for (uint16_t doc_id : doc_ids) {
+			DocTable::unpin(doc_id);
+		}
+	}
+
+	FrozenConfig Config::freeze() const
+	{
+		static_assert(sizeof(FrozenNode) == 16, "FrozenNode should be as small as a Config");
+
+		std::vector<FrozenNode>                   nodes;
+		std::vector<FrozenEntry>                  entries;
+		std::vector<uint32_t>                     slots;  // Two per entry.
+		std::string                               chars;
+		std::unordered_map<std::string, uint32_t> pooled; // Where in chars each distinct string is.
+		std::vector<uint16_t>                     doc_ids;
+
+		const auto index = [](size_t i) {
+			if (i >= 0xFFFFFFFFu) {
+				CONFIGURU_ONERROR("Config too large to freeze");
+			}
+			return static_cast<uint32_t>(i);
+		};
+
+		const auto pool = [&](const char* str, size_t size) {
+			auto it = pooled.find(std::string(str, size));
+			if (it == pooled.end()) {
+				it = pooled.emplace(std::string(str, size), index(chars.size())).first;
+				chars.append(str, size);
+				chars.push_back('\0');
+			}
+			return it->second;
+		};
+
+		const auto keep_doc = [&](uint16_t doc_id) {
+			if (doc_id != 0 && std::find(doc_ids.begin(), doc_ids.end(), doc_id) == doc_ids.end()) {
+				doc_ids.push_back(doc_id);
+			}
+		};
+
+		struct Member
+		{
+			const std::string* key;
+			const Config*      value;
+		};
+		std::vector<Member> members;
+
+		// Breadth-first: the values of each array/object are given the next indices in a row.
+		std::vector<const Config*> order { this };
+		for (size_t i = 0; i < order.size(); ++i) {
+			const Config& config = *order[i];
+			FrozenNode node = FrozenNode();
+			node.type = config._type == BadLookupType ? Uninitialized : config._type;
+			#if CONFIGURU_LOCATIONS
+				node.line   = config.line();
+				node.doc_id = config._doc_id;
+				keep_doc(config._doc_id);
+			#endif
+
+			switch (config._type) {
+				case Bool:  node.u.b = config._u.b; break;
+				case Int:   node.u.i = config._u.i; break;
+				case Float: node.u.f = config._u.f; break;
+				case String:
+					node.u.ref.offset = pool(config.string_data(), config.string_length());
+					node.u.ref.size   = index(config.string_length());
+					break;
+				case Array: {
+					const auto& array = config.as_array(); // Parses it if lazy
+					node.u.ref.offset = index(order.size());
+					node.u.ref.size   = index(array.size());
+					for (const Config& value : array) {
+						order.push_back(&value);
+					}
+					break;
+				}
+				case Object: {
+					const auto& object = config.as_object()._impl;
+					members.clear();
+					for (const auto& p : object) {
+						const std::string& key = p.first.str();
+						members.push_back(Member{&key, &p.second._value});
+					}
+					std::sort(members.begin(), members.end(), [](const Member& a, const Member& b) {
+						return *a.key < *b.key;
+					});
+					node.u.ref.offset = index(entries.size());
+					node.u.ref.size   = index(members.size());
+					const uint32_t num_slots = 2 * node.u.ref.size;
+					slots.resize(2 * entries.size() + num_slots);
+					uint32_t* index_slots = slots.data() + 2 * entries.size();
+					for (uint32_t m = 0; m < node.u.ref.size; ++m) {
+						const std::string& key = *members[m].key;
+						const uint32_t hash = FrozenValue::key_hash(key.data(), key.size());
+						uint32_t s = FrozenValue::first_slot(hash, num_slots);
+						while (index_slots[s] != 0) {
+							s = s + 1 == num_slots ? 0 : s + 1;
+						}
+						index_slots[s] = m + 1;
+						entries.push_back(FrozenEntry{hash, pool(key.data(), key.size()), index(key.size()), index(order.size())});
+						order.push_back(members[m].value);
+					}
+					break;
+				}
+				default: break;
+			}
+			nodes.push_back(node);
+		}
+
+		const size_t node_bytes  = nodes.size() * sizeof(FrozenNode);
+		const size_t entry_bytes = entries.size() * sizeof(FrozenEntry);
+		const size_t slot_bytes  = slots.size() * sizeof(uint32_t);
+
+		auto block = std::make_shared<FrozenBlock>();
+		block->memory.reset(new uint64_t[(node_bytes + entry_bytes + slot_bytes + chars.size() + 7) / 8]);
+		char* memory = reinterpret_cast<char*>(block->memory.get());
+		memcpy(memory, nodes.data(), node_bytes);
+		if (entry_bytes != 0) {
+			memcpy(memory + node_bytes, entries.data(), entry_bytes);
+			memcpy(memory + node_bytes + entry_bytes, slots.data(), slot_bytes);
+		}
+		if (!chars.empty()) {
+			memcpy(memory + node_bytes + entry_bytes + slot_bytes, chars.data(), chars.size());
+		}
+		block->nodes   = reinterpret_cast<const FrozenNode*>(memory);
+		block->entries = reinterpret_cast<const FrozenEntry*>(memory + node_bytes);
+		block->slots   = reinterpret_cast<const uint32_t*>(memory + node_bytes + entry_bytes);
+		block->chars   = memory + node_bytes + entry_bytes + slot_bytes;
+		for (uint16_t doc_id : doc_ids) {
+			DocTable::pin(doc_id);
+		}
+		block->doc_ids = std::move(doc_ids);
+		return FrozenConfig(std::move(block));
+	}
+
+	std::string FrozenValue::where() const
+	{
+		#if CONFIGURU_LOCATIONS
+			return where_is(_node->doc_id, _node->line);
+		#else
+			return "";
+		#endif
+	}
+
+	void FrozenValue::on_error(const std::string& msg) const
+	{
+		CONFIGURU_ONERROR(where() + msg);
+		abort(); // We shouldn't get here.
+	}
+
+	Config FrozenValue::to_config() const
+	{
+		Config ret;
+		switch (type()) {
+			case Config::Null:   ret = nullptr;                       break;
+			case Config::Bool:   ret = _node->u.b;                    break;
+			case Config::Int:    ret = _node->u.i;                    break;
+			case Config::Float:  ret = _node->u.f;                    break;
+			case Config::String: ret = Config(c_str(), string_size()); break;
+			case Config::Array:
+				ret = Config::array();
+				for (FrozenValue value : as_array()) {
+					ret.push_back(value.to_config());
+				}
+				break;
+			case Config::Object:
+				ret = Config::object();
+				for (const auto& p : as_object()) {
+					ret.emplace(p.key(), p.value().to_config());
+				}
+				break;
+			default: break;
+		}
+		#if CONFIGURU_LOCATIONS
+			if (_node->doc_id != 0 || _node->line != BAD_INDEX) {
+				ret.tag(DocTable::find(_node->doc_id), _node->line, 0);
+			}
+		#endif
+		return ret;
+	}
+
+	std::ostream& operator<<(std::ostream& os, const Config& cfg)
+	{
+		auto format = JSON;
+		// Make sure that all config types are serializable:
+		format.inf                 = true;
+		format.nan                 = true;
+		format.write_uninitialized = true;
+		format.end_with_newline    = false;
+		format.mark_accessed       = false;
+		return os << dump_string(cfg, format);
+	}
+}
+
+// ----------------------------------------------------------------------------
+// 88""Yb    db    88""Yb .dP"Y8 888888 88""Yb
+// 88__dP   dPYb   88__dP `Ybo." 88__   88__dP
+// 88"""   dP__Yb  88"Yb  o.`Y8b 88""   88"Yb
+// 88     dP""""Yb 88  Yb 8bodP' 888888 88  Yb
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <set>
+#include <system_error>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+	#define CONFIGURU_HAS_MMAP 1
+#else
+	#define CONFIGURU_HAS_MMAP 0
+#endif
+
+#if CONFIGURU_SIMD && defined(__AVX2__)
+	#include <immintrin.h>
+	#define CONFIGURU_SIMD_WIDTH 32
+#elif CONFIGURU_SIMD && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#include <emmintrin.h>
+	#define CONFIGURU_SIMD_WIDTH 16
+#else
+	#define CONFIGURU_SIMD_WIDTH 0
+#endif
+
+#if CONFIGURU_SIMD_WIDTH && defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+// Our aligned block loads may cover bytes past the end of the input, which AddressSanitizer would report.
+#if defined(__has_feature)
+	#if __has_feature(address_sanitizer)
+		#define CONFIGURU_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+	#endif
+#endif
+#if !defined(CONFIGURU_NO_SANITIZE_ADDRESS) && defined(__SANITIZE_ADDRESS__)
+	#define CONFIGURU_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#endif
+#ifndef CONFIGURU_NO_SANITIZE_ADDRESS
+	#define CONFIGURU_NO_SANITIZE_ADDRESS
+#endif
+
+namespace configuru
+{
+	void append(Comments& a, Comments&& b)
+	{
+		for (auto&& entry : b) {
+			a.emplace_back(std::move(entry));
+		}
+	}
+
+	bool ConfigComments::empty() const
+	{
+		return prefix.empty()
+			&& postfix.empty()
+			&& pre_end_brace.empty();
+	}
+
+	void ConfigComments::append(ConfigComments&& other)
+	{
+		configuru::append(this->prefix,        std::move(other.prefix));
+		configuru::append(this->postfix,       std::move(other.postfix));
+		configuru::append(this->pre_end_brace, std::move(other.pre_end_brace));
+	}
+
+	// Returns the number of bytes written, or 0 on error
+	size_t encode_utf8(std::string& dst, uint64_t c)
+	{
+		if (c <= 0x7F)  // 0XXX XXXX - one byte
+		{
+			dst += static_cast<char>(c);
+			return 1;
+		}
+		else if (c <= 0x7FF)  // 110X XXXX - two bytes
+		{
+			dst += static_cast<char>( 0xC0 | (c >> 6) );
+			dst += static_cast<char>( 0x80 | (c & 0x3F) );
+			return 2;
+		}
+		else if (c <= 0xFFFF)  // 1110 XXXX - three bytes
+		{
+			dst += static_cast<char>(0xE0 | (c >> 12));
+			dst += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+			dst += static_cast<char>(0x80 | (c & 0x3F));
+			return 3;
+		}
+		else if (c <= 0x1FFFFF)  // 1111 0XXX - four bytes
+		{
+			dst += static_cast<char>(0xF0 | (c >> 18));
+			dst += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+			dst += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+			dst += static_cast<char>(0x80 | (c & 0x3F));
+			return 4;
+		}
+		else if (c <= 0x3FFFFFF)  // 1111 10XX - five bytes
+		{
+			dst += static_cast<char>(0xF8 | (c >> 24));
+			dst += static_cast<char>(0x80 | (c >> 18));
+			dst += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+			dst += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+			dst += static_cast<char>(0x80 | (c & 0x3F));
+			return 5;
+		}
+		else if (c <= 0x7FFFFFFF)  // 1111 110X - six bytes
+		{
+			dst += static_cast<char>(0xFC | (c >> 30));
+			dst += static_cast<char>(0x80 | ((c >> 24) & 0x3F));
+			dst += static_cast<char>(0x80 | ((c >> 18) & 0x3F));
+			dst += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+			dst += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+			dst += static_cast<char>(0x80 | (c & 0x3F));
+			return 6;
+		}
+		else {
+			return 0; // Error
+		}
+	}
+
+	std::string quote(char c)
+	{
+		if (c == 0)    { return "<eof>";   }
+		if (c == ' ')  { return "<space>"; }
+		if (c == '\n') { return "'\\n'";   }
+		if (c == '\t') { return "'\\t'";   }
+		if (c == '\r') { return "'\\r'";   }
+		if (c == '\b') { return "'\\b'";   }
+		return std::string("'") + c + "'";
+	}
+
+	// ------------------------------------------------------------------------
+	// Scanning helpers.
+	// With CONFIGURU_SIMD these look at 16 (SSE2) or 32 (AVX2) bytes at a time.
+	// All loads are aligned, so a block never straddles a page boundary:
+	// we may read a few bytes past the terminating zero, but never outside the page it lives on.
+
+#if CONFIGURU_SIMD_WIDTH
+	inline unsigned lowest_bit_index(uint32_t mask)
+	{
+		#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward(&index, mask);
+			return static_cast<unsigned>(index);
+		#else
+			return static_cast<unsigned>(__builtin_ctz(mask));
+		#endif
+	}
+
+	struct SimdBlock
+	{
+	#if CONFIGURU_SIMD_WIDTH == 32
+		static const uint32_t ALL_BITS = 0xFFFFFFFFu;
+		__m256i bytes;
+
+		CONFIGURU_NO_SANITIZE_ADDRESS explicit SimdBlock(const char* aligned_ptr)
+			: bytes(_mm256_load_si256(reinterpret_cast<const __m256i*>(aligned_ptr))) {}
+
+		uint32_t eq(char c) const
+		{
+			return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(c))));
+		}
+	#else
+		static const uint32_t ALL_BITS = 0xFFFFu;
+		__m128i bytes;
+
+		CONFIGURU_NO_SANITIZE_ADDRESS explicit SimdBlock(const char* aligned_ptr)
+			: bytes(_mm_load_si128(reinterpret_cast<const __m128i*>(aligned_ptr))) {}
+
+		uint32_t eq(char c) const
+		{
+			return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(c))));
+		}
+	#endif
+	};
+
+	// Returns the first position in [p, end) where mask_of(block) has a bit set, or end if there is none.
+	// We only load blocks that start before end, so the input needs no padding.
+	template<typename MaskFunction>
+	const char* simd_find(const char* p, const char* end, const MaskFunction& mask_of)
+	{
+		if (p >= end) {
+			return end;
+		}
+		const auto misalignment = static_cast<unsigned>(reinterpret_cast<uintptr_t>(p) % CONFIGURU_SIMD_WIDTH);
+		const char* block = p - misalignment;
+		uint32_t mask = mask_of(SimdBlock(block)) >> misalignment;
+		if (mask != 0) {
+			const char* found = p + lowest_bit_index(mask);
+			return found < end ? found : end;
+		}
+		for (;;) {
+			block += CONFIGURU_SIMD_WIDTH;
+			if (block >= end) {
+				return end;
+			}
+			mask = mask_of(SimdBlock(block));
+			if (mask != 0) {
+				const char* found = block + lowest_bit_index(mask);
+				return found < end ? found : end;
+			}
+		}
+	}
+#endif // CONFIGURU_SIMD_WIDTH
+
+	// Number of consecutive c:s at the start of [p, end).
+	size_t count_run(const char* p, const char* end, char c)
+	{
+	#if CONFIGURU_SIMD_WIDTH
+		return static_cast<size_t>(simd_find(p, end, [c](const SimdBlock& b) {
+			return ~b.eq(c) & SimdBlock::ALL_BITS;
+		}) - p);
+	#else
+		const char* run_end = p;
+		while (run_end != end && *run_end == c) {
+			++run_end;
+		}
+		return static_cast<size_t>(run_end - p);
+	#endif
+	}
+
+#if CONFIGURU_SIMD_WIDTH
+	template<char C>
+	uint32_t eq_any(const SimdBlock& b) { return b.eq(C); }
+
+	template<char C, char D, char... Rest>
+	uint32_t eq_any(const SimdBlock& b) { return b.eq(C) | eq_any<D, Rest...>(b); }
+#else
+	template<char C>
+	bool is_any(char c) { return c == C; }
+
+	template<char C, char D, char... Rest>
+	bool is_any(char c) { return c == C || is_any<D, Rest...>(c); }
+#endif
+
+	// Returns a pointer to the first of the given characters in [p, end), or end if there is none.
+	// '\0' should be one of them, so that we stop at a zero byte in the input.
+	template<char... Chars>
+	const char* find_first_of(const char* p, const char* end)
+	{
+	#if CONFIGURU_SIMD_WIDTH
+		return simd_find(p, end, [](const SimdBlock& b) { return eq_any<Chars...>(b); });
+	#else
+		while (p != end && !is_any<Chars...>(*p)) {
+			++p;
+		}
+		return p;
+	#endif
+	}
+
+	// ------------------------------------------------------------------------
+	// Classifying 64 bytes at a time, one bit per byte (in the style of simdjson).
+
+	struct BlockMasks
+	{
+		uint64_t quote     = 0;
+		uint64_t backslash = 0;
+		uint64_t open      = 0; // [ or {
+		uint64_t close     = 0; // ] or }
+		uint64_t newline   = 0;
+		uint64_t zero      = 0;
+	};
+
+	inline unsigned popcount64(uint64_t mask)
+	{
+		#if defined(_MSC_VER)
+			return static_cast<unsigned>(__popcnt64(mask));
+		#else
+			return static_cast<unsigned>(__builtin_popcountll(mask));
+		#endif
+	}
+
+	inline unsigned lowest_bit_index64(uint64_t mask)
+	{
+		#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanForward64(&index, mask);
+			return static_cast<unsigned>(index);
+		#else
+			return static_cast<unsigned>(__builtin_ctzll(mask));
+		#endif
+	}
+
+	inline unsigned highest_bit_index64(uint64_t mask)
+	{
+		#if defined(_MSC_VER)
+			unsigned long index;
+			_BitScanReverse64(&index, mask);
+			return static_cast<unsigned>(index);
+		#else
+			return 63 - static_cast<unsigned>(__builtin_clzll(mask));
+		#endif
+	}
+
+	// The bytes of the 64-byte aligned block that are in [begin, end).
+	inline BlockMasks block_masks(const char* block, const char* begin, const char* end)
+	{
+		BlockMasks m;
+	#if CONFIGURU_SIMD_WIDTH
+		for (int i = 0; i < 64; i += CONFIGURU_SIMD_WIDTH) {
+			const SimdBlock b(block + i);
+			m.quote     |= static_cast<uint64_t>(b.eq('"'))  << i;
+			m.backslash |= static_cast<uint64_t>(b.eq('\\')) << i;
+			m.open      |= static_cast<uint64_t>(eq_any<'[', '{'>(b)) << i;
+			m.close     |= static_cast<uint64_t>(eq_any<']', '}'>(b)) << i;
+			m.newline   |= static_cast<uint64_t>(b.eq('\n')) << i;
+			m.zero      |= static_cast<uint64_t>(b.eq('\0')) << i;
+		}
+
+		uint64_t valid = ~uint64_t(0);
+		if (block < begin) {
+			valid <<= begin - block;
+		}
+		if (end - block < 64) {
+			valid &= ~(~uint64_t(0) << (end - block));
+		}
+		m.quote     &= valid;
+		m.backslash &= valid;
+		m.open      &= valid;
+		m.close     &= valid;
+		m.newline   &= valid;
+		m.zero      &= valid;
+	#else
+		const char* p    = std::max(block, begin);
+		const char* stop = std::min(block + 64, end);
+		for (; p < stop; ++p) {
+			const uint64_t bit = uint64_t(1) << (p - block);
+			switch (*p) {
+				case '"':  m.quote     |= bit; break;
+				case '\\': m.backslash |= bit; break;
+				case '[':
+				case '{':  m.open      |= bit; break;
+				case ']':
+				case '}':  m.close     |= bit; break;
+				case '\n': m.newline   |= bit; break;
+				case '\0': m.zero      |= bit; break;
+				default: break;
+			}
+		}
+	#endif
+		return m;
+	}
+
+	// The bytes that are escaped by a backslash.
+	// escape_first is 1 if the first byte is escaped, and is set for the next block.
+	inline uint64_t escaped_bytes(uint64_t backslash, uint64_t& escape_first)
+	{
+		uint64_t escaped = escape_first;
+		uint64_t escapers = backslash & ~escape_first;
+		escape_first = 0;
+		// Backslashes are rare, so we take them one at a time:
+		while (escapers != 0) {
+			const unsigned i = lowest_bit_index64(escapers);
+			if (i == 63) {
+				escape_first = 1;
+				break;
+			}
+			escaped |= uint64_t(2) << i;
+			escapers &= ~(uint64_t(3) << i); // The escaped byte is no escaper, even if it is a backslash
+		}
+		return escaped;
+	}
+
+	// Each bit set to the xor of itself and all lower bits.
+	// For quotes this is the bytes from an opening quote up to (but not including) its closing quote.
+	inline uint64_t prefix_xor(uint64_t mask)
+	{
+		mask ^= mask << 1;
+		mask ^= mask << 2;
+		mask ^= mask << 4;
+		mask ^= mask << 8;
+		mask ^= mask << 16;
+		mask ^= mask << 32;
+		return mask;
+	}
+
+	// Accumulates up to 19 decimal digits (which always fit in an uint64_t), eight at a time when possible.
+	// Returns the end of the digits. Any digits past the first 19 are skipped, but not accumulated.
+	inline const char* accumulate_decimal_digits(const char* p, const char* end, uint64_t* out_value)
+	{
+		const char* begin = p;
+		uint64_t value = 0;
+
+	#if CONFIGURU_SIMD_WIDTH
+		// x86 is little endian, so the first digit ends up in the lowest byte.
+		while (p - begin <= 19 - 8 && end - p >= 8) {
+			uint64_t chunk;
+			memcpy(&chunk, p, sizeof(chunk));
+			const uint64_t all_digits =
+				(chunk & 0xF0F0F0F0F0F0F0F0ull) |
+				(((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4);
+			if (all_digits != 0x3333333333333333ull) {
+				break;
+			}
+			chunk -= 0x3030303030303030ull;
+			chunk = (chunk * 10) + (chunk >> 8); // Pairs of digits
+			chunk = (((chunk & 0x000000FF000000FFull) * 0x000F424000000064ull) +
+			         (((chunk >> 16) & 0x000000FF000000FFull) * 0x0000271000000001ull)) >> 32;
+			value = value * 100000000 + static_cast<uint32_t>(chunk);
+			p += 8;
+		}
+	#endif
+
+		for (; p != end && '0' <= *p && *p <= '9'; ++p) {
+			if (p - begin < 19) {
+				value = 10 * value + static_cast<uint64_t>(*p - '0');
+			}
+		}
+
+		*out_value = value;
+		return p;
+	}
+
+	// ------------------------------------------------------------------------
+	// Locale independent decimal to double conversion.
+	// First Clinger's fast path, then Eisel-Lemire, and if neither can decide
+	// the rounding we fall back on exact (slow) arithmetic on a big decimal.
+	// This is the same strategy as Go's strconv.ParseFloat.
+
+	struct UInt128
+	{
+		uint64_t high;
+		uint64_t low;
+	};
+
+	inline UInt128 multiply_64x64(uint64_t a, uint64_t b)
+	{
+	#if defined(__SIZEOF_INT128__)
+		const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+		return { static_cast<uint64_t>(product >> 64), static_cast<uint64_t>(product) };
+	#else
+		const uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+		const uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+		const uint64_t lo_lo = a_lo * b_lo;
+		const uint64_t lo_hi = a_lo * b_hi;
+		const uint64_t hi_lo = a_hi * b_lo;
+		const uint64_t hi_hi = a_hi * b_hi;
+		const uint64_t cross = (lo_lo >> 32) + (lo_hi & 0xFFFFFFFFu) + hi_lo;
+		return { (cross >> 32) + (lo_hi >> 32) + hi_hi, (cross << 32) | (lo_lo & 0xFFFFFFFFu) };
+	#endif
+	}
+
+	inline int leading_zeros_64(uint64_t x)
+	{
+	#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_clzll(x);
+	#else
+		int n = 0;
+		while ((x & 0x8000000000000000ull) == 0) {
+			x <<= 1;
+			n += 1;
+		}
+		return n;
+	#endif
+	}
+
+	inline double double_from_bits(uint64_t bits)
+	{
+		double value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	// The powers of ten that are exactly representable as a double.
+	const double EXACT_POWERS_OF_TEN[] = {
+		1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+	};
+
+	const int POWERS_OF_TEN_128_MIN_EXP = -342;
+	const int POWERS_OF_TEN_128_MAX_EXP =  308;
+
+	// {high, low} 64 bits of 10^e, normalized so that the top bit is set, rounded down.
+	const uint64_t POWERS_OF_TEN_128[][2] = {
+		{0xeef453d6923bd65aull, 0x113faa2906a13b3full}, // 1e-342
+		{0x9558b4661b6565f8ull, 0x4ac7ca59a424c507ull}, // 1e-341
+		{0xbaaee17fa23ebf76ull, 0x5d79bcf00d2df649ull}, // 1e-340
+		{0xe95a99df8ace6f53ull, 0xf4d82c2c107973dcull}, // 1e-339
+		{0x91d8a02bb6c10594ull, 0x79071b9b8a4be869ull}, // 1e-338
+		{0xb64ec836a47146f9ull, 0x9748e2826cdee284ull}, // 1e-337
+		{0xe3e27a444d8d98b7ull, 0xfd1b1b2308169b25ull}, // 1e-336
+		{0x8e6d8c6ab0787f72ull, 0xfe30f0f5e50e20f7ull}, // 1e-335
+		{0xb208ef855c969f4full, 0xbdbd2d335e51a935ull}, // 1e-334
+		{0xde8b2b66b3bc4723ull, 0xad2c788035e61382ull}, // 1e-333
+		{0x8b16fb203055ac76ull, 0x4c3bcb5021afcc31ull}, // 1e-332
+		{0xaddcb9e83c6b1793ull, 0xdf4abe242a1bbf3dull}, // 1e-331
+		{0xd953e8624b85dd78ull, 0xd71d6dad34a2af0dull}, // 1e-330
+		{0x87d4713d6f33aa6bull, 0x8672648c40e5ad68ull}, // 1e-329
+		{0xa9c98d8ccb009506ull, 0x680efdaf511f18c2ull}, // 1e-328
+		{0xd43bf0effdc0ba48ull, 0x0212bd1b2566def2ull}, // 1e-327
+		{0x84a57695fe98746dull, 0x014bb630f7604b57ull}, // 1e-326
+		{0xa5ced43b7e3e9188ull, 0x419ea3bd35385e2dull}, // 1e-325
+		{0xcf42894a5dce35eaull, 0x52064cac828675b9ull}, // 1e-324
+		{0x818995ce7aa0e1b2ull, 0x7343efebd1940993ull}, // 1e-323
+		{0xa1ebfb4219491a1full, 0x1014ebe6c5f90bf8ull}, // 1e-322
+		{0xca66fa129f9b60a6ull, 0xd41a26e077774ef6ull}, // 1e-321
+		{0xfd00b897478238d0ull, 0x8920b098955522b4ull}, // 1e-320
+		{0x9e20735e8cb16382ull, 0x55b46e5f5d5535b0ull}, // 1e-319
+		{0xc5a890362fddbc62ull, 0xeb2189f734aa831dull}, // 1e-318
+		{0xf712b443bbd52b7bull, 0xa5e9ec7501d523e4ull}, // 1e-317
+		{0x9a6bb0aa55653b2dull, 0x47b233c92125366eull}, // 1e-316
+		{0xc1069cd4eabe89f8ull, 0x999ec0bb696e840aull}, // 1e-315
+		{0xf148440a256e2c76ull, 0xc00670ea43ca250dull}, // 1e-314
+		{0x96cd2a865764dbcaull, 0x380406926a5e5728ull}, // 1e-313
+		{0xbc807527ed3e12bcull, 0xc605083704f5ecf2ull}, // 1e-312
+		{0xeba09271e88d976bull, 0xf7864a44c633682eull}, // 1e-311
+		{0x93445b8731587ea3ull, 0x7ab3ee6afbe0211dull}, // 1e-310
+		{0xb8157268fdae9e4cull, 0x5960ea05bad82964ull}, // 1e-309
+		{0xe61acf033d1a45dfull, 0x6fb92487298e33bdull}, // 1e-308
+		{0x8fd0c16206306babull, 0xa5d3b6d479f8e056ull}, // 1e-307
+		{0xb3c4f1ba87bc8696ull, 0x8f48a4899877186cull}, // 1e-306
+		{0xe0b62e2929aba83cull, 0x331acdabfe94de87ull}, // 1e-305
+		{0x8c71dcd9ba0b4925ull, 0x9ff0c08b7f1d0b14ull}, // 1e-304
+		{0xaf8e5410288e1b6full, 0x07ecf0ae5ee44dd9ull}, // 1e-303
+		{0xdb71e91432b1a24aull, 0xc9e82cd9f69d6150ull}, // 1e-302
+		{0x892731ac9faf056eull, 0xbe311c083a225cd2ull}, // 1e-301
+		{0xab70fe17c79ac6caull, 0x6dbd630a48aaf406ull}, // 1e-300
+		{0xd64d3d9db981787dull, 0x092cbbccdad5b108ull}, // 1e-299
+		{0x85f0468293f0eb4eull, 0x25bbf56008c58ea5ull}, // 1e-298
+		{0xa76c582338ed2621ull, 0xaf2af2b80af6f24eull}, // 1e-297
+		{0xd1476e2c07286faaull, 0x1af5af660db4aee1ull}, // 1e-296
+		{0x82cca4db847945caull, 0x50d98d9fc890ed4dull}, // 1e-295
+		{0xa37fce126597973cull, 0xe50ff107bab528a0ull}, // 1e-294
+		{0xcc5fc196fefd7d0cull, 0x1e53ed49a96272c8ull}, // 1e-293
+		{0xff77b1fcbebcdc4full, 0x25e8e89c13bb0f7aull}, // 1e-292
+		{0x9faacf3df73609b1ull, 0x77b191618c54e9acull}, // 1e-291
+		{0xc795830d75038c1dull, 0xd59df5b9ef6a2417ull}, // 1e-290
+		{0xf97ae3d0d2446f25ull, 0x4b0573286b44ad1dull}, // 1e-289
+		{0x9becce62836ac577ull, 0x4ee367f9430aec32ull}, // 1e-288
+		{0xc2e801fb244576d5ull, 0x229c41f793cda73full}, // 1e-287
+		{0xf3a20279ed56d48aull, 0x6b43527578c1110full}, // 1e-286
+		{0x9845418c345644d6ull, 0x830a13896b78aaa9ull}, // 1e-285
+		{0xbe5691ef416bd60cull, 0x23cc986bc656d553ull}, // 1e-284
+		{0xedec366b11c6cb8full, 0x2cbfbe86b7ec8aa8ull}, // 1e-283
+		{0x94b3a202eb1c3f39ull, 0x7bf7d71432f3d6a9ull}, // 1e-282
+		{0xb9e08a83a5e34f07ull, 0xdaf5ccd93fb0cc53ull}, // 1e-281
+		{0xe858ad248f5c22c9ull, 0xd1b3400f8f9cff68ull}, // 1e-280
+		{0x91376c36d99995beull, 0x23100809b9c21fa1ull}, // 1e-279
+		{0xb58547448ffffb2dull, 0xabd40a0c2832a78aull}, // 1e-278
+		{0xe2e69915b3fff9f9ull, 0x16c90c8f323f516cull}, // 1e-277
+		{0x8dd01fad907ffc3bull, 0xae3da7d97f6792e3ull}, // 1e-276
+		{0xb1442798f49ffb4aull, 0x99cd11cfdf41779cull}, // 1e-275
+		{0xdd95317f31c7fa1dull, 0x40405643d711d583ull}, // 1e-274
+		{0x8a7d3eef7f1cfc52ull, 0x482835ea666b2572ull}, // 1e-273
+		{0xad1c8eab5ee43b66ull, 0xda3243650005eecfull}, // 1e-272
+		{0xd863b256369d4a40ull, 0x90bed43e40076a82ull}, // 1e-271
+		{0x873e4f75e2224e68ull, 0x5a7744a6e804a291ull}, // 1e-270
+		{0xa90de3535aaae202ull, 0x711515d0a205cb36ull}, // 1e-269
+		{0xd3515c2831559a83ull, 0x0d5a5b44ca873e03ull}, // 1e-268
+		{0x8412d9991ed58091ull, 0xe858790afe9486c2ull}, // 1e-267
+		{0xa5178fff668ae0b6ull, 0x626e974dbe39a872ull}, // 1e-266
+		{0xce5d73ff402d98e3ull, 0xfb0a3d212dc8128full}, // 1e-265
+		{0x80fa687f881c7f8eull, 0x7ce66634bc9d0b99ull}, // 1e-264
+		{0xa139029f6a239f72ull, 0x1c1fffc1ebc44e80ull}, // 1e-263
+		{0xc987434744ac874eull, 0xa327ffb266b56220ull}, // 1e-262
+		{0xfbe9141915d7a922ull, 0x4bf1ff9f0062baa8ull}, // 1e-261
+		{0x9d71ac8fada6c9b5ull, 0x6f773fc3603db4a9ull}, // 1e-260
+		{0xc4ce17b399107c22ull, 0xcb550fb4384d21d3ull}, // 1e-259
+		{0xf6019da07f549b2bull, 0x7e2a53a146606a48ull}, // 1e-258
+		{0x99c102844f94e0fbull, 0x2eda7444cbfc426dull}, // 1e-257
+		{0xc0314325637a1939ull, 0xfa911155fefb5308ull}, // 1e-256
+		{0xf03d93eebc589f88ull, 0x793555ab7eba27caull}, // 1e-255
+		{0x96267c7535b763b5ull, 0x4bc1558b2f3458deull}, // 1e-254
+		{0xbbb01b9283253ca2ull, 0x9eb1aaedfb016f16ull}, // 1e-253
+		{0xea9c227723ee8bcbull, 0x465e15a979c1cadcull}, // 1e-252
+		{0x92a1958a7675175full, 0x0bfacd89ec191ec9ull}, // 1e-251
+		{0xb749faed14125d36ull, 0xcef980ec671f667bull}, // 1e-250
+		{0xe51c79a85916f484ull, 0x82b7e12780e7401aull}, // 1e-249
+		{0x8f31cc0937ae58d2ull, 0xd1b2ecb8b0908810ull}, // 1e-248
+		{0xb2fe3f0b8599ef07ull, 0x861fa7e6dcb4aa15ull}, // 1e-247
+		{0xdfbdcece67006ac9ull, 0x67a791e093e1d49aull}, // 1e-246
+		{0x8bd6a141006042bdull, 0xe0c8bb2c5c6d24e0ull}, // 1e-245
+		{0xaecc49914078536dull, 0x58fae9f773886e18ull}, // 1e-244
+		{0xda7f5bf590966848ull, 0xaf39a475506a899eull}, // 1e-243
+		{0x888f99797a5e012dull, 0x6d8406c952429603ull}, // 1e-242
+		{0xaab37fd7d8f58178ull, 0xc8e5087ba6d33b83ull}, // 1e-241
+		{0xd5605fcdcf32e1d6ull, 0xfb1e4a9a90880a64ull}, // 1e-240
+		{0x855c3be0a17fcd26ull, 0x5cf2eea09a55067full}, // 1e-239
+		{0xa6b34ad8c9dfc06full, 0xf42faa48c0ea481eull}, // 1e-238
+		{0xd0601d8efc57b08bull, 0xf13b94daf124da26ull}, // 1e-237
+		{0x823c12795db6ce57ull, 0x76c53d08d6b70858ull}, // 1e-236
+		{0xa2cb1717b52481edull, 0x54768c4b0c64ca6eull}, // 1e-235
+		{0xcb7ddcdda26da268ull, 0xa9942f5dcf7dfd09ull}, // 1e-234
+		{0xfe5d54150b090b02ull, 0xd3f93b35435d7c4cull}, // 1e-233
+		{0x9efa548d26e5a6e1ull, 0xc47bc5014a1a6dafull}, // 1e-232
+		{0xc6b8e9b0709f109aull, 0x359ab6419ca1091bull}, // 1e-231
+		{0xf867241c8cc6d4c0ull, 0xc30163d203c94b62ull}, // 1e-230
+		{0x9b407691d7fc44f8ull, 0x79e0de63425dcf1dull}, // 1e-229
+		{0xc21094364dfb5636ull, 0x985915fc12f542e4ull}, // 1e-228
+		{0xf294b943e17a2bc4ull, 0x3e6f5b7b17b2939dull}, // 1e-227
+		{0x979cf3ca6cec5b5aull, 0xa705992ceecf9c42ull}, // 1e-226
+		{0xbd8430bd08277231ull, 0x50c6ff782a838353ull}, // 1e-225
+		{0xece53cec4a314ebdull, 0xa4f8bf5635246428ull}, // 1e-224
+		{0x940f4613ae5ed136ull, 0x871b7795e136be99ull}, // 1e-223
+		{0xb913179899f68584ull, 0x28e2557b59846e3full}, // 1e-222
+		{0xe757dd7ec07426e5ull, 0x331aeada2fe589cfull}, // 1e-221
+		{0x9096ea6f3848984full, 0x3ff0d2c85def7621ull}, // 1e-220
+		{0xb4bca50b065abe63ull, 0x0fed077a756b53a9ull}, // 1e-219
+		{0xe1ebce4dc7f16dfbull, 0xd3e8495912c62894ull}, // 1e-218
+		{0x8d3360f09cf6e4bdull, 0x64712dd7abbbd95cull}, // 1e-217
+		{0xb080392cc4349decull, 0xbd8d794d96aacfb3ull}, // 1e-216
+		{0xdca04777f541c567ull, 0xecf0d7a0fc5583a0ull}, // 1e-215
+		{0x89e42caaf9491b60ull, 0xf41686c49db57244ull}, // 1e-214
+		{0xac5d37d5b79b6239ull, 0x311c2875c522ced5ull}, // 1e-213
+		{0xd77485cb25823ac7ull, 0x7d633293366b828bull}, // 1e-212
+		{0x86a8d39ef77164bcull, 0xae5dff9c02033197ull}, // 1e-211
+		{0xa8530886b54dbdebull, 0xd9f57f830283fdfcull}, // 1e-210
+		{0xd267caa862a12d66ull, 0xd072df63c324fd7bull}, // 1e-209
+		{0x8380dea93da4bc60ull, 0x4247cb9e59f71e6dull}, // 1e-208
+		{0xa46116538d0deb78ull, 0x52d9be85f074e608ull}, // 1e-207
+		{0xcd795be870516656ull, 0x67902e276c921f8bull}, // 1e-206
+		{0x806bd9714632dff6ull, 0x00ba1cd8a3db53b6ull}, // 1e-205
+		{0xa086cfcd97bf97f3ull, 0x80e8a40eccd228a4ull}, // 1e-204
+		{0xc8a883c0fdaf7df0ull, 0x6122cd128006b2cdull}, // 1e-203
+		{0xfad2a4b13d1b5d6cull, 0x796b805720085f81ull}, // 1e-202
+		{0x9cc3a6eec6311a63ull, 0xcbe3303674053bb0ull}, // 1e-201
+		{0xc3f490aa77bd60fcull, 0xbedbfc4411068a9cull}, // 1e-200
+		{0xf4f1b4d515acb93bull, 0xee92fb5515482d44ull}, // 1e-199
+		{0x991711052d8bf3c5ull, 0x751bdd152d4d1c4aull}, // 1e-198
+		{0xbf5cd54678eef0b6ull, 0xd262d45a78a0635dull}, // 1e-197
+		{0xef340a98172aace4ull, 0x86fb897116c87c34ull}, // 1e-196
+		{0x9580869f0e7aac0eull, 0xd45d35e6ae3d4da0ull}, // 1e-195
+		{0xbae0a846d2195712ull, 0x8974836059cca109ull}, // 1e-194
+		{0xe998d258869facd7ull, 0x2bd1a438703fc94bull}, // 1e-193
+		{0x91ff83775423cc06ull, 0x7b6306a34627ddcfull}, // 1e-192
+		{0xb67f6455292cbf08ull, 0x1a3bc84c17b1d542ull}, // 1e-191
+		{0xe41f3d6a7377eecaull, 0x20caba5f1d9e4a93ull}, // 1e-190
+		{0x8e938662882af53eull, 0x547eb47b7282ee9cull}, // 1e-189
+		{0xb23867fb2a35b28dull, 0xe99e619a4f23aa43ull}, // 1e-188
+		{0xdec681f9f4c31f31ull, 0x6405fa00e2ec94d4ull}, // 1e-187
+		{0x8b3c113c38f9f37eull, 0xde83bc408dd3dd04ull}, // 1e-186
+		{0xae0b158b4738705eull, 0x9624ab50b148d445ull}, // 1e-185
+		{0xd98ddaee19068c76ull, 0x3badd624dd9b0957ull}, // 1e-184
+		{0x87f8a8d4cfa417c9ull, 0xe54ca5d70a80e5d6ull}, // 1e-183
+		{0xa9f6d30a038d1dbcull, 0x5e9fcf4ccd211f4cull}, // 1e-182
+		{0xd47487cc8470652bull, 0x7647c3200069671full}, // 1e-181
+		{0x84c8d4dfd2c63f3bull, 0x29ecd9f40041e073ull}, // 1e-180
+		{0xa5fb0a17c777cf09ull, 0xf468107100525890ull}, // 1e-179
+		{0xcf79cc9db955c2ccull, 0x7182148d4066eeb4ull}, // 1e-178
+		{0x81ac1fe293d599bfull, 0xc6f14cd848405530ull}, // 1e-177
+		{0xa21727db38cb002full, 0xb8ada00e5a506a7cull}, // 1e-176
+		{0xca9cf1d206fdc03bull, 0xa6d90811f0e4851cull}, // 1e-175
+		{0xfd442e4688bd304aull, 0x908f4a166d1da663ull}, // 1e-174
+		{0x9e4a9cec15763e2eull, 0x9a598e4e043287feull}, // 1e-173
+		{0xc5dd44271ad3cdbaull, 0x40eff1e1853f29fdull}, // 1e-172
+		{0xf7549530e188c128ull, 0xd12bee59e68ef47cull}, // 1e-171
+		{0x9a94dd3e8cf578b9ull, 0x82bb74f8301958ceull}, // 1e-170
+		{0xc13a148e3032d6e7ull, 0xe36a52363c1faf01ull}, // 1e-169
+		{0xf18899b1bc3f8ca1ull, 0xdc44e6c3cb279ac1ull}, // 1e-168
+		{0x96f5600f15a7b7e5ull, 0x29ab103a5ef8c0b9ull}, // 1e-167
+		{0xbcb2b812db11a5deull, 0x7415d448f6b6f0e7ull}, // 1e-166
+		{0xebdf661791d60f56ull, 0x111b495b3464ad21ull}, // 1e-165
+		{0x936b9fcebb25c995ull, 0xcab10dd900beec34ull}, // 1e-164
+		{0xb84687c269ef3bfbull, 0x3d5d514f40eea742ull}, // 1e-163
+		{0xe65829b3046b0afaull, 0x0cb4a5a3112a5112ull}, // 1e-162
+		{0x8ff71a0fe2c2e6dcull, 0x47f0e785eaba72abull}, // 1e-161
+		{0xb3f4e093db73a093ull, 0x59ed216765690f56ull}, // 1e-160
+		{0xe0f218b8d25088b8ull, 0x306869c13ec3532cull}, // 1e-159
+		{0x8c974f7383725573ull, 0x1e414218c73a13fbull}, // 1e-158
+		{0xafbd2350644eeacfull, 0xe5d1929ef90898faull}, // 1e-157
+		{0xdbac6c247d62a583ull, 0xdf45f746b74abf39ull}, // 1e-156
+		{0x894bc396ce5da772ull, 0x6b8bba8c328eb783ull}, // 1e-155
+		{0xab9eb47c81f5114full, 0x066ea92f3f326564ull}, // 1e-154
+		{0xd686619ba27255a2ull, 0xc80a537b0efefebdull}, // 1e-153
+		{0x8613fd0145877585ull, 0xbd06742ce95f5f36ull}, // 1e-152
+		{0xa798fc4196e952e7ull, 0x2c48113823b73704ull}, // 1e-151
+		{0xd17f3b51fca3a7a0ull, 0xf75a15862ca504c5ull}, // 1e-150
+		{0x82ef85133de648c4ull, 0x9a984d73dbe722fbull}, // 1e-149
+		{0xa3ab66580d5fdaf5ull, 0xc13e60d0d2e0ebbaull}, // 1e-148
+		{0xcc963fee10b7d1b3ull, 0x318df905079926a8ull}, // 1e-147
+		{0xffbbcfe994e5c61full, 0xfdf17746497f7052ull}, // 1e-146
+		{0x9fd561f1fd0f9bd3ull, 0xfeb6ea8bedefa633ull}, // 1e-145
+		{0xc7caba6e7c5382c8ull, 0xfe64a52ee96b8fc0ull}, // 1e-144
+		{0xf9bd690a1b68637bull, 0x3dfdce7aa3c673b0ull}, // 1e-143
+		{0x9c1661a651213e2dull, 0x06bea10ca65c084eull}, // 1e-142
+		{0xc31bfa0fe5698db8ull, 0x486e494fcff30a62ull}, // 1e-141
+		{0xf3e2f893dec3f126ull, 0x5a89dba3c3efccfaull}, // 1e-140
+		{0x986ddb5c6b3a76b7ull, 0xf89629465a75e01cull}, // 1e-139
+		{0xbe89523386091465ull, 0xf6bbb397f1135823ull}, // 1e-138
+		{0xee2ba6c0678b597full, 0x746aa07ded582e2cull}, // 1e-137
+		{0x94db483840b717efull, 0xa8c2a44eb4571cdcull}, // 1e-136
+		{0xba121a4650e4ddebull, 0x92f34d62616ce413ull}, // 1e-135
+		{0xe896a0d7e51e1566ull, 0x77b020baf9c81d17ull}, // 1e-134
+		{0x915e2486ef32cd60ull, 0x0ace1474dc1d122eull}, // 1e-133
+		{0xb5b5ada8aaff80b8ull, 0x0d819992132456baull}, // 1e-132
+		{0xe3231912d5bf60e6ull, 0x10e1fff697ed6c69ull}, // 1e-131
+		{0x8df5efabc5979c8full, 0xca8d3ffa1ef463c1ull}, // 1e-130
+		{0xb1736b96b6fd83b3ull, 0xbd308ff8a6b17cb2ull}, // 1e-129
+		{0xddd0467c64bce4a0ull, 0xac7cb3f6d05ddbdeull}, // 1e-128
+		{0x8aa22c0dbef60ee4ull, 0x6bcdf07a423aa96bull}, // 1e-127
+		{0xad4ab7112eb3929dull, 0x86c16c98d2c953c6ull}, // 1e-126
+		{0xd89d64d57a607744ull, 0xe871c7bf077ba8b7ull}, // 1e-125
+		{0x87625f056c7c4a8bull, 0x11471cd764ad4972ull}, // 1e-124
+		{0xa93af6c6c79b5d2dull, 0xd598e40d3dd89bcfull}, // 1e-123
+		{0xd389b47879823479ull, 0x4aff1d108d4ec2c3ull}, // 1e-122
+		{0x843610cb4bf160cbull, 0xcedf722a585139baull}, // 1e-121
+		{0xa54394fe1eedb8feull, 0xc2974eb4ee658828ull}, // 1e-120
+		{0xce947a3da6a9273eull, 0x733d226229feea32ull}, // 1e-119
+		{0x811ccc668829b887ull, 0x0806357d5a3f525full}, // 1e-118
+		{0xa163ff802a3426a8ull, 0xca07c2dcb0cf26f7ull}, // 1e-117
+		{0xc9bcff6034c13052ull, 0xfc89b393dd02f0b5ull}, // 1e-116
+		{0xfc2c3f3841f17c67ull, 0xbbac2078d443ace2ull}, // 1e-115
+		{0x9d9ba7832936edc0ull, 0xd54b944b84aa4c0dull}, // 1e-114
+		{0xc5029163f384a931ull, 0x0a9e795e65d4df11ull}, // 1e-113
+		{0xf64335bcf065d37dull, 0x4d4617b5ff4a16d5ull}, // 1e-112
+		{0x99ea0196163fa42eull, 0x504bced1bf8e4e45ull}, // 1e-111
+		{0xc06481fb9bcf8d39ull, 0xe45ec2862f71e1d6ull}, // 1e-110
+		{0xf07da27a82c37088ull, 0x5d767327bb4e5a4cull}, // 1e-109
+		{0x964e858c91ba2655ull, 0x3a6a07f8d510f86full}, // 1e-108
+		{0xbbe226efb628afeaull, 0x890489f70a55368bull}, // 1e-107
+		{0xeadab0aba3b2dbe5ull, 0x2b45ac74ccea842eull}, // 1e-106
+		{0x92c8ae6b464fc96full, 0x3b0b8bc90012929dull}, // 1e-105
+		{0xb77ada0617e3bbcbull, 0x09ce6ebb40173744ull}, // 1e-104
+		{0xe55990879ddcaabdull, 0xcc420a6a101d0515ull}, // 1e-103
+		{0x8f57fa54c2a9eab6ull, 0x9fa946824a12232dull}, // 1e-102
+		{0xb32df8e9f3546564ull, 0x47939822dc96abf9ull}, // 1e-101
+		{0xdff9772470297ebdull, 0x59787e2b93bc56f7ull}, // 1e-100
+		{0x8bfbea76c619ef36ull, 0x57eb4edb3c55b65aull}, // 1e-99
+		{0xaefae51477a06b03ull, 0xede622920b6b23f1ull}, // 1e-98
+		{0xdab99e59958885c4ull, 0xe95fab368e45ecedull}, // 1e-97
+		{0x88b402f7fd75539bull, 0x11dbcb0218ebb414ull}, // 1e-96
+		{0xaae103b5fcd2a881ull, 0xd652bdc29f26a119ull}, // 1e-95
+		{0xd59944a37c0752a2ull, 0x4be76d3346f0495full}, // 1e-94
+		{0x857fcae62d8493a5ull, 0x6f70a4400c562ddbull}, // 1e-93
+		{0xa6dfbd9fb8e5b88eull, 0xcb4ccd500f6bb952ull}, // 1e-92
+		{0xd097ad07a71f26b2ull, 0x7e2000a41346a7a7ull}, // 1e-91
+		{0x825ecc24c873782full, 0x8ed400668c0c28c8ull}, // 1e-90
+		{0xa2f67f2dfa90563bull, 0x728900802f0f32faull}, // 1e-89
+		{0xcbb41ef979346bcaull, 0x4f2b40a03ad2ffb9ull}, // 1e-88
+		{0xfea126b7d78186bcull, 0xe2f610c84987bfa8ull}, // 1e-87
+		{0x9f24b832e6b0f436ull, 0x0dd9ca7d2df4d7c9ull}, // 1e-86
+		{0xc6ede63fa05d3143ull, 0x91503d1c79720dbbull}, // 1e-85
+		{0xf8a95fcf88747d94ull, 0x75a44c6397ce912aull}, // 1e-84
+		{0x9b69dbe1b548ce7cull, 0xc986afbe3ee11abaull}, // 1e-83
+		{0xc24452da229b021bull, 0xfbe85badce996168ull}, // 1e-82
+		{0xf2d56790ab41c2a2ull, 0xfae27299423fb9c3ull}, // 1e-81
+		{0x97c560ba6b0919a5ull, 0xdccd879fc967d41aull}, // 1e-80
+		{0xbdb6b8e905cb600full, 0x5400e987bbc1c920ull}, // 1e-79
+		{0xed246723473e3813ull, 0x290123e9aab23b68ull}, // 1e-78
+		{0x9436c0760c86e30bull, 0xf9a0b6720aaf6521ull}, // 1e-77
+		{0xb94470938fa89bceull, 0xf808e40e8d5b3e69ull}, // 1e-76
+		{0xe7958cb87392c2c2ull, 0xb60b1d1230b20e04ull}, // 1e-75
+		{0x90bd77f3483bb9b9ull, 0xb1c6f22b5e6f48c2ull}, // 1e-74
+		{0xb4ecd5f01a4aa828ull, 0x1e38aeb6360b1af3ull}, // 1e-73
+		{0xe2280b6c20dd5232ull, 0x25c6da63c38de1b0ull}, // 1e-72
+		{0x8d590723948a535full, 0x579c487e5a38ad0eull}, // 1e-71
+		{0xb0af48ec79ace837ull, 0x2d835a9df0c6d851ull}, // 1e-70
+		{0xdcdb1b2798182244ull, 0xf8e431456cf88e65ull}, // 1e-69
+		{0x8a08f0f8bf0f156bull, 0x1b8e9ecb641b58ffull}, // 1e-68
+		{0xac8b2d36eed2dac5ull, 0xe272467e3d222f3full}, // 1e-67
+		{0xd7adf884aa879177ull, 0x5b0ed81dcc6abb0full}, // 1e-66
+		{0x86ccbb52ea94baeaull, 0x98e947129fc2b4e9ull}, // 1e-65
+		{0xa87fea27a539e9a5ull, 0x3f2398d747b36224ull}, // 1e-64
+		{0xd29fe4b18e88640eull, 0x8eec7f0d19a03aadull}, // 1e-63
+		{0x83a3eeeef9153e89ull, 0x1953cf68300424acull}, // 1e-62
+		{0xa48ceaaab75a8e2bull, 0x5fa8c3423c052dd7ull}, // 1e-61
+		{0xcdb02555653131b6ull, 0x3792f412cb06794dull}, // 1e-60
+		{0x808e17555f3ebf11ull, 0xe2bbd88bbee40bd0ull}, // 1e-59
+		{0xa0b19d2ab70e6ed6ull, 0x5b6aceaeae9d0ec4ull}, // 1e-58
+		{0xc8de047564d20a8bull, 0xf245825a5a445275ull}, // 1e-57
+		{0xfb158592be068d2eull, 0xeed6e2f0f0d56712ull}, // 1e-56
+		{0x9ced737bb6c4183dull, 0x55464dd69685606bull}, // 1e-55
+		{0xc428d05aa4751e4cull, 0xaa97e14c3c26b886ull}, // 1e-54
+		{0xf53304714d9265dfull, 0xd53dd99f4b3066a8ull}, // 1e-53
+		{0x993fe2c6d07b7fabull, 0xe546a8038efe4029ull}, // 1e-52
+		{0xbf8fdb78849a5f96ull, 0xde98520472bdd033ull}, // 1e-51
+		{0xef73d256a5c0f77cull, 0x963e66858f6d4440ull}, // 1e-50
+		{0x95a8637627989aadull, 0xdde7001379a44aa8ull}, // 1e-49
+		{0xbb127c53b17ec159ull, 0x5560c018580d5d52ull}, // 1e-48
+		{0xe9d71b689dde71afull, 0xaab8f01e6e10b4a6ull}, // 1e-47
+		{0x9226712162ab070dull, 0xcab3961304ca70e8ull}, // 1e-46
+		{0xb6b00d69bb55c8d1ull, 0x3d607b97c5fd0d22ull}, // 1e-45
+		{0xe45c10c42a2b3b05ull, 0x8cb89a7db77c506aull}, // 1e-44
+		{0x8eb98a7a9a5b04e3ull, 0x77f3608e92adb242ull}, // 1e-43
+		{0xb267ed1940f1c61cull, 0x55f038b237591ed3ull}, // 1e-42
+		{0xdf01e85f912e37a3ull, 0x6b6c46dec52f6688ull}, // 1e-41
+		{0x8b61313bbabce2c6ull, 0x2323ac4b3b3da015ull}, // 1e-40
+		{0xae397d8aa96c1b77ull, 0xabec975e0a0d081aull}, // 1e-39
+		{0xd9c7dced53c72255ull, 0x96e7bd358c904a21ull}, // 1e-38
+		{0x881cea14545c7575ull, 0x7e50d64177da2e54ull}, // 1e-37
+		{0xaa242499697392d2ull, 0xdde50bd1d5d0b9e9ull}, // 1e-36
+		{0xd4ad2dbfc3d07787ull, 0x955e4ec64b44e864ull}, // 1e-35
+		{0x84ec3c97da624ab4ull, 0xbd5af13bef0b113eull}, // 1e-34
+		{0xa6274bbdd0fadd61ull, 0xecb1ad8aeacdd58eull}, // 1e-33
+		{0xcfb11ead453994baull, 0x67de18eda5814af2ull}, // 1e-32
+		{0x81ceb32c4b43fcf4ull, 0x80eacf948770ced7ull}, // 1e-31
+		{0xa2425ff75e14fc31ull, 0xa1258379a94d028dull}, // 1e-30
+		{0xcad2f7f5359a3b3eull, 0x096ee45813a04330ull}, // 1e-29
+		{0xfd87b5f28300ca0dull, 0x8bca9d6e188853fcull}, // 1e-28
+		{0x9e74d1b791e07e48ull, 0x775ea264cf55347dull}, // 1e-27
+		{0xc612062576589ddaull, 0x95364afe032a819dull}, // 1e-26
+		{0xf79687aed3eec551ull, 0x3a83ddbd83f52204ull}, // 1e-25
+		{0x9abe14cd44753b52ull, 0xc4926a9672793542ull}, // 1e-24
+		{0xc16d9a0095928a27ull, 0x75b7053c0f178293ull}, // 1e-23
+		{0xf1c90080baf72cb1ull, 0x5324c68b12dd6338ull}, // 1e-22
+		{0x971da05074da7beeull, 0xd3f6fc16ebca5e03ull}, // 1e-21
+		{0xbce5086492111aeaull, 0x88f4bb1ca6bcf584ull}, // 1e-20
+		{0xec1e4a7db69561a5ull, 0x2b31e9e3d06c32e5ull}, // 1e-19
+		{0x9392ee8e921d5d07ull, 0x3aff322e62439fcfull}, // 1e-18
+		{0xb877aa3236a4b449ull, 0x09befeb9fad487c2ull}, // 1e-17
+		{0xe69594bec44de15bull, 0x4c2ebe687989a9b3ull}, // 1e-16
+		{0x901d7cf73ab0acd9ull, 0x0f9d37014bf60a10ull}, // 1e-15
+		{0xb424dc35095cd80full, 0x538484c19ef38c94ull}, // 1e-14
+		{0xe12e13424bb40e13ull, 0x2865a5f206b06fb9ull}, // 1e-13
+		{0x8cbccc096f5088cbull, 0xf93f87b7442e45d3ull}, // 1e-12
+		{0xafebff0bcb24aafeull, 0xf78f69a51539d748ull}, // 1e-11
+		{0xdbe6fecebdedd5beull, 0xb573440e5a884d1bull}, // 1e-10
+		{0x89705f4136b4a597ull, 0x31680a88f8953030ull}, // 1e-9
+		{0xabcc77118461cefcull, 0xfdc20d2b36ba7c3dull}, // 1e-8
+		{0xd6bf94d5e57a42bcull, 0x3d32907604691b4cull}, // 1e-7
+		{0x8637bd05af6c69b5ull, 0xa63f9a49c2c1b10full}, // 1e-6
+		{0xa7c5ac471b478423ull, 0x0fcf80dc33721d53ull}, // 1e-5
+		{0xd1b71758e219652bull, 0xd3c36113404ea4a8ull}, // 1e-4
+		{0x83126e978d4fdf3bull, 0x645a1cac083126e9ull}, // 1e-3
+		{0xa3d70a3d70a3d70aull, 0x3d70a3d70a3d70a3ull}, // 1e-2
+		{0xccccccccccccccccull, 0xccccccccccccccccull}, // 1e-1
+		{0x8000000000000000ull, 0x0000000000000000ull}, // 1e0
+		{0xa000000000000000ull, 0x0000000000000000ull}, // 1e1
+		{0xc800000000000000ull, 0x0000000000000000ull}, // 1e2
+		{0xfa00000000000000ull, 0x0000000000000000ull}, // 1e3
+		{0x9c40000000000000ull, 0x0000000000000000ull}, // 1e4
+		{0xc350000000000000ull, 0x0000000000000000ull}, // 1e5
+		{0xf424000000000000ull, 0x0000000000000000ull}, // 1e6
+		{0x9896800000000000ull, 0x0000000000000000ull}, // 1e7
+		{0xbebc200000000000ull, 0x0000000000000000ull}, // 1e8
+		{0xee6b280000000000ull, 0x0000000000000000ull}, // 1e9
+		{0x9502f90000000000ull, 0x0000000000000000ull}, // 1e10
+		{0xba43b74000000000ull, 0x0000000000000000ull}, // 1e11
+		{0xe8d4a51000000000ull, 0x0000000000000000ull}, // 1e12
+		{0x9184e72a00000000ull, 0x0000000000000000ull}, // 1e13
+		{0xb5e620f480000000ull, 0x0000000000000000ull}, // 1e14
+		{0xe35fa931a0000000ull, 0x0000000000000000ull}, // 1e15
+		{0x8e1bc9bf04000000ull, 0x0000000000000000ull}, // 1e16
+		{0xb1a2bc2ec5000000ull, 0x0000000000000000ull}, // 1e17
+		{0xde0b6b3a76400000ull, 0x0000000000000000ull}, // 1e18
+		{0x8ac7230489e80000ull, 0x0000000000000000ull}, // 1e19
+		{0xad78ebc5ac620000ull, 0x0000000000000000ull}, // 1e20
+		{0xd8d726b7177a8000ull, 0x0000000000000000ull}, // 1e21
+		{0x878678326eac9000ull, 0x0000000000000000ull}, // 1e22
+		{0xa968163f0a57b400ull, 0x0000000000000000ull}, // 1e23
+		{0xd3c21bcecceda100ull, 0x0000000000000000ull}, // 1e24
+		{0x84595161401484a0ull, 0x0000000000000000ull}, // 1e25
+		{0xa56fa5b99019a5c8ull, 0x0000000000000000ull}, // 1e26
+		{0xcecb8f27f4200f3aull, 0x0000000000000000ull}, // 1e27
+		{0x813f3978f8940984ull, 0x4000000000000000ull}, // 1e28
+		{0xa18f07d736b90be5ull, 0x5000000000000000ull}, // 1e29
+		{0xc9f2c9cd04674edeull, 0xa400000000000000ull}, // 1e30
+		{0xfc6f7c4045812296ull, 0x4d00000000000000ull}, // 1e31
+		{0x9dc5ada82b70b59dull, 0xf020000000000000ull}, // 1e32
+		{0xc5371912364ce305ull, 0x6c28000000000000ull}, // 1e33
+		{0xf684df56c3e01bc6ull, 0xc732000000000000ull}, // 1e34
+		{0x9a130b963a6c115cull, 0x3c7f400000000000ull}, // 1e35
+		{0xc097ce7bc90715b3ull, 0x4b9f100000000000ull}, // 1e36
+		{0xf0bdc21abb48db20ull, 0x1e86d40000000000ull}, // 1e37
+		{0x96769950b50d88f4ull, 0x1314448000000000ull}, // 1e38
+		{0xbc143fa4e250eb31ull, 0x17d955a000000000ull}, // 1e39
+		{0xeb194f8e1ae525fdull, 0x5dcfab0800000000ull}, // 1e40
+		{0x92efd1b8d0cf37beull, 0x5aa1cae500000000ull}, // 1e41
+		{0xb7abc627050305adull, 0xf14a3d9e40000000ull}, // 1e42
+		{0xe596b7b0c643c719ull, 0x6d9ccd05d0000000ull}, // 1e43
+		{0x8f7e32ce7bea5c6full, 0xe4820023a2000000ull}, // 1e44
+		{0xb35dbf821ae4f38bull, 0xdda2802c8a800000ull}, // 1e45
+		{0xe0352f62a19e306eull, 0xd50b2037ad200000ull}, // 1e46
+		{0x8c213d9da502de45ull, 0x4526f422cc340000ull}, // 1e47
+		{0xaf298d050e4395d6ull, 0x9670b12b7f410000ull}, // 1e48
+		{0xdaf3f04651d47b4cull, 0x3c0cdd765f114000ull}, // 1e49
+		{0x88d8762bf324cd0full, 0xa5880a69fb6ac800ull}, // 1e50
+		{0xab0e93b6efee0053ull, 0x8eea0d047a457a00ull}, // 1e51
+		{0xd5d238a4abe98068ull, 0x72a4904598d6d880ull}, // 1e52
+		{0x85a36366eb71f041ull, 0x47a6da2b7f864750ull}, // 1e53
+		{0xa70c3c40a64e6c51ull, 0x999090b65f67d924ull}, // 1e54
+		{0xd0cf4b50cfe20765ull, 0xfff4b4e3f741cf6dull}, // 1e55
+		{0x82818f1281ed449full, 0xbff8f10e7a8921a4ull}, // 1e56
+		{0xa321f2d7226895c7ull, 0xaff72d52192b6a0dull}, // 1e57
+		{0xcbea6f8ceb02bb39ull, 0x9bf4f8a69f764490ull}, // 1e58
+		{0xfee50b7025c36a08ull, 0x02f236d04753d5b4ull}, // 1e59
+		{0x9f4f2726179a2245ull, 0x01d762422c946590ull}, // 1e60
+		{0xc722f0ef9d80aad6ull, 0x424d3ad2b7b97ef5ull}, // 1e61
+		{0xf8ebad2b84e0d58bull, 0xd2e0898765a7deb2ull}, // 1e62
+		{0x9b934c3b330c8577ull, 0x63cc55f49f88eb2full}, // 1e63
+		{0xc2781f49ffcfa6d5ull, 0x3cbf6b71c76b25fbull}, // 1e64
+		{0xf316271c7fc3908aull, 0x8bef464e3945ef7aull}, // 1e65
+		{0x97edd871cfda3a56ull, 0x97758bf0e3cbb5acull}, // 1e66
+		{0xbde94e8e43d0c8ecull, 0x3d52eeed1cbea317ull}, // 1e67
+		{0xed63a231d4c4fb27ull, 0x4ca7aaa863ee4bddull}, // 1e68
+		{0x945e455f24fb1cf8ull, 0x8fe8caa93e74ef6aull}, // 1e69
+		{0xb975d6b6ee39e436ull, 0xb3e2fd538e122b44ull}, // 1e70
+		{0xe7d34c64a9c85d44ull, 0x60dbbca87196b616ull}, // 1e71
+		{0x90e40fbeea1d3a4aull, 0xbc8955e946fe31cdull}, // 1e72
+		{0xb51d13aea4a488ddull, 0x6babab6398bdbe41ull}, // 1e73
+		{0xe264589a4dcdab14ull, 0xc696963c7eed2dd1ull}, // 1e74
+		{0x8d7eb76070a08aecull, 0xfc1e1de5cf543ca2ull}, // 1e75
+		{0xb0de65388cc8ada8ull, 0x3b25a55f43294bcbull}, // 1e76
+		{0xdd15fe86affad912ull, 0x49ef0eb713f39ebeull}, // 1e77
+		{0x8a2dbf142dfcc7abull, 0x6e3569326c784337ull}, // 1e78
+		{0xacb92ed9397bf996ull, 0x49c2c37f07965404ull}, // 1e79
+		{0xd7e77a8f87daf7fbull, 0xdc33745ec97be906ull}, // 1e80
+		{0x86f0ac99b4e8dafdull, 0x69a028bb3ded71a3ull}, // 1e81
+		{0xa8acd7c0222311bcull, 0xc40832ea0d68ce0cull}, // 1e82
+		{0xd2d80db02aabd62bull, 0xf50a3fa490c30190ull}, // 1e83
+		{0x83c7088e1aab65dbull, 0x792667c6da79e0faull}, // 1e84
+		{0xa4b8cab1a1563f52ull, 0x577001b891185938ull}, // 1e85
+		{0xcde6fd5e09abcf26ull, 0xed4c0226b55e6f86ull}, // 1e86
+		{0x80b05e5ac60b6178ull, 0x544f8158315b05b4ull}, // 1e87
+		{0xa0dc75f1778e39d6ull, 0x696361ae3db1c721ull}, // 1e88
+		{0xc913936dd571c84cull, 0x03bc3a19cd1e38e9ull}, // 1e89
+		{0xfb5878494ace3a5full, 0x04ab48a04065c723ull}, // 1e90
+		{0x9d174b2dcec0e47bull, 0x62eb0d64283f9c76ull}, // 1e91
+		{0xc45d1df942711d9aull, 0x3ba5d0bd324f8394ull}, // 1e92
+		{0xf5746577930d6500ull, 0xca8f44ec7ee36479ull}, // 1e93
+		{0x9968bf6abbe85f20ull, 0x7e998b13cf4e1ecbull}, // 1e94
+		{0xbfc2ef456ae276e8ull, 0x9e3fedd8c321a67eull}, // 1e95
+		{0xefb3ab16c59b14a2ull, 0xc5cfe94ef3ea101eull}, // 1e96
+		{0x95d04aee3b80ece5ull, 0xbba1f1d158724a12ull}, // 1e97
+		{0xbb445da9ca61281full, 0x2a8a6e45ae8edc97ull}, // 1e98
+		{0xea1575143cf97226ull, 0xf52d09d71a3293bdull}, // 1e99
+		{0x924d692ca61be758ull, 0x593c2626705f9c56ull}, // 1e100
+		{0xb6e0c377cfa2e12eull, 0x6f8b2fb00c77836cull}, // 1e101
+		{0xe498f455c38b997aull, 0x0b6dfb9c0f956447ull}, // 1e102
+		{0x8edf98b59a373fecull, 0x4724bd4189bd5eacull}, // 1e103
+		{0xb2977ee300c50fe7ull, 0x58edec91ec2cb657ull}, // 1e104
+		{0xdf3d5e9bc0f653e1ull, 0x2f2967b66737e3edull}, // 1e105
+		{0x8b865b215899f46cull, 0xbd79e0d20082ee74ull}, // 1e106
+		{0xae67f1e9aec07187ull, 0xecd8590680a3aa11ull}, // 1e107
+		{0xda01ee641a708de9ull, 0xe80e6f4820cc9495ull}, // 1e108
+		{0x884134fe908658b2ull, 0x3109058d147fdcddull}, // 1e109
+		{0xaa51823e34a7eedeull, 0xbd4b46f0599fd415ull}, // 1e110
+		{0xd4e5e2cdc1d1ea96ull, 0x6c9e18ac7007c91aull}, // 1e111
+		{0x850fadc09923329eull, 0x03e2cf6bc604ddb0ull}, // 1e112
+		{0xa6539930bf6bff45ull, 0x84db8346b786151cull}, // 1e113
+		{0xcfe87f7cef46ff16ull, 0xe612641865679a63ull}, // 1e114
+		{0x81f14fae158c5f6eull, 0x4fcb7e8f3f60c07eull}, // 1e115
+		{0xa26da3999aef7749ull, 0xe3be5e330f38f09dull}, // 1e116
+		{0xcb090c8001ab551cull, 0x5cadf5bfd3072cc5ull}, // 1e117
+		{0xfdcb4fa002162a63ull, 0x73d9732fc7c8f7f6ull}, // 1e118
+		{0x9e9f11c4014dda7eull, 0x2867e7fddcdd9afaull}, // 1e119
+		{0xc646d63501a1511dull, 0xb281e1fd541501b8ull}, // 1e120
+		{0xf7d88bc24209a565ull, 0x1f225a7ca91a4226ull}, // 1e121
+		{0x9ae757596946075full, 0x3375788de9b06958ull}, // 1e122
+		{0xc1a12d2fc3978937ull, 0x0052d6b1641c83aeull}, // 1e123
+		{0xf209787bb47d6b84ull, 0xc0678c5dbd23a49aull}, // 1e124
+		{0x9745eb4d50ce6332ull, 0xf840b7ba963646e0ull}, // 1e125
+		{0xbd176620a501fbffull, 0xb650e5a93bc3d898ull}, // 1e126
+		{0xec5d3fa8ce427affull, 0xa3e51f138ab4cebeull}, // 1e127
+		{0x93ba47c980e98cdfull, 0xc66f336c36b10137ull}, // 1e128
+		{0xb8a8d9bbe123f017ull, 0xb80b0047445d4184ull}, // 1e129
+		{0xe6d3102ad96cec1dull, 0xa60dc059157491e5ull}, // 1e130
+		{0x9043ea1ac7e41392ull, 0x87c89837ad68db2full}, // 1e131
+		{0xb454e4a179dd1877ull, 0x29babe4598c311fbull}, // 1e132
+		{0xe16a1dc9d8545e94ull, 0xf4296dd6fef3d67aull}, // 1e133
+		{0x8ce2529e2734bb1dull, 0x1899e4a65f58660cull}, // 1e134
+		{0xb01ae745b101e9e4ull, 0x5ec05dcff72e7f8full}, // 1e135
+		{0xdc21a1171d42645dull, 0x76707543f4fa1f73ull}, // 1e136
+		{0x899504ae72497ebaull, 0x6a06494a791c53a8ull}, // 1e137
+		{0xabfa45da0edbde69ull, 0x0487db9d17636892ull}, // 1e138
+		{0xd6f8d7509292d603ull, 0x45a9d2845d3c42b6ull}, // 1e139
+		{0x865b86925b9bc5c2ull, 0x0b8a2392ba45a9b2ull}, // 1e140
+		{0xa7f26836f282b732ull, 0x8e6cac7768d7141eull}, // 1e141
+		{0xd1ef0244af2364ffull, 0x3207d795430cd926ull}, // 1e142
+		{0x8335616aed761f1full, 0x7f44e6bd49e807b8ull}, // 1e143
+		{0xa402b9c5a8d3a6e7ull, 0x5f16206c9c6209a6ull}, // 1e144
+		{0xcd036837130890a1ull, 0x36dba887c37a8c0full}, // 1e145
+		{0x802221226be55a64ull, 0xc2494954da2c9789ull}, // 1e146
+		{0xa02aa96b06deb0fdull, 0xf2db9baa10b7bd6cull}, // 1e147
+		{0xc83553c5c8965d3dull, 0x6f92829494e5acc7ull}, // 1e148
+		{0xfa42a8b73abbf48cull, 0xcb772339ba1f17f9ull}, // 1e149
+		{0x9c69a97284b578d7ull, 0xff2a760414536efbull}, // 1e150
+		{0xc38413cf25e2d70dull, 0xfef5138519684abaull}, // 1e151
+		{0xf46518c2ef5b8cd1ull, 0x7eb258665fc25d69ull}, // 1e152
+		{0x98bf2f79d5993802ull, 0xef2f773ffbd97a61ull}, // 1e153
+		{0xbeeefb584aff8603ull, 0xaafb550ffacfd8faull}, // 1e154
+		{0xeeaaba2e5dbf6784ull, 0x95ba2a53f983cf38ull}, // 1e155
+		{0x952ab45cfa97a0b2ull, 0xdd945a747bf26183ull}, // 1e156
+		{0xba756174393d88dfull, 0x94f971119aeef9e4ull}, // 1e157
+		{0xe912b9d1478ceb17ull, 0x7a37cd5601aab85dull}, // 1e158
+		{0x91abb422ccb812eeull, 0xac62e055c10ab33aull}, // 1e159
+		{0xb616a12b7fe617aaull, 0x577b986b314d6009ull}, // 1e160
+		{0xe39c49765fdf9d94ull, 0xed5a7e85fda0b80bull}, // 1e161
+		{0x8e41ade9fbebc27dull, 0x14588f13be847307ull}, // 1e162
+		{0xb1d219647ae6b31cull, 0x596eb2d8ae258fc8ull}, // 1e163
+		{0xde469fbd99a05fe3ull, 0x6fca5f8ed9aef3bbull}, // 1e164
+		{0x8aec23d680043beeull, 0x25de7bb9480d5854ull}, // 1e165
+		{0xada72ccc20054ae9ull, 0xaf561aa79a10ae6aull}, // 1e166
+		{0xd910f7ff28069da4ull, 0x1b2ba1518094da04ull}, // 1e167
+		{0x87aa9aff79042286ull, 0x90fb44d2f05d0842ull}, // 1e168
+		{0xa99541bf57452b28ull, 0x353a1607ac744a53ull}, // 1e169
+		{0xd3fa922f2d1675f2ull, 0x42889b8997915ce8ull}, // 1e170
+		{0x847c9b5d7c2e09b7ull, 0x69956135febada11ull}, // 1e171
+		{0xa59bc234db398c25ull, 0x43fab9837e699095ull}, // 1e172
+		{0xcf02b2c21207ef2eull, 0x94f967e45e03f4bbull}, // 1e173
+		{0x8161afb94b44f57dull, 0x1d1be0eebac278f5ull}, // 1e174
+		{0xa1ba1ba79e1632dcull, 0x6462d92a69731732ull}, // 1e175
+		{0xca28a291859bbf93ull, 0x7d7b8f7503cfdcfeull}, // 1e176
+		{0xfcb2cb35e702af78ull, 0x5cda735244c3d43eull}, // 1e177
+		{0x9defbf01b061adabull, 0x3a0888136afa64a7ull}, // 1e178
+		{0xc56baec21c7a1916ull, 0x088aaa1845b8fdd0ull}, // 1e179
+		{0xf6c69a72a3989f5bull, 0x8aad549e57273d45ull}, // 1e180
+		{0x9a3c2087a63f6399ull, 0x36ac54e2f678864bull}, // 1e181
+		{0xc0cb28a98fcf3c7full, 0x84576a1bb416a7ddull}, // 1e182
+		{0xf0fdf2d3f3c30b9full, 0x656d44a2a11c51d5ull}, // 1e183
+		{0x969eb7c47859e743ull, 0x9f644ae5a4b1b325ull}, // 1e184
+		{0xbc4665b596706114ull, 0x873d5d9f0dde1feeull}, // 1e185
+		{0xeb57ff22fc0c7959ull, 0xa90cb506d155a7eaull}, // 1e186
+		{0x9316ff75dd87cbd8ull, 0x09a7f12442d588f2ull}, // 1e187
+		{0xb7dcbf5354e9beceull, 0x0c11ed6d538aeb2full}, // 1e188
+		{0xe5d3ef282a242e81ull, 0x8f1668c8a86da5faull}, // 1e189
+		{0x8fa475791a569d10ull, 0xf96e017d694487bcull}, // 1e190
+		{0xb38d92d760ec4455ull, 0x37c981dcc395a9acull}, // 1e191
+		{0xe070f78d3927556aull, 0x85bbe253f47b1417ull}, // 1e192
+		{0x8c469ab843b89562ull, 0x93956d7478ccec8eull}, // 1e193
+		{0xaf58416654a6babbull, 0x387ac8d1970027b2ull}, // 1e194
+		{0xdb2e51bfe9d0696aull, 0x06997b05fcc0319eull}, // 1e195
+		{0x88fcf317f22241e2ull, 0x441fece3bdf81f03ull}, // 1e196
+		{0xab3c2fddeeaad25aull, 0xd527e81cad7626c3ull}, // 1e197
+		{0xd60b3bd56a5586f1ull, 0x8a71e223d8d3b074ull}, // 1e198
+		{0x85c7056562757456ull, 0xf6872d5667844e49ull}, // 1e199
+		{0xa738c6bebb12d16cull, 0xb428f8ac016561dbull}, // 1e200
+		{0xd106f86e69d785c7ull, 0xe13336d701beba52ull}, // 1e201
+		{0x82a45b450226b39cull, 0xecc0024661173473ull}, // 1e202
+		{0xa34d721642b06084ull, 0x27f002d7f95d0190ull}, // 1e203
+		{0xcc20ce9bd35c78a5ull, 0x31ec038df7b441f4ull}, // 1e204
+		{0xff290242c83396ceull, 0x7e67047175a15271ull}, // 1e205
+		{0x9f79a169bd203e41ull, 0x0f0062c6e984d386ull}, // 1e206
+		{0xc75809c42c684dd1ull, 0x52c07b78a3e60868ull}, // 1e207
+		{0xf92e0c3537826145ull, 0xa7709a56ccdf8a82ull}, // 1e208
+		{0x9bbcc7a142b17ccbull, 0x88a66076400bb691ull}, // 1e209
+		{0xc2abf989935ddbfeull, 0x6acff893d00ea435ull}, // 1e210
+		{0xf356f7ebf83552feull, 0x0583f6b8c4124d43ull}, // 1e211
+		{0x98165af37b2153deull, 0xc3727a337a8b704aull}, // 1e212
+		{0xbe1bf1b059e9a8d6ull, 0x744f18c0592e4c5cull}, // 1e213
+		{0xeda2ee1c7064130cull, 0x1162def06f79df73ull}, // 1e214
+		{0x9485d4d1c63e8be7ull, 0x8addcb5645ac2ba8ull}, // 1e215
+		{0xb9a74a0637ce2ee1ull, 0x6d953e2bd7173692ull}, // 1e216
+		{0xe8111c87c5c1ba99ull, 0xc8fa8db6ccdd0437ull}, // 1e217
+		{0x910ab1d4db9914a0ull, 0x1d9c9892400a22a2ull}, // 1e218
+		{0xb54d5e4a127f59c8ull, 0x2503beb6d00cab4bull}, // 1e219
+		{0xe2a0b5dc971f303aull, 0x2e44ae64840fd61dull}, // 1e220
+		{0x8da471a9de737e24ull, 0x5ceaecfed289e5d2ull}, // 1e221
+		{0xb10d8e1456105dadull, 0x7425a83e872c5f47ull}, // 1e222
+		{0xdd50f1996b947518ull, 0xd12f124e28f77719ull}, // 1e223
+		{0x8a5296ffe33cc92full, 0x82bd6b70d99aaa6full}, // 1e224
+		{0xace73cbfdc0bfb7bull, 0x636cc64d1001550bull}, // 1e225
+		{0xd8210befd30efa5aull, 0x3c47f7e05401aa4eull}, // 1e226
+		{0x8714a775e3e95c78ull, 0x65acfaec34810a71ull}, // 1e227
+		{0xa8d9d1535ce3b396ull, 0x7f1839a741a14d0dull}, // 1e228
+		{0xd31045a8341ca07cull, 0x1ede48111209a050ull}, // 1e229
+		{0x83ea2b892091e44dull, 0x934aed0aab460432ull}, // 1e230
+		{0xa4e4b66b68b65d60ull, 0xf81da84d5617853full}, // 1e231
+		{0xce1de40642e3f4b9ull, 0x36251260ab9d668eull}, // 1e232
+		{0x80d2ae83e9ce78f3ull, 0xc1d72b7c6b426019ull}, // 1e233
+		{0xa1075a24e4421730ull, 0xb24cf65b8612f81full}, // 1e234
+		{0xc94930ae1d529cfcull, 0xdee033f26797b627ull}, // 1e235
+		{0xfb9b7cd9a4a7443cull, 0x169840ef017da3b1ull}, // 1e236
+		{0x9d412e0806e88aa5ull, 0x8e1f289560ee864eull}, // 1e237
+		{0xc491798a08a2ad4eull, 0xf1a6f2bab92a27e2ull}, // 1e238
+		{0xf5b5d7ec8acb58a2ull, 0xae10af696774b1dbull}, // 1e239
+		{0x9991a6f3d6bf1765ull, 0xacca6da1e0a8ef29ull}, // 1e240
+		{0xbff610b0cc6edd3full, 0x17fd090a58d32af3ull}, // 1e241
+		{0xeff394dcff8a948eull, 0xddfc4b4cef07f5b0ull}, // 1e242
+		{0x95f83d0a1fb69cd9ull, 0x4abdaf101564f98eull}, // 1e243
+		{0xbb764c4ca7a4440full, 0x9d6d1ad41abe37f1ull}, // 1e244
+		{0xea53df5fd18d5513ull, 0x84c86189216dc5edull}, // 1e245
+		{0x92746b9be2f8552cull, 0x32fd3cf5b4e49bb4ull}, // 1e246
+		{0xb7118682dbb66a77ull, 0x3fbc8c33221dc2a1ull}, // 1e247
+		{0xe4d5e82392a40515ull, 0x0fabaf3feaa5334aull}, // 1e248
+		{0x8f05b1163ba6832dull, 0x29cb4d87f2a7400eull}, // 1e249
+		{0xb2c71d5bca9023f8ull, 0x743e20e9ef511012ull}, // 1e250
+		{0xdf78e4b2bd342cf6ull, 0x914da9246b255416ull}, // 1e251
+		{0x8bab8eefb6409c1aull, 0x1ad089b6c2f7548eull}, // 1e252
+		{0xae9672aba3d0c320ull, 0xa184ac2473b529b1ull}, // 1e253
+		{0xda3c0f568cc4f3e8ull, 0xc9e5d72d90a2741eull}, // 1e254
+		{0x8865899617fb1871ull, 0x7e2fa67c7a658892ull}, // 1e255
+		{0xaa7eebfb9df9de8dull, 0xddbb901b98feeab7ull}, // 1e256
+		{0xd51ea6fa85785631ull, 0x552a74227f3ea565ull}, // 1e257
+		{0x8533285c936b35deull, 0xd53a88958f87275full}, // 1e258
+		{0xa67ff273b8460356ull, 0x8a892abaf368f137ull}, // 1e259
+		{0xd01fef10a657842cull, 0x2d2b7569b0432d85ull}, // 1e260
+		{0x8213f56a67f6b29bull, 0x9c3b29620e29fc73ull}, // 1e261
+		{0xa298f2c501f45f42ull, 0x8349f3ba91b47b8full}, // 1e262
+		{0xcb3f2f7642717713ull, 0x241c70a936219a73ull}, // 1e263
+		{0xfe0efb53d30dd4d7ull, 0xed238cd383aa0110ull}, // 1e264
+		{0x9ec95d1463e8a506ull, 0xf4363804324a40aaull}, // 1e265
+		{0xc67bb4597ce2ce48ull, 0xb143c6053edcd0d5ull}, // 1e266
+		{0xf81aa16fdc1b81daull, 0xdd94b7868e94050aull}, // 1e267
+		{0x9b10a4e5e9913128ull, 0xca7cf2b4191c8326ull}, // 1e268
+		{0xc1d4ce1f63f57d72ull, 0xfd1c2f611f63a3f0ull}, // 1e269
+		{0xf24a01a73cf2dccfull, 0xbc633b39673c8cecull}, // 1e270
+		{0x976e41088617ca01ull, 0xd5be0503e085d813ull}, // 1e271
+		{0xbd49d14aa79dbc82ull, 0x4b2d8644d8a74e18ull}, // 1e272
+		{0xec9c459d51852ba2ull, 0xddf8e7d60ed1219eull}, // 1e273
+		{0x93e1ab8252f33b45ull, 0xcabb90e5c942b503ull}, // 1e274
+		{0xb8da1662e7b00a17ull, 0x3d6a751f3b936243ull}, // 1e275
+		{0xe7109bfba19c0c9dull, 0x0cc512670a783ad4ull}, // 1e276
+		{0x906a617d450187e2ull, 0x27fb2b80668b24c5ull}, // 1e277
+		{0xb484f9dc9641e9daull, 0xb1f9f660802dedf6ull}, // 1e278
+		{0xe1a63853bbd26451ull, 0x5e7873f8a0396973ull}, // 1e279
+		{0x8d07e33455637eb2ull, 0xdb0b487b6423e1e8ull}, // 1e280
+		{0xb049dc016abc5e5full, 0x91ce1a9a3d2cda62ull}, // 1e281
+		{0xdc5c5301c56b75f7ull, 0x7641a140cc7810fbull}, // 1e282
+		{0x89b9b3e11b6329baull, 0xa9e904c87fcb0a9dull}, // 1e283
+		{0xac2820d9623bf429ull, 0x546345fa9fbdcd44ull}, // 1e284
+		{0xd732290fbacaf133ull, 0xa97c177947ad4095ull}, // 1e285
+		{0x867f59a9d4bed6c0ull, 0x49ed8eabcccc485dull}, // 1e286
+		{0xa81f301449ee8c70ull, 0x5c68f256bfff5a74ull}, // 1e287
+		{0xd226fc195c6a2f8cull, 0x73832eec6fff3111ull}, // 1e288
+		{0x83585d8fd9c25db7ull, 0xc831fd53c5ff7eabull}, // 1e289
+		{0xa42e74f3d032f525ull, 0xba3e7ca8b77f5e55ull}, // 1e290
+		{0xcd3a1230c43fb26full, 0x28ce1bd2e55f35ebull}, // 1e291
+		{0x80444b5e7aa7cf85ull, 0x7980d163cf5b81b3ull}, // 1e292
+		{0xa0555e361951c366ull, 0xd7e105bcc332621full}, // 1e293
+		{0xc86ab5c39fa63440ull, 0x8dd9472bf3fefaa7ull}, // 1e294
+		{0xfa856334878fc150ull, 0xb14f98f6f0feb951ull}, // 1e295
+		{0x9c935e00d4b9d8d2ull, 0x6ed1bf9a569f33d3ull}, // 1e296
+		{0xc3b8358109e84f07ull, 0x0a862f80ec4700c8ull}, // 1e297
+		{0xf4a642e14c6262c8ull, 0xcd27bb612758c0faull}, // 1e298
+		{0x98e7e9cccfbd7dbdull, 0x8038d51cb897789cull}, // 1e299
+		{0xbf21e44003acdd2cull, 0xe0470a63e6bd56c3ull}, // 1e300
+		{0xeeea5d5004981478ull, 0x1858ccfce06cac74ull}, // 1e301
+		{0x95527a5202df0ccbull, 0x0f37801e0c43ebc8ull}, // 1e302
+		{0xbaa718e68396cffdull, 0xd30560258f54e6baull}, // 1e303
+		{0xe950df20247c83fdull, 0x47c6b82ef32a2069ull}, // 1e304
+		{0x91d28b7416cdd27eull, 0x4cdc331d57fa5441ull}, // 1e305
+		{0xb6472e511c81471dull, 0xe0133fe4adf8e952ull}, // 1e306
+		{0xe3d8f9e563a198e5ull, 0x58180fddd97723a6ull}, // 1e307
+		{0x8e679c2f5e44ff8full, 0x570f09eaa7ea7648ull}, // 1e308
+	};
+
+	// Returns false if the result can't be rounded correctly with the 128 bits of precision we have.
+	bool eisel_lemire(uint64_t mantissa, int exp10, bool negative, double* out_value)
+	{
+		if (exp10 < POWERS_OF_TEN_128_MIN_EXP || POWERS_OF_TEN_128_MAX_EXP < exp10) {
+			return false;
+		}
+
+		// Normalize:
+		const int clz = leading_zeros_64(mantissa);
+		mantissa <<= clz;
+		uint64_t exp2 = static_cast<uint64_t>(((217706 * exp10) >> 16) + 64 + 1023) - static_cast<uint64_t>(clz);
+
+		// Multiply:
+		const uint64_t* power = POWERS_OF_TEN_128[exp10 - POWERS_OF_TEN_128_MIN_EXP];
+		UInt128 x = multiply_64x64(mantissa, power[0]);
+
+		// Use all 128 bits of the power if the top 64 were not enough:
+		if ((x.high & 0x1FF) == 0x1FF && x.low + mantissa < mantissa) {
+			const UInt128 y = multiply_64x64(mantissa, power[1]);
+			uint64_t merged_high = x.high;
+			const uint64_t merged_low = x.low + y.high;
+			if (merged_low < x.low) {
+				merged_high += 1;
+			}
+			if ((merged_high & 0x1FF) == 0x1FF && merged_low + 1 == 0 && y.low + mantissa < mantissa) {
+				return false;
+			}
+			x.high = merged_high;
+			x.low  = merged_low;
+		}
+
+		// Shift to 54 bits:
+		const uint64_t msb = x.high >> 63;
+		uint64_t result_mantissa = x.high >> (msb + 9);
+		exp2 -= 1 ^ msb;
+
+		// Exactly half-way between two doubles?
+		if (x.low == 0 && (x.high & 0x1FF) == 0 && (result_mantissa & 3) == 1) {
+			return false;
+		}
+
+		// Round from 54 to 53 bits:
+		result_mantissa += result_mantissa & 1;
+		result_mantissa >>= 1;
+		if ((result_mantissa >> 53) > 0) {
+			result_mantissa >>= 1;
+			exp2 += 1;
+		}
+
+		// Subnormals, infinities and zero are left for the slow path:
+		if (exp2 - 1 >= 0x7FF - 1) {
+			return false;
+		}
+
+		uint64_t bits = (exp2 << 52) | (result_mantissa & 0x000FFFFFFFFFFFFFull);
+		if (negative) {
+			bits |= 0x8000000000000000ull;
+		}
+		*out_value = double_from_bits(bits);
+		return true;
+	}
+
+	// Arbitrary precision decimal for the cases when the fast methods can't decide the rounding.
+	struct BigDecimal
+	{
+		static const int MAX_DIGITS = 800;
+
+		uint8_t digits[MAX_DIGITS]; // Most significant first, each 0-9.
+		int     num_digits    = 0;
+		int     decimal_point = 0;     // The value is 0.digits * 10^decimal_point
+		bool    truncated     = false; // Non-zero digits were dropped from the end.
+
+		// [begin, end) is a validated sequence of digits with an optional decimal point.
+		BigDecimal(const char* begin, const char* end, int exponent)
+		{
+			bool saw_dot = false;
+			int  seen_digits = 0; // Significant digits, also those past MAX_DIGITS.
+			for (const char* p = begin; p != end; ++p) {
+				if (*p == '.') {
+					saw_dot = true;
+					decimal_point = seen_digits;
+				} else if (*p == '0' && seen_digits == 0) {
+					decimal_point -= 1; // Leading zero
+				} else {
+					if (num_digits < MAX_DIGITS) {
+						digits[num_digits++] = static_cast<uint8_t>(*p - '0');
+					} else if (*p != '0') {
+						truncated = true;
+					}
+					seen_digits += 1;
+				}
+			}
+			if (!saw_dot) {
+				decimal_point = seen_digits;
+			}
+			decimal_point += exponent;
+		}
+
+		void trim()
+		{
+			while (num_digits > 0 && digits[num_digits - 1] == 0) {
+				num_digits -= 1;
+			}
+			if (num_digits == 0) {
+				decimal_point = 0;
+			}
+		}
+
+		// Multiply by 2^k, k <= 60.
+		void shift_left(unsigned k)
+		{
+			// Every three bits adds at most one decimal digit:
+			const int max_new_digits = static_cast<int>(k / 3 + 1);
+			const int write_end = num_digits + max_new_digits;
+			int write = write_end;
+			uint64_t n = 0;
+
+			for (int read = num_digits - 1; read >= 0; --read) {
+				n += static_cast<uint64_t>(digits[read]) << k;
+				const uint64_t quotient = n / 10;
+				put_down(--write, n - 10 * quotient);
+				n = quotient;
+			}
+			while (n > 0) {
+				const uint64_t quotient = n / 10;
+				put_down(--write, n - 10 * quotient);
+				n = quotient;
+			}
+
+			const int kept_end = write_end < MAX_DIGITS ? write_end : MAX_DIGITS;
+			memmove(digits, digits + write, static_cast<size_t>(kept_end - write));
+			num_digits = kept_end - write;
+			decimal_point += max_new_digits - write;
+			trim();
+		}
+
+		void put_down(int index, uint64_t digit)
+		{
+			if (index < MAX_DIGITS) {
+				digits[index] = static_cast<uint8_t>(digit);
+			} else if (digit != 0) {
+				truncated = true;
+			}
+		}
+
+		// Divide by 2^k, k <= 60.
+		void shift_right(unsigned k)
+		{
+			int read = 0;
+			int write = 0;
+			uint64_t n = 0;
+
+			// Pick up enough leading digits to cover the first shift:
+			for (; (n >> k) == 0; ++read) {
+				if (read >= num_digits) {
+					if (n == 0) {
+						num_digits = 0;
+						return;
+					}
+					while ((n >> k) == 0) {
+						n *= 10;
+						read += 1;
+					}
+					break;
+				}
+				n = 10 * n + digits[read];
+			}
+			decimal_point -= read - 1;
+
+			const uint64_t mask = (uint64_t(1) << k) - 1;
+
+			// Pick up a digit, put down a digit:
+			for (; read < num_digits; ++read) {
+				const uint64_t digit = n >> k;
+				n &= mask;
+				digits[write++] = static_cast<uint8_t>(digit);
+				n = 10 * n + digits[read];
+			}
+
+			// Put down the remaining digits:
+			while (n > 0) {
+				const uint64_t digit = n >> k;
+				n &= mask;
+				if (write < MAX_DIGITS) {
+					digits[write++] = static_cast<uint8_t>(digit);
+				} else if (digit > 0) {
+					truncated = true;
+				}
+				n *= 10;
+			}
+
+			num_digits = write;
+			trim();
+		}
+
+		void shift(int k)
+		{
+			const int MAX_SHIFT = 60;
+			if (num_digits == 0) { return; }
+			for (; k > MAX_SHIFT; k -= MAX_SHIFT) {
+				shift_left(MAX_SHIFT);
+			}
+			for (; k < -MAX_SHIFT; k += MAX_SHIFT) {
+				shift_right(MAX_SHIFT);
+			}
+			if (k > 0) {
+				shift_left(static_cast<unsigned>(k));
+			} else if (k < 0) {
+				shift_right(static_cast<unsigned>(-k));
+			}
+		}
+
+		bool should_round_up(int nd) const
+		{
+			if (nd < 0 || nd >= num_digits) { return false; }
+			if (digits[nd] == 5 && nd + 1 == num_digits) {
+				// Exactly half-way - round to even, unless we dropped something:
+				return truncated || (nd > 0 && digits[nd - 1] % 2 == 1);
+			}
+			return digits[nd] >= 5;
+		}
+
+		uint64_t rounded_integer() const
+		{
+			if (decimal_point > 20) {
+				return 0xFFFFFFFFFFFFFFFFull;
+			}
+			uint64_t n = 0;
+			int i = 0;
+			for (; i < decimal_point && i < num_digits; ++i) {
+				n = 10 * n + digits[i];
+			}
+			for (; i < decimal_point; ++i) {
+				n *= 10;
+			}
+			if (should_round_up(decimal_point)) {
+				n += 1;
+			}
+			return n;
+		}
+
+		double to_double(bool negative)
+		{
+			// How far we can shift in one step without losing the leading digit:
+			static const int SHIFT_FOR_DIGITS[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+			const int NUM_SHIFTS = sizeof(SHIFT_FOR_DIGITS) / sizeof(SHIFT_FOR_DIGITS[0]);
+
+			int      exp2     = -1023; // Zero or subnormal
+			uint64_t mantissa = 0;
+			bool     overflow = false;
+
+			if (num_digits == 0 || decimal_point < -330) {
+				// Zero
+			} else if (decimal_point > 310) {
+				overflow = true;
+			} else {
+				// Scale by powers of two until we are in [0.5, 1):
+				exp2 = 0;
+				while (decimal_point > 0) {
+					const int n = decimal_point >= NUM_SHIFTS ? 27 : SHIFT_FOR_DIGITS[decimal_point];
+					shift(-n);
+					exp2 += n;
+				}
+				while (decimal_point < 0 || (decimal_point == 0 && digits[0] < 5)) {
+					const int n = -decimal_point >= NUM_SHIFTS ? 27 : SHIFT_FOR_DIGITS[-decimal_point];
+					shift(n);
+					exp2 -= n;
+				}
+
+				// Our range is [0.5, 1) but a double mantissa is in [1, 2):
+				exp2 -= 1;
+
+				// Subnormal?
+				if (exp2 < -1022) {
+					const int n = -1022 - exp2;
+					shift(-n);
+					exp2 += n;
+				}
+
+				if (exp2 + 1023 >= 0x7FF) {
+					overflow = true;
+				} else {
+					// Extract 53 bits:
+					shift(53);
+					mantissa = rounded_integer();
+
+					// Rounding might have added a bit:
+					if (mantissa == (uint64_t(2) << 52)) {
+						mantissa >>= 1;
+						exp2 += 1;
+						overflow = exp2 + 1023 >= 0x7FF;
+					}
+
+					if ((mantissa & (uint64_t(1) << 52)) == 0) {
+						exp2 = -1023; // Subnormal
+					}
+				}
+			}
+
+			if (overflow) {
+				mantissa = 0;
+				exp2 = 0x7FF - 1023;
+			}
+
+			uint64_t bits = mantissa & ((uint64_t(1) << 52) - 1);
+			bits |= static_cast<uint64_t>((exp2 + 1023) & 0x7FF) << 52;
+			if (negative) {
+				bits |= 0x8000000000000000ull;
+			}
+			return double_from_bits(bits);
+		}
+	};
+
+	// Parses a decimal number like 42, -1.5, .5 or 6.02e23 without looking at the locale.
+	// Reads no further than end. Returns the end of the number, or nullptr if there were no digits.
+	const char* parse_double(const char* str, const char* end, double* out_value)
+	{
+		const auto peek = [end](const char* q) { return q < end ? *q : '\0'; };
+		const char* p = str;
+		bool negative = false;
+		if (peek(p) == '+' || peek(p) == '-') {
+			negative = (peek(p) == '-');
+			p += 1;
+		}
+
+		// The first 19 significant digits fit in an uint64_t:
+		const int MAX_MANTISSA_DIGITS = 19;
+		const char* digits_begin       = p;
+		uint64_t    mantissa           = 0;
+		int         num_mantissa_digits = 0;
+		int         num_digits         = 0; // Significant digits
+		int         decimal_point      = 0;
+		bool        saw_dot            = false;
+		bool        saw_digits         = false;
+		bool        truncated          = false;
+
+		for (;; ++p) {
+			const char c = peek(p);
+			if (c == '.') {
+				if (saw_dot) { break; }
+				saw_dot = true;
+				decimal_point = num_digits;
+			} else if ('0' <= c && c <= '9') {
+				saw_digits = true;
+				if (c == '0' && num_digits == 0) {
+					decimal_point -= 1; // Leading zero
+					continue;
+				}
+				num_digits += 1;
+				if (num_mantissa_digits < MAX_MANTISSA_DIGITS) {
+					mantissa = 10 * mantissa + static_cast<uint64_t>(c - '0');
+					num_mantissa_digits += 1;
+				} else if (c != '0') {
+					truncated = true;
+				}
+			} else {
+				break;
+			}
+		}
+
+		if (!saw_digits) { return nullptr; }
+
+		const char* digits_end = p;
+		if (!saw_dot) {
+			decimal_point = num_digits;
+		}
+
+		// An exponent without any digits is not part of the number:
+		int exponent = 0;
+		if (peek(p) == 'e' || peek(p) == 'E') {
+			const char* e = p + 1;
+			int exponent_sign = +1;
+			if (peek(e) == '+' || peek(e) == '-') {
+				exponent_sign = (peek(e) == '-' ? -1 : +1);
+				e += 1;
+			}
+			if ('0' <= peek(e) && peek(e) <= '9') {
+				for (; '0' <= peek(e) && peek(e) <= '9'; ++e) {
+					if (exponent < 10000) {
+						exponent = 10 * exponent + (peek(e) - '0');
+					}
+				}
+				exponent *= exponent_sign;
+				p = e;
+			}
+		}
+
+		if (mantissa == 0) {
+			*out_value = negative ? -0.0 : 0.0;
+			return p;
+		}
+
+		const int exp10 = decimal_point + exponent - num_mantissa_digits;
+
+		if (!truncated && (mantissa >> 53) == 0) {
+			// Both mantissa and power of ten are exact doubles, so one rounding gives the right answer:
+			double value = static_cast<double>(mantissa);
+			bool exact = true;
+			if (0 < exp10 && exp10 <= 15 + 22) {
+				int e = exp10;
+				if (e > 22) {
+					value *= EXACT_POWERS_OF_TEN[e - 22];
+					e = 22;
+				}
+				exact = value <= 1e15;
+				value *= EXACT_POWERS_OF_TEN[e];
+			} else if (-22 <= exp10 && exp10 < 0) {
+				value /= EXACT_POWERS_OF_TEN[-exp10];
+			} else {
+				exact = exp10 == 0;
+			}
+			if (exact) {
+				*out_value = negative ? -value : value;
+				return p;
+			}
+		}
+
+		double value;
+		if (eisel_lemire(mantissa, exp10, negative, &value)) {
+			if (!truncated) {
+				*out_value = value;
+				return p;
+			}
+			// The digits we dropped could only make the number larger.
+			// If that would not change the rounding we are done:
+			double upper_value;
+			if (eisel_lemire(mantissa + 1, exp10, negative, &upper_value) && value == upper_value) {
+				*out_value = value;
+				return p;
+			}
+		}
+
+		BigDecimal decimal(digits_begin, digits_end, exponent);
+		*out_value = decimal.to_double(negative);
+		return p;
+	}
+
+	// A set of bytes, with one bit per byte value.
+	struct CharTable
+	{
+		uint64_t words[4];
+
+		bool operator[](uint8_t byte) const
+		{
+			return ((words[byte >> 6] >> (byte & 63)) & 1) != 0;
+		}
+	};
+
+	// Bits lo to hi (inclusive) of a 64-bit word. Bits outside [0, 63] are ignored.
+	constexpr uint64_t bit_span(int lo, int hi)
+	{
+		return (lo > hi || hi < 0 || 63 < lo) ? 0 :
+			(~uint64_t(0) >> (63 - ((hi < 63 ? hi : 63) - (lo > 0 ? lo : 0)))) << (lo > 0 ? lo : 0);
+	}
+
+	// Word number `word` of a CharTable containing all bytes from `first` to `last` (inclusive).
+	constexpr uint64_t byte_range(int word, int first, int last)
+	{
+		return bit_span(first - 64 * word, last - 64 * word);
+	}
+
+	constexpr uint64_t ident_starters(int w)
+	{
+		return byte_range(w, '_', '_') | byte_range(w, 'a', 'z') | byte_range(w, 'A', 'Z');
+	}
+
+	constexpr uint64_t ident_chars(int w)
+	{
+		return ident_starters(w) | byte_range(w, '0', '9');
+	}
+
+	constexpr uint64_t maybe_white(int w)
+	{
+		return byte_range(w, '\n', '\n') | byte_range(w, '\r', '\r') | byte_range(w, '\t', '\t') |
+		       byte_range(w, ' ', ' ') | byte_range(w, '/', '/'); // Maybe a comment
+	}
+
+	constexpr CharTable IDENT_STARTERS = {{ ident_starters(0), ident_starters(1), ident_starters(2), ident_starters(3) }};
+	constexpr CharTable IDENT_CHARS    = {{ ident_chars(0),    ident_chars(1),    ident_chars(2),    ident_chars(3)    }};
+	constexpr CharTable MAYBE_WHITE    = {{ maybe_white(0),    maybe_white(1),    maybe_white(2),    maybe_white(3)    }};
+
+	struct State
+	{
+		const char* ptr;
+		unsigned    line_nr;
+		const char* line_start;
+		Index       column_offset; // Bytes of the line before line_start that are no longer in memory (see IncrementalParser)
+	};
+
+	// A document parsed by parse_file_lazy. Kept alive by the arrays/objects that are not yet parsed.
+	struct LazySource
+	{
+		std::shared_ptr<const void> owner; // Owns [begin, end)
+		const char*                 begin;
+		const char*                 end;
+		FormatOptions               options;
+		DocInfo_SP                  doc;
+	};
+
+	struct LazyRange
+	{
+		std::shared_ptr<const LazySource> source;
+		State                             open_state;  // At the opening brace
+		const char*                       end;         // Past the closing brace
+		int                               indentation; // Of the line with the opening brace
+		size_t                            depth;       // Arrays/objects around it
+	};
+
+	// A syntax error, or a file that could not be read. Thrown as a ParseError, or returned in a ParseResult.
+	struct ParseFailure
+	{
+		DocInfo_SP  doc;
+		Index       line   = 0; // Zero if the file could not be read
+		Index       column = 0;
+		std::string description;
+	};
+
+	static void throw_parse_error(const ParseFailure& failure) CONFIGURU_NORETURN;
+
+	// Parses the file at `path` into `out` with a Parser of its own (or takes it from info.preloaded_files).
+	// Returns false on a syntax error, or if the file could not be read.
+	static bool try_parse_file(const std::string& path, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info,
+	                           Config& out, ParseFailure& out_failure);
+
+	// The parser does not throw. It stops at the first error, which is then in failure().
+	// Everything that can fail returns as soon as it (or something it called) has, without reporting anything to the handler.
+	// Those that return bool return false then, except skip_white and friends. After calling anything else, check _failed.
+	struct Parser
+	{
+		Parser(const char* str, size_t length, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info, ParseHandler& handler);
+
+		// The character i steps ahead, or zero past the end of the input.
+		char at(size_t i) const
+		{
+			return i < static_cast<size_t>(_end - _ptr) ? _ptr[i] : '\0';
+		}
+
+		bool skip_white(Comments* out_comments, int& out_indentation, bool break_on_newline);
+		bool skip_white_ignore_comments()
+		{
+			int indentation;
+			return skip_white(nullptr, indentation, false);
+		}
+
+		bool skip_pre_white(Comments& out_comments, int& out_indentation)
+		{
+			if (!MAYBE_WHITE[static_cast<uint8_t>(at(0))]) {
+				// Early out
+				out_indentation = -1;
+				return false;
+			}
+
+			return skip_white(_options.keep_comments ? &out_comments : nullptr, out_indentation, false);
+		}
+
+		bool skip_post_white(Comments& out_comments)
+		{
+			if (!MAYBE_WHITE[static_cast<uint8_t>(at(0))]) {
+				// Early out
+				return false;
+			}
+
+			int indentation;
+			return skip_white(_options.keep_comments ? &out_comments : nullptr, indentation, true);
+		}
+
+		bool top_level();
+
+		// Parse lazily: arrays/objects in the top-level value are recorded as ranges of source.
+		void set_lazy_source(std::shared_ptr<const LazySource> source) { _lazy_source = std::move(source); }
+
+		// Parses the array/object of a range with top_level().
+		bool parse_range(const LazyRange& range);
+
+		// top_level() is begin_top_level(), then parse_step() until it returns false, then end_top_level().
+		// Each step parses one entry of the innermost open array/object, or closes it.
+		// A step only moves the read position until it has done everything that can fail.
+		// Then it reports what it found to the handler, so the IncrementalParser can
+		// roll back a step that ran out of input and retry it later.
+		bool begin_top_level();
+		bool parse_step();
+		bool end_top_level();
+
+		enum ScalarKind { ScalarValue, ScalarString, ScalarInclude };
+		ScalarKind parse_scalar(Config& dst);
+		bool parse_key();
+		bool parse_float(Config& out);
+		bool parse_finite_number(Config& dst);
+		bool parse_string(std::string& out);
+		bool parse_c_sharp_string(std::string& out);
+		bool parse_hex(int count, uint64_t& out);
+		bool parse_macro(Config& dst);
+
+		void tag(Config& var)
+		{
+			_tagger.tag(var, _line_nr);
+		}
+
+		State get_state() const
+		{
+			return { _ptr, _line_nr, _line_start, column_offset() };
+		}
+
+		void set_state(State s) {
+			_ptr                = s.ptr;
+			_line_nr            = s.line_nr;
+			_line_start         = s.line_start;
+			_column_offset      = s.column_offset;
+			_column_offset_line = s.line_nr;
+		}
+
+		// Only for the line it was set on, so a new line need not reset it.
+		Index column_offset() const
+		{
+			return _line_nr == _column_offset_line ? _column_offset : 0;
+		}
+
+		Index column() const
+		{
+			return static_cast<unsigned>(_ptr - _line_start + 1) + column_offset();
+		}
+
+		const char* start_of_line() const
+		{
+			return _line_start;
 		}
 
 		const char* end_of_line() const
 		{
-			const char* p = _ptr;
-			while (*p && *p != '\r' && *p != '\n') {
-				++p;
+			const char* p = _ptr;
+			while (p != _end && *p && *p != '\r' && *p != '\n') {
+				++p;
+			}
+			return p;
+		}
+
+		// Records the error at the current position, unless there already is one.
+		void fail(const std::string& desc) {
+			if (_failed) { return; }
+
+			const char* sol = start_of_line();
+			const char* eol = end_of_line();
+			std::string orientation = column_offset() != 0 ? "..." : ""; // The start of the line is gone
+			for (const char* p = sol; p != eol; ++p) {
+				if (*p == '\t') {
+					orientation += "    ";
+				} else {
+					orientation.push_back(*p);
+				}
+			}
+
+			orientation += "\n";
+			orientation.append(column_offset() != 0 ? 3 : 0, ' ');
+			for (const char* p = sol; p != _ptr; ++p) {
+				if (*p == '\t') {
+					orientation += "    ";
+				} else {
+					orientation.push_back(' ');
+				}
+			}
+			orientation += "^";
+
+			_failed = true;
+			_failure.doc         = _doc;
+			_failure.line        = _line_nr;
+			_failure.column      = column();
+			_failure.description = desc + "\n" + orientation;
+		}
+
+		// Returns false if this is an error.
+		bool check_indentation(int found_tabs, int expected_tabs) {
+			if (_options.enforce_indentation) {
+				char buff[128];
+				snprintf(buff, sizeof(buff), "Bad indentation: expected %d tabs, found %d", found_tabs, expected_tabs);
+				fail(buff);
+				return false;
+			}
+			return true;
+		}
+
+		// Returns b.
+		bool parse_assert(bool b, const char* error_msg) {
+			if (!b) {
+				fail(error_msg);
+			}
+			return b;
+		}
+
+		bool parse_assert(bool b, const char* error_msg, const State& error_state) {
+			if (!b) {
+				set_state(error_state);
+				fail(error_msg);
+			}
+			return b;
+		}
+
+		bool swallow(char c) {
+			if (at(0) == c) {
+				_ptr += 1;
+				return true;
+			} else {
+				fail("Expected " + quote(c));
+				return false;
+			}
+		}
+
+		// True if the input continues with the n characters of str.
+		bool looking_at(const char* str, size_t n) const
+		{
+			return static_cast<size_t>(_end - _ptr) >= n && memcmp(_ptr, str, n) == 0;
+		}
+
+		bool try_swallow(const char* str) {
+			auto n = strlen(str);
+			if (looking_at(str, n)) {
+				_ptr += n;
+				return true;
+			} else {
+				return false;
+			}
+		}
+
+		bool swallow(const char* str, const char* error_msg) {
+			return parse_assert(try_swallow(str), error_msg);
+		}
+
+		bool is_reserved_identifier() const
+		{
+			if (looking_at("true", 4) || looking_at("null", 4)) {
+				return !IDENT_CHARS[static_cast<uint8_t>(at(4))];
+			} else if (looking_at("false", 5)) {
+				return !IDENT_CHARS[static_cast<uint8_t>(at(5))];
+			} else {
+				return false;
+			}
+		}
+
+		bool                failed()  const { return _failed; }
+		const ParseFailure& failure() const { return _failure; }
+
+		// ------------------------------------------------
+		// For IncrementalParser:
+
+		// A step failed because it came too close to the end of the input received so far.
+		bool needs_more_input() const { return _needs_more_input; }
+
+		struct Checkpoint
+		{
+			State state;
+			int   indentation;
+		};
+
+		// More input has arrived. Steps will not finish closer than min_lookahead bytes to the new end.
+		void set_input_end(const char* end, size_t min_lookahead)
+		{
+			_end           = end;
+			_min_lookahead = min_lookahead;
+			_log_includes  = true;
+		}
+
+		// The input before release_end is about to go. Copies the lines of the open arrays/objects that are all in it.
+		void keep_open_lines(const char* release_end);
+
+		// The input from old_begin on was moved to new_begin. What was before old_begin is gone.
+		void relocate(const char* old_begin, const char* new_begin);
+
+		Checkpoint checkpoint()
+		{
+			_include_log.clear();
+			return { get_state(), _indentation };
+		}
+
+		void restore(const Checkpoint& checkpoint);
+
+		const char* position() const { return _ptr; }
+
+	private:
+		// An array or object that we have not yet seen the end of.
+		struct Frame
+		{
+			bool     is_object;
+			bool     is_top;               // The implicit top-level array/object, without braces
+			State    open_state;           // Where the opening brace is
+			Comments next_prefix_comments; // Comments before the next entry
+
+			// Once the input of its line is released, open_state points into this copy of the line
+			// (see keep_open_lines), so that "Non-terminated object" still shows the right one.
+			std::unique_ptr<std::string> open_line;
+		};
+
+		// What follows an entry in an array/object.
+		struct EntryEnd
+		{
+			Comments postfix;
+			Comments next_prefix;
+		};
+
+		struct IncludeLogEntry
+		{
+			std::string path;
+			bool        was_new;
+		};
+
+		bool skip_container();
+		bool skip_json_container();
+		bool skip_quoted();
+		bool skip_block_comment();
+
+		bool close_frame(const Comments& pre_end_brace);
+		EntryEnd parse_entry_end(const Frame& frame);
+		void end_entry(Frame& frame, EntryEnd&& end);
+		void report_comments(ParseHandler::CommentKind kind, const Comments& comments);
+		void report_scalar(ScalarKind kind, Index line, Config& value);
+
+		// How many arrays/objects we are in, counting a top-level object without braces.
+		size_t depth() const
+		{
+			return _depth_offset + _frames.size() - 1 + (_frames[0].is_object ? 1 : 0);
+		}
+
+		// Returns false (and fails) if we are too close to the end of the input received so far.
+		bool check_progress()
+		{
+			if (static_cast<size_t>(_end - _ptr) < _min_lookahead) {
+				_failed           = true;
+				_needs_more_input = true;
+				return false;
+			}
+			return true;
+		}
+
+		const FormatOptions& _options;
+		DocInfo_SP           _doc;
+		DocTagger            _tagger;
+		ParseInfo&           _info;
+		ParseHandler&        _handler;
+		std::shared_ptr<const LazySource> _lazy_source; // Set iff we parse lazily
+		bool                 _json_strings_only;  // Only "-strings (no comments) can hide brackets, so skip_json_container works
+		std::vector<Frame>   _frames;             // The arrays/objects we are in, outermost first
+		size_t               _num_top_values = 0; // Entries of the top-level array/object so far
+		size_t               _depth_offset   = 0; // Arrays/objects around the LazyRange we parse
+		size_t               _min_lookahead = 0;
+		bool                 _log_includes  = false;
+		std::vector<IncludeLogEntry> _include_log; // #includes since the last checkpoint
+		bool                 _failed           = false;
+		bool                 _needs_more_input = false;
+		ParseFailure         _failure;
+
+		const char*          _ptr;
+		const char*          _end;     // We never read at or past this
+		Index                _line_nr;
+		const char*          _line_start;
+		Index                _column_offset      = 0;         // See State::column_offset
+		Index                _column_offset_line = BAD_INDEX; // The line _column_offset is for
+		int                  _indentation = 0; // Expected number of tabs between a \n and the next key/value
+		char                 _indent_char = 0; // Set iff _options.indentation is one character repeated _indent_size times
+		size_t               _indent_size = 0;
+	};
+
+	// --------------------------------------------
+
+	Parser::Parser(const char* str, size_t length, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info, ParseHandler& handler)
+		: _options(options), _doc(doc), _tagger(doc), _info(info), _handler(handler)
+	{
+		_json_strings_only = !options.single_line_comments && !options.block_comments &&
+		                     !options.str_csharp_verbatim && !options.str_python_multiline;
+
+		_line_nr    = 1;
+		_ptr        = str;
+		_end        = str + length;
+		_line_start = str;
+
+		CONFIGURU_ASSERT(_options.indentation != "" || !_options.enforce_indentation);
+
+		const std::string& indentation = _options.indentation;
+		if (!indentation.empty() && indentation.find_first_not_of(indentation[0]) == std::string::npos) {
+			_indent_char = indentation[0];
+			_indent_size = indentation.size();
+		}
+	}
+
+	// Returns true if we did skip white-space.
+	// out_indentation is the depth of indentation on the last line we did skip on.
+	// iff out_indentation is -1 there is a non-tab on the last line.
+	bool Parser::skip_white(Comments* out_comments, int& out_indentation, bool break_on_newline)
+	{
+		auto start_ptr = _ptr;
+		out_indentation = 0;
+		bool found_newline = false;
+
+		const std::string& indentation = _options.indentation;
+
+		while (MAYBE_WHITE[static_cast<uint8_t>(at(0))]) {
+			if (at(0) == _indent_char) {
+				// Swallow whole levels of indentation at once:
+				const size_t levels = count_run(_ptr, _end, _indent_char) / _indent_size;
+				if (levels > 0) {
+					_ptr += _indent_size;
+					if (_options.enforce_indentation && _indent_char == '\t') {
+						if (!parse_assert(out_indentation != -1, "Tabs should only occur on the start of a line!")) { return false; }
+					}
+					_ptr += (levels - 1) * _indent_size;
+					out_indentation += static_cast<int>(levels);
+					continue;
+				}
+			}
+
+			if (at(0) == '\n') {
+				// Unix style newline
+				if (break_on_newline) {
+					_ptr += 1;
+					_line_nr += 1;
+					_line_start = _ptr;
+					out_indentation = 0;
+					return true;
+				}
+				// Swallow runs of empty lines at once:
+				const size_t num_newlines = count_run(_ptr, _end, '\n');
+				_ptr += num_newlines;
+				_line_nr += static_cast<Index>(num_newlines);
+				_line_start = _ptr;
+				out_indentation = 0;
+				found_newline = true;
+			}
+			else if (at(0) == '\r') {
+				// CR-LF - windows style newline
+				if (!parse_assert(at(1) == '\n', "CR with no LF. \\r only allowed before \\n.")) { return false; } // TODO: this is OK in JSON.
+				_ptr += 2;
+				_line_nr += 1;
+				_line_start = _ptr;
+				out_indentation = 0;
+				if (break_on_newline) { return true; }
+				found_newline = true;
+			}
+			else if (_indent_char == 0 && !indentation.empty() &&
+					 looking_at(indentation.c_str(), indentation.size()))
+			{
+				_ptr += indentation.size();
+				if (_options.enforce_indentation && indentation == "\t") {
+					if (!parse_assert(out_indentation != -1, "Tabs should only occur on the start of a line!")) { return false; }
+				}
+				++out_indentation;
+			}
+			else if (at(0) == '\t') {
+				++_ptr;
+				if (_options.enforce_indentation) {
+					if (!parse_assert(out_indentation != -1, "Tabs should only occur on the start of a line!")) { return false; }
+				}
+				const size_t more_tabs = count_run(_ptr, _end, '\t');
+				_ptr += more_tabs;
+				out_indentation += 1 + static_cast<int>(more_tabs);
+			}
+			else if (at(0) == ' ') {
+				if (found_newline && _options.enforce_indentation) {
+					if (indentation == "\t") {
+						fail("Found a space at beginning of a line. Indentation must be done using tabs!");
+					} else {
+						fail("Indentation should be a multiple of " + std::to_string(indentation.size()) + " spaces.");
+					}
+					return false;
+				}
+				_ptr += count_run(_ptr, _end, ' ');
+				out_indentation = -1;
+			}
+			else if (at(0) == '/' && at(1) == '/') {
+				if (!parse_assert(_options.single_line_comments, "Single line comments forbidden.")) { return false; }
+				// Single line comment
+				auto start = _ptr;
+				_ptr = find_first_of<'\n', '\0'>(_ptr + 2, _end);
+				if (out_comments) { out_comments->emplace_back(start, _ptr - start); }
+				out_indentation = 0;
+				if (break_on_newline) { return true; }
+			}
+			else if (at(0) == '/' && at(1) == '*') {
+				if (!parse_assert(_options.block_comments, "Block comments forbidden.")) { return false; }
+				// Multi-line comment
+				auto state = get_state(); // So we can point out the start if there's an error
+				_ptr += 2;
+				unsigned nesting = 1; // We allow nested /**/ comments
+				do
+				{
+					_ptr = find_first_of<'/', '*', '\n', '\0'>(_ptr, _end);
+					if (at(0)==0) {
+						set_state(state);
+						fail("Non-ending /* comment");
+						return false;
+					}
+					else if (at(0)=='/' && at(1)=='*') {
+						_ptr += 2;
+						if (!parse_assert(_options.nesting_block_comments, "Nesting comments (/* /* */ */) forbidden.")) { return false; }
+						nesting += 1;
+					}
+					else if (at(0)=='*' && at(1)=='/') {
+						_ptr += 2;
+						nesting -= 1;
+					}
+					else if (at(0) == '\n') {
+						_ptr += 1;
+						_line_nr += 1;
+						_line_start = _ptr;
+					} else {
+						_ptr += 1;
+					}
+				} while (nesting > 0);
+				if (out_comments) { out_comments->emplace_back(state.ptr, _ptr - state.ptr); }
+				out_indentation = -1;
+				if (break_on_newline) { return true; }
+			}
+			else {
+				break;
+			}
+		}
+
+		if (start_ptr == _ptr) {
+			out_indentation = -1;
+			return false;
+		} else {
+			return true;
+		}
+	}
+
+	bool Parser::top_level()
+	{
+		if (!begin_top_level()) { return false; }
+		while (parse_step()) {}
+		return !_failed && end_top_level();
+	}
+
+	bool Parser::parse_range(const LazyRange& range)
+	{
+		set_state(range.open_state);
+		_end          = range.end;
+		_indentation  = range.indentation;
+		_depth_offset = range.depth;
+		return top_level();
+	}
+
+	/*
+	The top-level can be any value, OR the innerds of an object:
+	foo = 1
+	"bar": 2
+	*/
+	bool Parser::begin_top_level()
+	{
+		bool is_object = false;
+
+		if (_options.implicit_top_object)
+		{
+			auto state = get_state();
+			skip_white_ignore_comments();
+			if (_failed) { return false; }
+
+			if (IDENT_STARTERS[static_cast<uint8_t>(at(0))] && !is_reserved_identifier()) {
+				is_object = true;
+			} else if (at(0) == '"' || at(0) == '@') {
+				if (!parse_string(_info.value_scratch)) { return false; }
+				skip_white_ignore_comments();
+				if (_failed) { return false; }
+				is_object = (at(0) == ':' || at(0) == '=');
+			}
+
+			if (!check_progress()) { return false; } // We looked this far ahead
+			set_state(state); // restore
+		}
+
+		Frame top;
+		top.is_object  = is_object;
+		top.is_top     = true;
+		top.open_state = get_state();
+		_frames.push_back(std::move(top));
+		_num_top_values = 0;
+
+		if (is_object) {
+			_handler.begin_object(_line_nr);
+		}
+		return true;
+	}
+
+	bool Parser::end_top_level()
+	{
+		const bool is_object = _frames.back().is_object;
+		_frames.pop_back();
+
+		if (!is_object) {
+			if (!parse_assert(_num_top_values <= 1 || _options.implicit_top_array, "Multiple values not allowed without enclosing []")) {
+				return false;
+			}
+		}
+
+		if (!parse_assert(_ptr == _end, "Expected EoF")) { return false; }
+
+		if (!is_object && _num_top_values == 0 && !_options.empty_file) {
+			fail("Empty file");
+			return false;
+		}
+		return true;
+	}
+
+	bool Parser::parse_step()
+	{
+		Frame& frame = _frames.back();
+		const char closing_brace = frame.is_object ? '}' : ']';
+
+		Comments prefix = frame.next_prefix_comments;
+		int line_indentation;
+		skip_pre_white(prefix, line_indentation);
+		if (_failed) { return false; }
+
+		if (at(0) == closing_brace || !at(0)) {
+			if (at(0) == closing_brace && line_indentation >= 0 && _indentation - 1 != line_indentation) {
+				if (!check_indentation(_indentation - 1, line_indentation)) { return false; }
+			}
+			return close_frame(prefix);
+		}
+
+		if (line_indentation >= 0 && _indentation != line_indentation) {
+			if (!check_indentation(_indentation, line_indentation)) { return false; }
+		}
+
+		if (frame.is_object) {
+			if (!parse_key()) { return false; }
+		} else if (IDENT_STARTERS[static_cast<uint8_t>(at(0))] && !is_reserved_identifier()) {
+			fail("Found identifier; expected value. Did you mean to use a {object} rather than a [array]?");
+			return false;
+		}
+
+		skip_pre_white(prefix, line_indentation);
+		if (_failed) { return false; }
+		const Index line = _line_nr;
+
+		if (line_indentation >= 0 && _indentation - 1 != line_indentation) {
+			if (!check_indentation(_indentation - 1, line_indentation)) { return false; }
+		}
+
+		if ((at(0) == '{' || at(0) == '[') && _options.max_depth != 0 && depth() >= _options.max_depth) {
+			fail("More than " + std::to_string(_options.max_depth) + " arrays/objects inside of each other (see FormatOptions::max_depth)");
+			return false;
+		}
+
+		// Unless this is the value of the whole document:
+		if (_lazy_source && (at(0) == '{' || at(0) == '[') && !(frame.is_top && !frame.is_object)) {
+			const State open_state = get_state();
+			const int indentation = _indentation;
+			if (_json_strings_only ? skip_json_container() : skip_container()) {
+				Config value;
+				value.make_lazy(*open_state.ptr == '{', std::make_shared<LazyRange>(
+					LazyRange{_lazy_source, open_state, _ptr, indentation, depth()}));
+				_tagger.tag(value, line);
+				EntryEnd end = parse_entry_end(frame);
+				if (_failed || !check_progress()) { return false; }
+
+				report_comments(ParseHandler::Prefix, prefix);
+				if (frame.is_object) {
+					_handler.key(_info.key_scratch);
+				}
+				_handler.config_value(line, std::move(value));
+				end_entry(frame, std::move(end));
+				return true;
+			}
+			// Let the full parse find the error:
+			set_state(open_state);
+		}
+
+		if (at(0) == '{' || at(0) == '[') {
+			Frame nested;
+			nested.is_object  = at(0) == '{';
+			nested.is_top     = false;
+			nested.open_state = get_state();
+			_ptr += 1;
+			_indentation += 1;
+			if (!check_progress()) { return false; }
+
+			frame.next_prefix_comments.clear();
+			report_comments(ParseHandler::Prefix, prefix);
+			if (frame.is_object) {
+				_handler.key(_info.key_scratch);
+			}
+			if (nested.is_object) {
+				_handler.begin_object(line);
+			} else {
+				_handler.begin_array(line);
+			}
+			_frames.push_back(std::move(nested)); // Invalidates frame
+			return true;
+		}
+
+		Config value;
+		const ScalarKind kind = parse_scalar(value);
+		if (_failed) { return false; }
+		EntryEnd end = parse_entry_end(frame);
+		if (_failed || !check_progress()) { return false; }
+
+		report_comments(ParseHandler::Prefix, prefix);
+		if (frame.is_object) {
+			_handler.key(_info.key_scratch);
+		}
+		report_scalar(kind, line, value);
+		end_entry(frame, std::move(end));
+		return true;
+	}
+
+	// We are at the closing brace (or end) of the innermost frame.
+	// Returns false if that is the top-level frame.
+	bool Parser::close_frame(const Comments& pre_end_brace)
+	{
+		Frame& frame = _frames.back();
+
+		if (frame.is_top) {
+			if (!check_progress()) { return false; }
+			report_comments(ParseHandler::PreEndBrace, pre_end_brace);
+			if (frame.is_object) {
+				_handler.end_object();
+			}
+			frame.next_prefix_comments.clear();
+			return false;
+		}
+
+		_indentation -= 1;
+
+		if (at(0) == (frame.is_object ? '}' : ']')) {
+			_ptr += 1;
+		} else {
+			set_state(frame.open_state);
+			fail(frame.is_object ? "Non-terminated object" : "Non-terminated array");
+			return false;
+		}
+
+		Frame& parent = _frames[_frames.size() - 2];
+		EntryEnd end = parse_entry_end(parent);
+		if (_failed || !check_progress()) { return false; }
+
+		report_comments(ParseHandler::PreEndBrace, pre_end_brace);
+		if (frame.is_object) {
+			_handler.end_object();
+		} else {
+			_handler.end_array();
+		}
+		_frames.pop_back(); // Invalidates frame, but not parent
+		end_entry(parent, std::move(end));
+		return true;
+	}
+
+	Parser::EntryEnd Parser::parse_entry_end(const Frame& frame)
+	{
+		const char closing_brace = frame.is_object ? '}' : ']';
+
+		EntryEnd end;
+		bool has_separator = skip_post_white(end.postfix);
+		if (_failed) { return end; }
+		int ignore;
+		skip_white(_options.keep_comments ? &end.next_prefix : nullptr, ignore, false);
+		if (_failed) { return end; }
+
+		auto comma_state = get_state();
+		bool has_comma = at(0) == ',';
+
+		if (has_comma) {
+			_ptr += 1;
+			skip_post_white(end.postfix);
+			if (_failed) { return end; }
+			has_separator = true;
+		}
+
+		bool is_last_element = !at(0) || at(0) == closing_brace;
+
+		if (is_last_element) {
+			parse_assert(!has_comma || (frame.is_object ? _options.object_trailing_comma : _options.array_trailing_comma),
+				"Trailing comma forbidden.", comma_state);
+		} else if (frame.is_object) {
+			if (_options.object_omit_comma) {
+				parse_assert(has_separator, "Expected a space, newline, comma or }");
+			} else {
+				parse_assert(has_comma, "Expected a comma or }");
+			}
+		} else {
+			if (_options.array_omit_comma) {
+				parse_assert(has_separator, "Expected a space, newline, comma or ]");
+			} else {
+				parse_assert(has_comma, "Expected a comma or ]");
+			}
+		}
+
+		return end;
+	}
+
+	// From the opening brace we are at, to past the matching closing brace.
+	// Only strings and comments are looked at, so the contents may still be malformed.
+	// Returns false if there is no matching brace, or if a string or comment is malformed.
+	bool Parser::skip_container()
+	{
+		unsigned depth = 0;
+		for (;;) {
+			_ptr = find_first_of<'{', '}', '[', ']', '"', '/', '\n', '\0'>(_ptr, _end);
+			const char c = at(0);
+			if (c == '{' || c == '[') {
+				_ptr += 1;
+				depth += 1;
+			} else if (c == '}' || c == ']') {
+				_ptr += 1;
+				depth -= 1;
+				if (depth == 0) { return true; }
+			} else if (c == '\n') {
+				_ptr += 1;
+				_line_nr += 1;
+				_line_start = _ptr;
+			} else if (c == '"') {
+				if (!skip_quoted()) { return false; }
+			} else if (c == '/' && at(1) == '/') {
+				_ptr = find_first_of<'\n', '\0'>(_ptr + 2, _end);
+			} else if (c == '/' && at(1) == '*') {
+				if (!skip_block_comment()) { return false; }
+			} else if (c == '/') {
+				_ptr += 1;
+			} else {
+				return false; // End of input
+			}
+		}
+	}
+
+	// skip_container for when there are no comments, nor strings other than "-strings.
+	// Looks at 64 bytes at a time, finding the brackets outside of strings with bit masks.
+	bool Parser::skip_json_container()
+	{
+		const char* begin   = _ptr;
+		unsigned depth      = 0;
+		uint64_t escape_first = 0;
+		uint64_t in_string    = 0; // All ones if the block starts inside of a string
+
+		const auto misalignment = static_cast<unsigned>(reinterpret_cast<uintptr_t>(begin) % 64);
+		for (const char* block = begin - misalignment; block < _end; block += 64) {
+			const BlockMasks m = block_masks(block, begin, _end);
+
+			const uint64_t quotes = m.quote & ~escaped_bytes(m.backslash, escape_first);
+			const uint64_t string_bytes = prefix_xor(quotes) ^ in_string;
+			in_string = static_cast<uint64_t>(static_cast<int64_t>(string_bytes) >> 63);
+
+			if ((m.newline & string_bytes) != 0 || m.zero != 0) {
+				return false; // Let the full parse report it
+			}
+
+			const uint64_t opens  = m.open  & ~string_bytes;
+			const uint64_t closes = m.close & ~string_bytes;
+			uint64_t newlines = m.newline;
+
+			if (popcount64(closes) >= depth) {
+				// We may reach the end in this block:
+				uint64_t brackets = opens | closes;
+				while (brackets != 0) {
+					const unsigned i = lowest_bit_index64(brackets);
+					const uint64_t bit = uint64_t(1) << i;
+					if (opens & bit) {
+						depth += 1;
+					} else if (--depth == 0) {
+						newlines &= bit - 1;
+						_ptr = block + i + 1;
+						_line_nr += popcount64(newlines);
+						if (newlines != 0) {
+							_line_start = block + highest_bit_index64(newlines) + 1;
+						}
+						return true;
+					}
+					brackets &= brackets - 1;
+				}
+			} else {
+				depth = depth + popcount64(opens) - popcount64(closes);
+			}
+
+			_line_nr += popcount64(newlines);
+			if (newlines != 0) {
+				_line_start = block + highest_bit_index64(newlines) + 1;
 			}
-			return p;
 		}
+		return false;
+	}
 
-		void throw_error(const std::string& desc) CONFIGURU_NORETURN {
-			const char* sol = start_of_line();
-			const char* eol = end_of_line();
-			std::string orientation;
-			for (const char* p = sol; p != eol; ++p) {
-				if (*p == '\t') {
-					orientation += "    ";
+	// Like parse_string, without decoding anything.
+	bool Parser::skip_quoted()
+	{
+		if (_ptr[-1] == '@') {
+			// C# style verbatim string
+			_ptr += 1;
+			for (;;) {
+				_ptr = find_first_of<'"', '\n', '\0'>(_ptr, _end);
+				if (at(0) == '"' && at(1) == '"') {
+					_ptr += 2;
+				} else if (at(0) == '"') {
+					_ptr += 1;
+					return true;
+				} else if (at(0) == '\n') {
+					_ptr += 1;
+					_line_nr += 1;
+					_line_start = _ptr;
 				} else {
-					orientation.push_back(*p);
+					return false;
+				}
+			}
+		} else if (at(1) == '"' && at(2) == '"') {
+			// Python style multiline string
+			_ptr += 3;
+			for (;;) {
+				_ptr = find_first_of<'"', '\n', '\0'>(_ptr, _end);
+				if (at(0) == '"' && at(1) == '"' && at(2) == '"' && at(3) != '"') {
+					_ptr += 3;
+					return true;
+				} else if (at(0) == '"') {
+					_ptr += 1;
+				} else if (at(0) == '\n') {
+					_ptr += 1;
+					_line_nr += 1;
+					_line_start = _ptr;
+				} else {
+					return false;
+				}
+			}
+		} else {
+			_ptr += 1;
+			for (;;) {
+				_ptr = find_first_of<'"', '\\', '\n', '\0'>(_ptr, _end);
+				if (at(0) == '"') {
+					_ptr += 1;
+					return true;
+				} else if (at(0) == '\\' && at(1) != 0) {
+					_ptr += 2;
+				} else {
+					return false; // Newlines are not allowed in strings
+				}
+			}
+		}
+	}
+
+	// Like the comment part of skip_white, without collecting the comment.
+	bool Parser::skip_block_comment()
+	{
+		_ptr += 2;
+		unsigned nesting = 1;
+		do {
+			_ptr = find_first_of<'/', '*', '\n', '\0'>(_ptr, _end);
+			if (at(0) == '/' && at(1) == '*') {
+				if (!_options.nesting_block_comments) { return false; }
+				_ptr += 2;
+				nesting += 1;
+			} else if (at(0) == '*' && at(1) == '/') {
+				_ptr += 2;
+				nesting -= 1;
+			} else if (at(0) == '\n') {
+				_ptr += 1;
+				_line_nr += 1;
+				_line_start = _ptr;
+			} else if (at(0) == 0) {
+				return false;
+			} else {
+				_ptr += 1;
+			}
+		} while (nesting > 0);
+		return true;
+	}
+
+	// An entry has been reported - report what follows it.
+	void Parser::end_entry(Frame& frame, EntryEnd&& end)
+	{
+		report_comments(ParseHandler::Postfix, end.postfix);
+		frame.next_prefix_comments = std::move(end.next_prefix);
+		if (frame.is_top) {
+			_num_top_values += 1;
+		}
+	}
+
+	void Parser::report_comments(ParseHandler::CommentKind kind, const Comments& comments)
+	{
+		for (const auto& comment : comments) {
+			_handler.comment(kind, comment);
+		}
+	}
+
+	void Parser::report_scalar(ScalarKind kind, Index line, Config& value)
+	{
+		if (kind == ScalarString) {
+			_handler.string_value(line, _info.value_scratch);
+		} else if (kind == ScalarInclude) {
+			_handler.config_value(line, std::move(value));
+		} else if (value.is_null()) {
+			_handler.null_value(line);
+		} else if (value.is_bool()) {
+			_handler.bool_value(line, value.as_bool());
+		} else if (value.is_int()) {
+			_handler.int_value(line, value.as_integer<int64_t>());
+		} else {
+			_handler.float_value(line, value.as_double());
+		}
+	}
+
+	// Parses the key and the colon (or equivalent) of an object entry into _info.key_scratch.
+	bool Parser::parse_key()
+	{
+		auto pre_key_state = get_state();
+		std::string& key = _info.key_scratch;
+
+		if (IDENT_STARTERS[static_cast<uint8_t>(at(0))] && !is_reserved_identifier()) {
+			if (!parse_assert(_options.identifiers_keys, "You need to surround keys with quotes")) { return false; }
+			const char* start = _ptr;
+			while (IDENT_CHARS[static_cast<uint8_t>(at(0))]) {
+				_ptr += 1;
+			}
+			key.assign(start, _ptr);
+		}
+		else if (at(0) == '"' || at(0) == '@') {
+			if (!parse_string(key)) { return false; }
+		} else {
+			fail("Object key expected (either an identifier or a quoted string), got " + quote(at(0)));
+			return false;
+		}
+
+		if (!_options.object_duplicate_keys) {
+			std::string where;
+			if (_handler.is_duplicate_key(key, where)) {
+				set_state(pre_key_state);
+				fail("Duplicate key: \"" + key + "\". Already set at " + where);
+				return false;
+			}
+		}
+
+		bool space_after_key = skip_white_ignore_comments();
+		if (_failed) { return false; }
+
+		if (at(0) == ':' || (_options.object_separator_equal && at(0) == '=')) {
+			if (!parse_assert(_options.allow_space_before_colon || at(0) != ':' || !space_after_key, "No space allowed before colon")) {
+				return false;
+			}
+			_ptr += 1;
+			skip_white_ignore_comments();
+			return !_failed;
+		} else if (_options.omit_colon_before_object && (at(0) == '{' || at(0) == '#')) {
+			// Ok to omit : in this case
+			return true;
+		} else {
+			if (_options.object_separator_equal && _options.omit_colon_before_object) {
+				fail("Expected one of '=', ':', '{' or '#' after object key");
+			} else {
+				fail("Expected : after object key");
+			}
+			return false;
+		}
+	}
+
+	// Any value but an array or object. Strings are put in _info.value_scratch, anything else in dst.
+	Parser::ScalarKind Parser::parse_scalar(Config& dst)
+	{
+		if (at(0) == '"' || at(0) == '@') {
+			parse_string(_info.value_scratch);
+			return ScalarString;
+		}
+		else if (at(0) == 'n') {
+			if (!parse_assert(at(1)=='u' && at(2)=='l' && at(3)=='l', "Expected 'null'")) { return ScalarValue; }
+			if (!parse_assert(!IDENT_CHARS[static_cast<uint8_t>(at(4))], "Expected 'null'")) { return ScalarValue; }
+			_ptr += 4;
+			dst = nullptr;
+		}
+		else if (at(0) == 't') {
+			if (!parse_assert(at(1)=='r' && at(2)=='u' && at(3)=='e', "Expected 'true'")) { return ScalarValue; }
+			if (!parse_assert(!IDENT_CHARS[static_cast<uint8_t>(at(4))], "Expected 'true'")) { return ScalarValue; }
+			_ptr += 4;
+			dst = true;
+		}
+		else if (at(0) == 'f') {
+			if (!parse_assert(at(1)=='a' && at(2)=='l' && at(3)=='s' && at(4)=='e', "Expected 'false'")) { return ScalarValue; }
+			if (!parse_assert(!IDENT_CHARS[static_cast<uint8_t>(at(5))], "Expected 'false'")) { return ScalarValue; }
+			_ptr += 5;
+			dst = false;
+		}
+		else if (at(0) == '#') {
+			parse_macro(dst);
+			return ScalarInclude;
+		}
+		else if (at(0) == '+' || at(0) == '-' || at(0) == '.' || ('0' <= at(0) && at(0) <= '9')) {
+			// Some kind of number:
+
+			if (at(0) == '-' && at(1) == 'i' && at(2)=='n' && at(3)=='f') {
+				if (!parse_assert(!IDENT_CHARS[static_cast<uint8_t>(at(4))], "Expected -inf")) { return ScalarValue; }
+				if (!parse_assert(_options.inf, "infinity forbidden.")) { return ScalarValue; }
+				_ptr += 4;
+				dst = -std::numeric_limits<double>::infinity();
+			}
+			else if (at(0) == '+' && at(1) == 'i' && at(2)=='n' && at(3)=='f') {
+				if (!parse_assert(!IDENT_CHARS[static_cast<uint8_t>(at(4))], "Expected +inf")) { return ScalarValue; }
+				if (!parse_assert(_options.inf, "infinity forbidden.")) { return ScalarValue; }
+				_ptr += 4;
+				dst = std::numeric_limits<double>::infinity();
+			}
+			else if (at(0) == '+' && at(1) == 'N' && at(2)=='a' && at(3)=='N') {
+				if (!parse_assert(!IDENT_CHARS[static_cast<uint8_t>(at(4))], "Expected +NaN")) { return ScalarValue; }
+				if (!parse_assert(_options.nan, "NaN (Not a Number) forbidden.")) { return ScalarValue; }
+				_ptr += 4;
+				dst = std::numeric_limits<double>::quiet_NaN();
+			} else {
+				parse_finite_number(dst);
+			}
+		} else {
+			fail("Expected value");
+		}
+		return ScalarValue;
+	}
+
+	void Parser::relocate(const char* old_begin, const char* new_begin)
+	{
+		auto move = [=](State& s) {
+			if (s.line_start < old_begin) {
+				// Keep the column right for error messages:
+				const char* kept = s.ptr < old_begin ? s.ptr : old_begin;
+				s.column_offset += static_cast<Index>(kept - s.line_start);
+				s.line_start = old_begin;
+				if (s.ptr < old_begin) { s.ptr = old_begin; }
+			}
+			s.ptr        = new_begin + (s.ptr - old_begin);
+			s.line_start = new_begin + (s.line_start - old_begin);
+		};
+		State state = get_state();
+		move(state);
+		set_state(state);
+		_end = new_begin + (_end - old_begin);
+		for (auto& frame : _frames) {
+			if (!frame.open_line) { // Else apart from the input
+				move(frame.open_state);
+			}
+		}
+	}
+
+	void Parser::keep_open_lines(const char* release_end)
+	{
+		for (auto& frame : _frames) {
+			if (frame.open_line) { continue; }
+			State& s = frame.open_state;
+			const char* eol = s.line_start;
+			while (eol < release_end && *eol != '\n' && *eol != '\r') { ++eol; }
+			if (eol < release_end) {
+				frame.open_line.reset(new std::string(s.line_start, eol));
+				s.ptr        = frame.open_line->data() + (s.ptr - s.line_start);
+				s.line_start = frame.open_line->data();
+			}
+		}
+	}
+
+	void Parser::restore(const Checkpoint& checkpoint)
+	{
+		set_state(checkpoint.state);
+		_indentation      = checkpoint.indentation;
+		_failed           = false;
+		_needs_more_input = false;
+
+		// Undo the bookkeeping of #includes we parsed since:
+		for (auto it = _include_log.rbegin(); it != _include_log.rend(); ++it) {
+			if (it->was_new) {
+				_info.parsed_files.erase(it->path);
+			} else {
+				if (auto doc = _info.parsed_files[it->path].doc()) {
+					doc->includers.pop_back();
+				}
+			}
+		}
+		_include_log.clear();
+	}
+
+	bool Parser::parse_float(Config& out)
+	{
+		double result;
+		const char* end = parse_double(_ptr, _end, &result);
+		if (!parse_assert(end != nullptr, "Invalid number")) { return false; }
+		_ptr = end;
+		out = result;
+		return true;
+	}
+
+	bool Parser::parse_finite_number(Config& out)
+	{
+		const auto pre_sign = _ptr;
+		int sign = +1;
+
+		if (at(0) == '+') {
+			if (!parse_assert(_options.unary_plus, "Prefixing numbers with + is forbidden.")) { return false; }
+			_ptr += 1;
+		}
+		if (at(0) == '-') {
+			_ptr += 1;
+			sign = -1;
+		}
+
+		if (!parse_assert(at(0) != '+' && at(0) != '-', "Duplicate sign")) { return false; }
+
+		// Check if it's an integer:
+		if (at(0) == '0' && at(1) == 'x') {
+			if (!parse_assert(_options.hexadecimal_integers, "Hexadecimal numbers forbidden.")) { return false; }
+			_ptr += 2;
+			auto start = _ptr;
+			uint64_t value = 0;
+			bool overflow = false; // Like strtoull, too many digits give the largest value.
+			for (;; ++_ptr) {
+				uint64_t digit;
+				if ('0' <= at(0) && at(0) <= '9') {
+					digit = static_cast<uint64_t>(at(0) - '0');
+				} else if ('a' <= at(0) && at(0) <= 'f') {
+					digit = static_cast<uint64_t>(at(0) - 'a' + 10);
+				} else if ('A' <= at(0) && at(0) <= 'F') {
+					digit = static_cast<uint64_t>(at(0) - 'A' + 10);
+				} else {
+					break;
+				}
+				overflow = overflow || (value >> 60) != 0;
+				value = (value << 4) | digit;
+			}
+			if (!parse_assert(start < _ptr, "Missing hexaxdecimal digits after 0x")) { return false; }
+			out = sign * static_cast<int64_t>(overflow ? ~uint64_t(0) : value);
+			return true;
+		}
+
+		if (at(0) == '0' && at(1) == 'b') {
+			if (!parse_assert(_options.binary_integers, "Binary numbers forbidden.")) { return false; }
+			_ptr += 2;
+			auto start = _ptr;
+			uint64_t value = 0;
+			bool overflow = false;
+			for (; at(0) == '0' || at(0) == '1'; ++_ptr) {
+				overflow = overflow || (value >> 63) != 0;
+				value = (value << 1) | static_cast<uint64_t>(at(0) - '0');
+			}
+			if (!parse_assert(start < _ptr, "Missing binary digits after 0b")) { return false; }
+			out = sign * static_cast<int64_t>(overflow ? ~uint64_t(0) : value);
+			return true;
+		}
+
+		uint64_t value;
+		const char* p = accumulate_decimal_digits(_ptr, _end, &value);
+		const char next = (p != _end ? *p : '\0');
+
+		if (next == '.' || next == 'e' || next == 'E') {
+			_ptr = pre_sign;
+			return parse_float(out);
+		}
+
+		// It looks like an integer - but it may be too large to represent as one!
+		const auto length = p - _ptr;
+		const uint64_t max_magnitude = (sign == +1 ? 9223372036854775807ull : 9223372036854775808ull);
+		if (length > 19 || (length == 19 && value > max_magnitude)) {
+			_ptr = pre_sign;
+			return parse_float(out);
+		}
+
+		if (length == 0) {
+			_ptr = pre_sign;
+			fail("Invalid integer");
+			return false;
+		}
+
+		_ptr = p;
+		if (!parse_assert(pre_sign[0] != '0' || value == 0, "Integer may not start with a zero")) { return false; }
+		if (sign == +1) {
+			out = static_cast<int64_t>(value);
+		} else {
+			out = value == 0 ? int64_t(0) : -static_cast<int64_t>(value - 1) - 1;
+		}
+		return true;
+	}
+
+	bool Parser::parse_c_sharp_string(std::string& str)
+	{
+		// C# style verbatim string - everything until the next " except "" which is ":
+		auto state = get_state();
+		if (!parse_assert(_options.str_csharp_verbatim, "C# @-style verbatim strings forbidden.")) { return false; }
+		if (!swallow('@') || !swallow('"')) { return false; }
+
+		str.clear();
+
+		for (;;) {
+			// Handle large swats of verbatim characters at once:
+			const char* span_end = find_first_of<'"', '\n', '\0'>(_ptr, _end);
+			str.append(_ptr, span_end);
+			_ptr = span_end;
+
+			if (at(0) == 0) {
+				set_state(state);
+				fail("Unterminated verbatim string");
+				return false;
+			}
+			else if (at(0) == '\n') {
+				fail("Newline in verbatim string");
+				return false;
+			}
+			else if (at(0) == '"' && at(1) == '"') {
+				// Escaped quote
+				_ptr += 2;
+				str.push_back('"');
+			}
+			else {
+				_ptr += 1;
+				return true;
+			}
+		}
+	}
+
+	bool Parser::parse_string(std::string& str)
+	{
+		if (at(0) == '@') {
+			return parse_c_sharp_string(str);
+		}
+
+		auto state = get_state();
+		if (!parse_assert(at(0) == '"', "Quote (\") expected")) { return false; }
+
+		if (at(1) == '"' && at(2) == '"') {
+			// Python style multiline string - everything until the next """:
+			if (!parse_assert(_options.str_python_multiline, "Python \"\"\"-style multiline strings forbidden.")) { return false; }
+			_ptr += 3;
+			const char* start = _ptr;
+			for (;;) {
+				_ptr = find_first_of<'"', '\n', '\0'>(_ptr, _end);
+
+				if (at(0)==0 || at(1)==0 || at(2)==0) {
+					set_state(state);
+					fail("Unterminated multiline string");
+					return false;
+				}
+
+				if (at(0) == '"' && at(1) == '"' && at(2) == '"' && at(3) != '"') {
+					str.assign(start, _ptr);
+					_ptr += 3;
+					return true;
+				}
+
+				if (at(0) == '\n') {
+					_ptr += 1;
+					_line_nr += 1;
+					_line_start = _ptr;
+				} else {
+					_ptr += 1;
+				}
+			}
+		} else {
+			// Normal string
+			_ptr += 1; // Swallow quote
+
+			str.clear();
+
+			for (;;) {
+				// Handle larges swats of safe characters at once:
+				auto safe_end = find_first_of<'\0', '\\', '"', '\n', '\t'>(_ptr, _end);
+
+				if (_ptr != safe_end) {
+					str.append(_ptr, safe_end - _ptr);
+					_ptr = safe_end;
+				}
+
+				if (at(0) == 0) {
+					set_state(state);
+					fail("Unterminated string");
+					return false;
+				}
+				if (at(0) == '"') {
+					_ptr += 1;
+					return true;
+				}
+				if (at(0) == '\n') {
+					fail("Newline in string");
+					return false;
+				}
+				if (at(0) == '\t') {
+					if (!parse_assert(_options.str_allow_tab, "Un-escaped tab not allowed in string")) { return false; }
 				}
-			}
 
-			orientation += "\n";
-			for (const char* p = sol; p != _ptr; ++p) {
-				if (*p == '\t') {
-					orientation += "    ";
+				if (at(0) == '\\') {
+					// Escape sequence
+					_ptr += 1;
+
+					if (at(0) == '"') {
+						str.push_back('"');
+						_ptr += 1;
+					} else if (at(0) == '\\') {
+						str.push_back('\\');
+						_ptr += 1;
+					} else if (at(0) == '/') {
+						str.push_back('/');
+						_ptr += 1;
+					} else if (at(0) == 'b') {
+						str.push_back('\b');
+						_ptr += 1;
+					} else if (at(0) == 'f') {
+						str.push_back('\f');
+						_ptr += 1;
+					} else if (at(0) == 'n') {
+						str.push_back('\n');
+						_ptr += 1;
+					} else if (at(0) == 'r') {
+						str.push_back('\r');
+						_ptr += 1;
+					} else if (at(0) == 't') {
+						str.push_back('\t');
+						_ptr += 1;
+					} else if (at(0) == 'u') {
+						// Four hexadecimal characters
+						_ptr += 1;
+						uint64_t codepoint;
+						if (!parse_hex(4, codepoint)) { return false; }
+
+						if (0xD800 <= codepoint && codepoint <= 0xDBFF)
+						{
+							// surrogate pair
+							if (!parse_assert(at(0) == '\\' && at(1) == 'u',
+										 "Missing second unicode surrogate.")) { return false; }
+							_ptr += 2;
+							uint64_t codepoint2;
+							if (!parse_hex(4, codepoint2)) { return false; }
+							if (!parse_assert(0xDC00 <= codepoint2 && codepoint2 <= 0xDFFF, "Invalid second unicode surrogate")) {
+								return false;
+							}
+							codepoint = (codepoint << 10) + codepoint2 - 0x35FDC00;
+						}
+
+						auto num_bytes_written = encode_utf8(str, codepoint);
+						if (!parse_assert(num_bytes_written > 0, "Bad unicode codepoint")) { return false; }
+					} else if (at(0) == 'U') {
+						// Eight hexadecimal characters
+						if (!parse_assert(_options.str_32bit_unicode, "\\U 32 bit unicodes forbidden.")) { return false; }
+						_ptr += 1;
+						uint64_t unicode;
+						if (!parse_hex(8, unicode)) { return false; }
+						auto num_bytes_written = encode_utf8(str, unicode);
+						if (!parse_assert(num_bytes_written > 0, "Bad unicode codepoint")) { return false; }
+					} else {
+						fail("Unknown escape character " + quote(at(0)));
+						return false;
+					}
 				} else {
-					orientation.push_back(' ');
+					str.push_back(at(0));
+					_ptr += 1;
 				}
 			}
-			orientation += "^";
-
-			throw ParseError(_doc, _line_nr, column(), desc + "\n" + orientation);
 		}
+	}
 
-		void throw_indentation_error(int found_tabs, int expected_tabs) {
-			if (_options.enforce_indentation) {
-				char buff[128];
-				snprintf(buff, sizeof(buff), "Bad indentation: expected %d tabs, found %d", found_tabs, expected_tabs);
-				throw_error(buff);
+	bool Parser::parse_hex(int count, uint64_t& out)
+	{
+		uint64_t ret = 0;
+		for (int i=0; i<count; ++i) {
+			ret *= 16;
+			char c = at(i);
+			if ('0' <= c && c <= '9') {
+				ret += static_cast<uint64_t>(c - '0');
+			} else if ('a' <= c && c <= 'f') {
+				ret += static_cast<uint64_t>(10 + c - 'a');
+			} else if ('A' <= c && c <= 'F') {
+				ret += static_cast<uint64_t>(10 + c - 'A');
+			} else {
+				fail("Expected hexadecimal digit, got " + quote(at(0)));
+				return false;
 			}
 		}
+		_ptr += count;
+		out = ret;
+		return true;
+	}
 
-		void parse_assert(bool b, const char* error_msg) {
-			if (!b) {
-				throw_error(error_msg);
-			}
+	// An #include "path" is relative to the directory of the file it is in.
+	static std::string relative_include_path(const std::string& includer, const std::string& path)
+	{
+		auto pos = includer.find_last_of('/');
+		if (pos != std::string::npos) {
+			return includer.substr(0, pos+1) + path;
 		}
+		return path;
+	}
 
-		void parse_assert(bool b, const char* error_msg, const State& error_state) {
-			if (!b) {
-				set_state(error_state);
-				throw_error(error_msg);
-			}
-		}
+	bool Parser::parse_macro(Config& dst)
+	{
+		if (!parse_assert(_options.allow_macro, "#macros forbidden.")) { return false; }
 
-		void swallow(char c) {
-			if (_ptr[0] == c) {
-				_ptr += 1;
-			} else {
-				throw_error("Expected " + quote(c));
-			}
+		if (!swallow("#include", "Expected '#include'")) { return false; }
+		skip_white_ignore_comments();
+		if (_failed) { return false; }
+
+		bool absolute;
+		char terminator;
+
+		if (at(0) == '"') {
+			absolute = false;
+			terminator = '"';
+		} else if (at(0) == '<') {
+			absolute = true;
+			terminator = '>';
+		} else {
+			fail("Expected \" or <");
+			return false;
 		}
 
-		bool try_swallow(const char* str) {
-			auto n = strlen(str);
-			if (strncmp(str, _ptr, n) == 0) {
-				_ptr += n;
-				return true;
-			} else {
+		auto state = get_state();
+		_ptr += 1;
+		auto start = _ptr;
+		std::string path;
+		for (;;) {
+			if (at(0) == 0) {
+				set_state(state);
+				fail("Unterminated include path");
+				return false;
+			} else if (at(0) == terminator) {
+				path = std::string(start, static_cast<size_t>(_ptr - start));
+				_ptr += 1;
+				break;
+			} else if (at(0) == '\n') {
+				fail("Newline in string");
 				return false;
+			} else {
+				_ptr += 1;
 			}
 		}
 
-		void swallow(const char* str, const char* error_msg) {
-			parse_assert(try_swallow(str), error_msg);
+		if (!absolute) {
+			path = relative_include_path(_doc->filename, path);
 		}
 
-		bool is_reserved_identifier(const char* ptr)
-		{
-			if (strncmp(ptr, "true", 4)==0 || strncmp(ptr, "null", 4)==0) {
-				return !IDENT_CHARS[static_cast<uint8_t>(ptr[4])];
-			} else if (strncmp(ptr, "false", 5)==0) {
-				return !IDENT_CHARS[static_cast<uint8_t>(ptr[5])];
+		auto it = _info.parsed_files.find(path);
+		const bool is_new = it == _info.parsed_files.end();
+		if (is_new) {
+			// The key of this entry is not reported until we are done, so keep it from being overwritten:
+			std::string key;
+			key.swap(_info.key_scratch);
+			bool ok;
+			if (_info.include_cache) {
+				ok = _info.include_cache->include(path, _doc, _line_nr, _info, dst, _failure);
 			} else {
+				auto child_doc = std::make_shared<DocInfo>(path);
+				child_doc->includers.emplace_back(_doc, _line_nr);
+				ok = try_parse_file(path, _options, child_doc, _info, dst, _failure);
+			}
+			key.swap(_info.key_scratch);
+			if (!ok) {
+				if (_failure.line == 0) {
+					// The file could not be read. Point out the #include instead:
+					const std::string description = std::move(_failure.description);
+					set_state(state);
+					fail(description);
+				}
+				_failed = true;
 				return false;
 			}
+			_info.parsed_files[path] = dst;
+		} else {
+			if (auto child_doc = it->second.doc()) { // Gone if nothing but a value was parsed from it
+				child_doc->includers.emplace_back(_doc, _line_nr);
+			}
+			dst = it->second;
+			if (_info.include_cache) {
+				_info.include_cache->include_again(path);
+			}
 		}
 
-	private:
-		bool IDENT_STARTERS[256]     = { 0 };
-		bool IDENT_CHARS[256]        = { 0 };
-		bool MAYBE_WHITE[256]        = { 0 };
-		bool SPECIAL_CHARACTERS[256] = { 0 };
-
-	private:
-		FormatOptions _options;
-		DocInfo_SP    _doc;
-		ParseInfo&    _info;
-
-		const char*   _ptr;
-		Index         _line_nr;
-		const char*   _line_start;
-		int           _indentation = 0; // Expected number of tabs between a \n and the next key/value
-	};
+		if (_log_includes) {
+			_include_log.push_back({path, is_new});
+		}
+		return true;
+	}
 
-	// --------------------------------------------
+	// ----------------------------------------------------------------------------------------
 
-	// Sets an inclusive range
-	void set_range(bool lookup[256], char a, char b)
+	// Builds the Config tree from the events of the Parser.
+	class ConfigBuilder : public ParseHandler
 	{
-		for (char c=a; c<=b; ++c) {
-			lookup[static_cast<uint8_t>(c)] = true;
+	public:
+		ConfigBuilder(DocInfo_SP doc, const FormatOptions& options)
+			: _tagger(doc)
+			, _arena(options.arena ? new DocArena(options.memory_resource, options.arena_huge_pages) : nullptr)
+			, _resource(_arena ? _arena : options.memory_resource)
+		{
+			// The top level is a sequence of values until we know better:
+			_root.make_array(_resource);
+			_tagger.tag(_root, 1);
 		}
-	}
 
-	Parser::Parser(const char* str, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info) : _doc(doc), _info(info)
-	{
-		_options    = options;
-		_line_nr    = 1;
-		_ptr        = str;
-		_line_start = str;
+		~ConfigBuilder()
+		{
+			// What we built keeps the arena alive:
+			if (_arena) { _arena->release(); }
+		}
 
-		IDENT_STARTERS[static_cast<uint8_t>('_')] = true;
-		set_range(IDENT_STARTERS, 'a', 'z');
-		set_range(IDENT_STARTERS, 'A', 'Z');
+		ConfigBuilder(const ConfigBuilder&) = delete;
+		ConfigBuilder& operator=(const ConfigBuilder&) = delete;
 
-		IDENT_CHARS[static_cast<uint8_t>('_')] = true;
-		set_range(IDENT_CHARS, 'a', 'z');
-		set_range(IDENT_CHARS, 'A', 'Z');
-		set_range(IDENT_CHARS, '0', '9');
+		// The document, once the parse is done.
+		Config result();
 
-		MAYBE_WHITE[static_cast<uint8_t>('\n')] = true;
-		MAYBE_WHITE[static_cast<uint8_t>('\r')] = true;
-		MAYBE_WHITE[static_cast<uint8_t>('\t')] = true;
-		MAYBE_WHITE[static_cast<uint8_t>(' ')]  = true;
-		MAYBE_WHITE[static_cast<uint8_t>('/')]  = true; // Maybe a comment
+		void null_value(Index line) override                             { add_value(line, nullptr); }
+		void bool_value(Index line, bool value) override                 { add_value(line, value); }
+		void int_value(Index line, int64_t value) override               { add_value(line, value); }
+		void float_value(Index line, double value) override              { add_value(line, value); }
+		void string_value(Index line, const std::string& value) override;
+		void config_value(Index line, Config&& value) override           { add_value(line, std::move(value)); }
 
-		SPECIAL_CHARACTERS[static_cast<uint8_t>('\0')] = true;
-		SPECIAL_CHARACTERS[static_cast<uint8_t>('\\')] = true;
-		SPECIAL_CHARACTERS[static_cast<uint8_t>('\"')] = true;
-		SPECIAL_CHARACTERS[static_cast<uint8_t>('\n')] = true;
-		SPECIAL_CHARACTERS[static_cast<uint8_t>('\t')] = true;
+		void begin_object(Index line) override { begin(line, true); }
+		void begin_array(Index line) override  { begin(line, false); }
+		void end_object() override             { end(); }
+		void end_array() override              { end(); }
+		void key(const std::string& key) override { _key = key; }
 
-		CONFIGURU_ASSERT(_options.indentation != "" || !_options.enforce_indentation);
-	}
+		void comment(CommentKind kind, const std::string& comment) override;
+		bool is_duplicate_key(const std::string& key, std::string& out_where) override;
 
-	// Returns true if we did skip white-space.
-	// out_indentation is the depth of indentation on the last line we did skip on.
-	// iff out_indentation is -1 there is a non-tab on the last line.
-	bool Parser::skip_white(Comments* out_comments, int& out_indentation, bool break_on_newline)
-	{
-		auto start_ptr = _ptr;
-		out_indentation = 0;
-		bool found_newline = false;
+	private:
+		// An array/object we are inside of.
+		struct Open
+		{
+			Config         container;
+			std::string    key;      // Where in the parent object it goes
+			ConfigComments comments; // Given to the container once it is in its parent
+		};
 
-		const std::string& indentation = _options.indentation;
+		Config& container() { return _open.empty() ? _root : _open.back().container; }
+
+		void begin(Index line, bool is_object);
+		void end();
+		void add_value(Index line, Config&& value);
+		void flush();
+
+		DocTagger         _tagger;
+		DocArena*         _arena;    // See FormatOptions::arena
+		MemoryResource*   _resource; // What we allocate from
+		Config            _root;
+		std::vector<Open> _open;
+		std::string       _key;    // Key of the next value in an object
+		Comments          _prefix; // Comments for the next value
+
+		// The last value is added to its container once we have all its postfix comments.
+		// The comments are given to the value once it is in its container.
+		bool              _has_last = false;
+		Config            _last;
+		std::string       _last_key;
+		ConfigComments    _last_comments;
+	};
 
-		while (MAYBE_WHITE[static_cast<uint8_t>(_ptr[0])]) {
-			if (_ptr[0] == '\n') {
-				// Unix style newline
-				_ptr += 1;
-				_line_nr += 1;
-				_line_start = _ptr;
-				out_indentation = 0;
-				if (break_on_newline) { return true; }
-				found_newline = true;
-			}
-			else if (_ptr[0] == '\r') {
-				// CR-LF - windows style newline
-				parse_assert(_ptr[1] == '\n', "CR with no LF. \\r only allowed before \\n."); // TODO: this is OK in JSON.
-				_ptr += 2;
-				_line_nr += 1;
-				_line_start = _ptr;
-				out_indentation = 0;
-				if (break_on_newline) { return true; }
-				found_newline = true;
-			}
-			else if (!indentation.empty() &&
-					 strncmp(_ptr, indentation.c_str(), indentation.size()) == 0)
-			{
-				_ptr += indentation.size();
-				if (_options.enforce_indentation && indentation == "\t") {
-					parse_assert(out_indentation != -1, "Tabs should only occur on the start of a line!");
-				}
-				++out_indentation;
-			}
-			else if (_ptr[0] == '\t') {
-				++_ptr;
-				if (_options.enforce_indentation) {
-					parse_assert(out_indentation != -1, "Tabs should only occur on the start of a line!");
-				}
-				++out_indentation;
-			}
-			else if (_ptr[0] == ' ') {
-				if (found_newline && _options.enforce_indentation) {
-					if (indentation == "\t") {
-						throw_error("Found a space at beginning of a line. Indentation must be done using tabs!");
-					} else {
-						throw_error("Indentation should be a multiple of " + std::to_string(indentation.size()) + " spaces.");
-					}
-				}
-				++_ptr;
-				out_indentation = -1;
-			}
-			else if (_ptr[0] == '/' && _ptr[1] == '/') {
-				parse_assert(_options.single_line_comments, "Single line comments forbidden.");
-				// Single line comment
-				auto start = _ptr;
-				_ptr += 2;
-				while (_ptr[0] && _ptr[0] != '\n') {
-					_ptr += 1;
-				}
-				if (out_comments) { out_comments->emplace_back(start, _ptr - start); }
-				out_indentation = 0;
-				if (break_on_newline) { return true; }
-			}
-			else if (_ptr[0] == '/' && _ptr[1] == '*') {
-				parse_assert(_options.block_comments, "Block comments forbidden.");
-				// Multi-line comment
-				auto state = get_state(); // So we can point out the start if there's an error
-				_ptr += 2;
-				unsigned nesting = 1; // We allow nested /**/ comments
-				do
-				{
-					if (_ptr[0]==0) {
-						set_state(state);
-						throw_error("Non-ending /* comment");
-					}
-					else if (_ptr[0]=='/' && _ptr[1]=='*') {
-						_ptr += 2;
-						parse_assert(_options.nesting_block_comments, "Nesting comments (/* /* */ */) forbidden.");
-						nesting += 1;
-					}
-					else if (_ptr[0]=='*' && _ptr[1]=='/') {
-						_ptr += 2;
-						nesting -= 1;
-					}
-					else if (_ptr[0] == '\n') {
-						_ptr += 1;
-						_line_nr += 1;
-						_line_start = _ptr;
-					} else {
-						_ptr += 1;
-					}
-				} while (nesting > 0);
-				if (out_comments) { out_comments->emplace_back(state.ptr, _ptr - state.ptr); }
-				out_indentation = -1;
-				if (break_on_newline) { return true; }
-			}
-			else {
-				break;
+	Config ConfigBuilder::result()
+	{
+		flush();
+		if (_arena) { _arena->seal(); }
+
+		if (_root.array_size() == 0) {
+			// Empty file (the Parser checks if that is ok)
+			auto empty_object = Config::object();
+			if (_root.has_comments()) {
+				empty_object.comments() = std::move(_root.comments());
 			}
+			return empty_object;
 		}
 
-		if (start_ptr == _ptr) {
-			out_indentation = -1;
-			return false;
-		} else {
-			return true;
+		if (_root.array_size() == 1) {
+			// A single value - not an array after all:
+			Config first( std::move(_root[0]) );
+			if (_root.has_comments()) {
+				first.comments().append(std::move(_root.comments()));
+			}
+			return first;
 		}
+
+		return std::move(_root);
 	}
 
-	/*
-	The top-level can be any value, OR the innerds of an object:
-	foo = 1
-	"bar": 2
-	*/
-	Config Parser::top_level()
+	void ConfigBuilder::comment(CommentKind kind, const std::string& comment)
 	{
-		bool is_object = false;
-
-		if (_options.implicit_top_object)
-		{
-			auto state = get_state();
-			skip_white_ignore_comments();
-
-			if (IDENT_STARTERS[static_cast<uint8_t>(_ptr[0])] && !is_reserved_identifier(_ptr)) {
-				is_object = true;
-			} else if (_ptr[0] == '"' || _ptr[0] == '@') {
-				parse_string();
-				skip_white_ignore_comments();
-				is_object = (_ptr[0] == ':' || _ptr[0] == '=');
+		if (kind == Prefix) {
+			_prefix.push_back(comment);
+		} else if (kind == Postfix) {
+			_last_comments.postfix.push_back(comment);
+		} else {
+			flush();
+			if (_open.empty()) {
+				_root.comments().pre_end_brace.push_back(comment);
+			} else {
+				_open.back().comments.pre_end_brace.push_back(comment);
 			}
-
-			set_state(state); // restore
 		}
+	}
 
-		Config ret;
-		tag(ret);
+	bool ConfigBuilder::is_duplicate_key(const std::string& key, std::string& out_where)
+	{
+		flush();
+		Config& object = container();
+		if (object.has_key(key)) {
+			out_where = object[key].where();
+			return true;
+		} else {
+			return false;
+		}
+	}
 
+	void ConfigBuilder::begin(Index line, bool is_object)
+	{
+		flush();
+		Open open;
+		if (!_prefix.empty()) {
+			open.comments.prefix = std::move(_prefix);
+			_prefix.clear();
+		}
 		if (is_object) {
-			parse_object_contents(ret);
+			open.container.make_object(_resource);
 		} else {
-			parse_array_contents(ret);
-			parse_assert(ret.array_size() <= 1 || _options.implicit_top_array, "Multiple values not allowed without enclosing []");
+			open.container.make_array(_resource);
 		}
+		_tagger.tag(open.container, line);
+		open.key = std::move(_key);
+		_open.push_back(std::move(open));
+	}
+
+	void ConfigBuilder::end()
+	{
+		flush();
+		_last          = std::move(_open.back().container);
+		_last_key      = std::move(_open.back().key);
+		_last_comments = std::move(_open.back().comments);
+		_has_last      = true;
+		_open.pop_back();
+	}
 
-		skip_post_white(&ret);
+	void ConfigBuilder::string_value(Index line, const std::string& value)
+	{
+		Config config;
+		config.make_string(value.data(), value.size(), _resource);
+		add_value(line, std::move(config));
+	}
 
-		parse_assert(_ptr[0] == 0, "Expected EoF");
+	void ConfigBuilder::add_value(Index line, Config&& value)
+	{
+		flush();
+		Config entry;
+		_tagger.tag(entry, line);
+		if (!_prefix.empty()) {
+			if (!value.has_comments()) { // Else it has its own (#include)
+				_last_comments.prefix = std::move(_prefix);
+			}
+			_prefix.clear();
+		}
+		entry = std::move(value); // Keeps the tag unless value has its own (#include)
+		_last = std::move(entry);
+		_last_key.swap(_key);
+		_has_last = true;
+	}
 
-		if (!is_object && ret.array_size() == 0) {
-			if (_options.empty_file) {
-				auto empty_object = Config::object();
-				if (ret.has_comments()) {
-					empty_object.comments() = std::move(ret.comments());
+	void ConfigBuilder::flush()
+	{
+		if (_has_last) {
+			Config& dst = container();
+			Config* added = nullptr;
+			if (dst.is_object()) {
+				auto&& object = dst.as_object()._impl;
+				auto result = object.emplace(Key(_last_key), Config::ObjectEntry{std::move(_last), (Index)object.size()});
+				if (result.second) {
+					added = &result.first->second._value;
 				}
-				return empty_object;
 			} else {
-				throw_error("Empty file");
+				dst.as_array().emplace_back(std::move(_last));
+				added = &dst.as_array().back();
 			}
-		}
-
-		if (!is_object && ret.array_size() == 1) {
-			// A single value - not an array after all:
-			Config first( std::move(ret[0]) );
-			if (ret.has_comments()) {
-				first.comments().append(std::move(ret.comments()));
+			if (!_last_comments.empty()) {
+				if (added) {
+					added->comments().append(std::move(_last_comments));
+				}
+				_last_comments = ConfigComments();
 			}
-			return first;
+			_has_last = false;
 		}
-
-		return ret;
 	}
 
-	void Parser::parse_value(Config& dst, bool* out_did_skip_postwhites)
+	void throw_parse_error(const ParseFailure& failure)
 	{
-		int line_indentation;
-		skip_pre_white(&dst, line_indentation);
-		tag(dst);
+		if (failure.line == 0) {
+			CONFIGURU_ONERROR(failure.description); // The file could not be read
+		}
+	#if CONFIGURU_EXCEPTIONS
+		throw ParseError(failure.doc, failure.line, failure.column, failure.description);
+	#else
+		CONFIGURU_ONERROR(ParseError(failure.doc, failure.line, failure.column, failure.description).what());
+		abort(); // In case CONFIGURU_ONERROR returns
+	#endif
+	}
 
-		if (line_indentation >= 0 && _indentation - 1 != line_indentation) {
-			throw_indentation_error(_indentation - 1, line_indentation);
+	void parse_string(const char* str, size_t length, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info, ParseHandler& handler)
+	{
+		Parser p(str, length, options, doc, info, handler);
+		if (!p.top_level()) {
+			throw_parse_error(p.failure());
 		}
+	}
 
-		if (_ptr[0] == '"' || _ptr[0] == '@') {
-			dst = parse_string();
-		}
-		else if (_ptr[0] == 'n') {
-			parse_assert(_ptr[1]=='u' && _ptr[2]=='l' && _ptr[3]=='l', "Expected 'null'");
-			parse_assert(!IDENT_CHARS[static_cast<uint8_t>(_ptr[4])], "Expected 'null'");
-			_ptr += 4;
-			dst = nullptr;
-		}
-		else if (_ptr[0] == 't') {
-			parse_assert(_ptr[1]=='r' && _ptr[2]=='u' && _ptr[3]=='e', "Expected 'true'");
-			parse_assert(!IDENT_CHARS[static_cast<uint8_t>(_ptr[4])], "Expected 'true'");
-			_ptr += 4;
-			dst = true;
-		}
-		else if (_ptr[0] == 'f') {
-			parse_assert(_ptr[1]=='a' && _ptr[2]=='l' && _ptr[3]=='s' && _ptr[4]=='e', "Expected 'false'");
-			parse_assert(!IDENT_CHARS[static_cast<uint8_t>(_ptr[5])], "Expected 'false'");
-			_ptr += 5;
-			dst = false;
-		}
-		else if (_ptr[0] == '{') {
-			parse_object(dst);
-		}
-		else if (_ptr[0] == '[') {
-			parse_array(dst);
-		}
-		else if (_ptr[0] == '#') {
-			parse_macro(dst);
+	// Like parse_string, but returns false on error.
+	static bool try_parse_string(const char* str, size_t length, const FormatOptions& options, DocInfo_SP doc,
+	                             ParseInfo& info, Config& out, ParseFailure& out_failure)
+	{
+		ConfigBuilder builder(doc, options);
+		Parser p(str, length, options, doc, info, builder);
+		if (!p.top_level()) {
+			out_failure = p.failure();
+			return false;
 		}
-		else if (_ptr[0] == '+' || _ptr[0] == '-' || _ptr[0] == '.' || ('0' <= _ptr[0] && _ptr[0] <= '9')) {
-			// Some kind of number:
+		out = builder.result();
+		return true;
+	}
 
-			if (_ptr[0] == '-' && _ptr[1] == 'i' && _ptr[2]=='n' && _ptr[3]=='f') {
-				parse_assert(!IDENT_CHARS[static_cast<uint8_t>(_ptr[4])], "Expected -inf");
-				parse_assert(_options.inf, "infinity forbidden.");
-				_ptr += 4;
-				dst = -std::numeric_limits<double>::infinity();
-			}
-			else if (_ptr[0] == '+' && _ptr[1] == 'i' && _ptr[2]=='n' && _ptr[3]=='f') {
-				parse_assert(!IDENT_CHARS[static_cast<uint8_t>(_ptr[4])], "Expected +inf");
-				parse_assert(_options.inf, "infinity forbidden.");
-				_ptr += 4;
-				dst = std::numeric_limits<double>::infinity();
-			}
-			else if (_ptr[0] == '+' && _ptr[1] == 'N' && _ptr[2]=='a' && _ptr[3]=='N') {
-				parse_assert(!IDENT_CHARS[static_cast<uint8_t>(_ptr[4])], "Expected +NaN");
-				parse_assert(_options.nan, "NaN (Not a Number) forbidden.");
-				_ptr += 4;
-				dst = std::numeric_limits<double>::quiet_NaN();
-			} else {
-				parse_finite_number(dst);
-			}
-		} else {
-			throw_error("Expected value");
+	Config parse_string(const char* str, size_t length, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info)
+	{
+		Config result;
+		ParseFailure failure;
+		if (!try_parse_string(str, length, options, doc, info, result, failure)) {
+			throw_parse_error(failure);
 		}
+		return result;
+	}
 
-		*out_did_skip_postwhites = skip_post_white(&dst);
+	void parse_string(const char* str, size_t length, const FormatOptions& options, const char* name, ParseHandler& handler)
+	{
+		ParseInfo info;
+		parse_string(str, length, options, std::make_shared<DocInfo>(name), info, handler);
 	}
 
-	void Parser::parse_array(Config& array)
+	Config parse_string(const char* str, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info)
 	{
-		auto state = get_state();
+		return parse_string(str, strlen(str), options, doc, info);
+	}
 
-		swallow('[');
+	Config parse_string(const char* str, const FormatOptions& options, const char* name)
+	{
+		ParseInfo info;
+		return parse_string(str, options, std::make_shared<DocInfo>(name), info);
+	}
 
-		_indentation += 1;
-		parse_array_contents(array);
-		_indentation -= 1;
+	Config parse_string(const char* str, size_t length, const FormatOptions& options, const char* name)
+	{
+		ParseInfo info;
+		return parse_string(str, length, options, std::make_shared<DocInfo>(name), info);
+	}
 
-		if (_ptr[0] == ']') {
-			_ptr += 1;
+	static ParseResult failed_result(const ParseFailure& failure)
+	{
+		ParseResult result;
+		result.filename = failure.doc->filename;
+		result.line     = failure.line;
+		result.column   = failure.column;
+		if (failure.line == 0) {
+			result.message = failure.description; // The file could not be read
 		} else {
-			set_state(state);
-			throw_error("Non-terminated array");
+			result.message = ParseError(failure.doc, failure.line, failure.column, failure.description).what();
 		}
+		return result;
 	}
 
-	void Parser::parse_array_contents(Config& array_cfg)
+	ParseResult parse_string_noexcept(const char* str, size_t length, const FormatOptions& options, const char* name)
 	{
-		array_cfg.make_array();
-		auto& array_impl = array_cfg.as_array();
+		ParseInfo info;
+		ParseResult result;
+		ParseFailure failure;
+		if (!try_parse_string(str, length, options, std::make_shared<DocInfo>(name), info, result.config, failure)) {
+			return failed_result(failure);
+		}
+		result.ok = true;
+		return result;
+	}
 
-		Comments next_prefix_comments;
+	ParseResult parse_string_noexcept(const char* str, const FormatOptions& options, const char* name)
+	{
+		return parse_string_noexcept(str, strlen(str), options, name);
+	}
 
-		for (;;)
-		{
-			Config value;
-			if (!next_prefix_comments.empty()) {
-				std::swap(value.comments().prefix, next_prefix_comments);
-			}
-			int line_indentation;
-			skip_pre_white(&value, line_indentation);
+	// Sets out_error if given, else calls CONFIGURU_ONERROR.
+	static void file_error(const std::string& message, std::string* out_error)
+	{
+		if (out_error) {
+			*out_error = message;
+		} else {
+			CONFIGURU_ONERROR(message);
+		}
+	}
 
-			if (_ptr[0] == ']') {
-				if (line_indentation >= 0 && _indentation - 1 != line_indentation) {
-					throw_indentation_error(_indentation - 1, line_indentation);
-				}
-				if (value.has_comments()) {
-					array_cfg.comments().pre_end_brace = value.comments().prefix;
-				}
-				break;
-			}
+#if !CONFIGURU_HAS_MMAP
+	// Returns false on error.
+	static bool read_text_file(const char* path, std::string& contents, std::string* out_error)
+	{
+		FILE* fp = fopen(path, "rb");
+		if (fp == nullptr) {
+			file_error(std::string("Failed to open '") + path + "' for reading: " + strerror(errno), out_error);
+			return false;
+		}
+		fseek(fp, 0, SEEK_END);
+		const auto size = ftell(fp);
+		if (size < 0) {
+			fclose(fp);
+			file_error(std::string("Failed to find out size of '") + path + "': " + strerror(errno), out_error);
+			return false;
+		}
+		contents.resize(static_cast<size_t>(size));
+		rewind(fp);
+		const auto num_read = fread(&contents[0], 1, contents.size(), fp);
+		fclose(fp);
+		if (num_read != contents.size()) {
+			file_error(std::string("Failed to read from '") + path + "': " + strerror(errno), out_error);
+			return false;
+		}
+		return true;
+	}
+#endif // !CONFIGURU_HAS_MMAP
 
-			if (!_ptr[0]) {
-				if (value.has_comments()) {
-					array_cfg.comments().pre_end_brace = value.comments().prefix;
-				}
-				break;
-			}
+	// The contents of a file. Regular files that are not tiny are memory mapped, everything else is read.
+	// Note that there is no zero at the end.
+	// If the file cannot be read, out_error is set (and the contents are empty), or without it CONFIGURU_ONERROR is called.
+	class FileContents
+	{
+	public:
+		explicit FileContents(const char* path, std::string* out_error = nullptr);
+		~FileContents();
 
-			if (line_indentation >= 0 && _indentation != line_indentation) {
-				throw_indentation_error(_indentation, line_indentation);
-			}
+		FileContents(const FileContents&) = delete;
+		FileContents& operator=(const FileContents&) = delete;
 
-			if (IDENT_STARTERS[static_cast<uint8_t>(_ptr[0])] && !is_reserved_identifier(_ptr)) {
-				throw_error("Found identifier; expected value. Did you mean to use a {object} rather than a [array]?");
-			}
+		const char* data() const { return _data; }
+		size_t      size() const { return _size; }
 
-			bool has_separator;
-			parse_value(value, &has_separator);
-			int ignore;
-			skip_white(&next_prefix_comments, ignore, false);
+	private:
+		const char* _data    = nullptr;
+		size_t      _size    = 0;
+		void*       _mapping = nullptr; // Set iff we mapped the file
+		std::string _buffer;            // If we did not
+	};
 
-			auto comma_state = get_state();
-			bool has_comma = _ptr[0] == ',';
+	FileContents::FileContents(const char* path, std::string* out_error)
+	{
+	#if CONFIGURU_HAS_MMAP
+		// Below this, mapping costs more than it saves:
+		const off_t MIN_MAPPED_SIZE = 64 * 1024;
 
-			if (has_comma) {
-				_ptr += 1;
-				skip_post_white(&value);
-				has_separator = true;
-			}
+		const int fd = open(path, O_RDONLY);
+		if (fd < 0) {
+			file_error(std::string("Failed to open '") + path + "' for reading: " + strerror(errno), out_error);
+			return;
+		}
 
-			array_impl.emplace_back(std::move(value));
+		struct stat info;
+		const bool is_regular = fstat(fd, &info) == 0 && S_ISREG(info.st_mode);
 
-			bool is_last_element = !_ptr[0] || _ptr[0] == ']';
+		if (is_regular && info.st_size >= MIN_MAPPED_SIZE) {
+			const auto size = static_cast<size_t>(info.st_size);
+			void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping != MAP_FAILED) {
+				madvise(mapping, size, MADV_SEQUENTIAL);
+				close(fd);
+				_mapping = mapping;
+				_data    = static_cast<const char*>(mapping);
+				_size    = size;
+				return;
+			}
+		}
 
-			if (is_last_element) {
-				parse_assert(!has_comma || _options.array_trailing_comma,
-					"Trailing comma forbidden.", comma_state);
-			} else {
-				if (_options.array_omit_comma) {
-					parse_assert(has_separator, "Expected a space, newline, comma or ]");
-				} else {
-					parse_assert(has_comma, "Expected a comma or ]");
-				}
+		// Small files, pipes and special files (or if mmap failed): read until end of file.
+		// One extra byte lets us see the end of a regular file without growing the buffer.
+		size_t num_read = 0;
+		int read_errno = 0;
+		_buffer.resize(is_regular ? static_cast<size_t>(info.st_size) + 1 : 64 * 1024);
+		for (;;) {
+			if (num_read == _buffer.size()) {
+				_buffer.resize(2 * _buffer.size());
+			}
+			const auto result = read(fd, &_buffer[num_read], _buffer.size() - num_read);
+			if (result < 0) {
+				if (errno == EINTR) { continue; }
+				read_errno = errno;
+				break;
+			}
+			if (result == 0) {
+				break;
 			}
+			num_read += static_cast<size_t>(result);
+		}
+		close(fd); // The only close on this path, also on a read error
+		if (read_errno != 0) {
+			_buffer.clear();
+			file_error(std::string("Failed to read from '") + path + "': " + strerror(read_errno), out_error);
+			return;
+		}
+		_buffer.resize(num_read);
+	#else
+		if (!read_text_file(path, _buffer, out_error)) {
+			_buffer.clear();
+			return;
 		}
+	#endif
+		_data = _buffer.data();
+		_size = _buffer.size();
 	}
 
-	void Parser::parse_object(Config& object)
+	FileContents::~FileContents()
 	{
-		auto state = get_state();
-
-		swallow('{');
+	#if CONFIGURU_HAS_MMAP
+		if (_mapping) {
+			munmap(_mapping, _size);
+		}
+	#endif
+	}
 
-		_indentation += 1;
-		parse_object_contents(object);
-		_indentation -= 1;
+	// Adds the paths of the #includes in [str, str + length) to `out`. This is a quick scan that does not know about
+	// strings and comments, so it may find some that are not really there. Reading those is a waste, but harmless.
+	static void find_includes(const char* str, size_t length, const std::string& name, std::vector<std::string>& out)
+	{
+		const char* const end = str + length;
+		const char* p = str;
+		while (p < end && (p = static_cast<const char*>(memchr(p, '#', static_cast<size_t>(end - p)))) != nullptr) {
+			p += 1;
+			if (end - p < 7 || memcmp(p, "include", 7) != 0) { continue; }
+			p += 7;
+			while (p < end && (*p == ' ' || *p == '\t')) { p += 1; }
+			if (p == end || (*p != '"' && *p != '<')) { continue; }
+			const char terminator = *p == '"' ? '"' : '>';
+			const char* start = ++p;
+			while (p < end && *p != terminator && *p != '\n') { p += 1; }
+			if (p == end || *p != terminator) { continue; }
+			const std::string path(start, static_cast<size_t>(p - start));
+			out.push_back(terminator == '"' ? relative_include_path(name, path) : path);
+		}
+	}
 
-		if (_ptr[0] == '}') {
-			_ptr += 1;
-		} else {
-			set_state(state);
-			throw_error("Non-terminated object");
+	// Runs `work` on `num_threads` threads, this one included. Makes do with fewer if no more can be started.
+	static void run_on_threads(unsigned num_threads, const std::function<void()>& work)
+	{
+		std::vector<std::thread> threads;
+		for (unsigned t = 1; t < num_threads; ++t) {
+		#if CONFIGURU_EXCEPTIONS
+			try {
+				threads.emplace_back(work);
+			} catch (const std::system_error&) {
+				break; // Make do with the threads we got
+			}
+		#else
+			threads.emplace_back(work);
+		#endif
+		}
+		work();
+		for (auto& thread : threads) {
+			thread.join();
 		}
 	}
 
-	void Parser::parse_object_contents(Config& object)
+	// Reads the files #include:d by the file `name` (and by them, and so on) on options.include_threads threads,
+	// into info.preloaded_files. They are still parsed one by one when the parser reaches them, so the order of
+	// everything (and which error is reported) is the same as without this. Only the waiting for the disk is concurrent.
+	static void preload_includes(const char* str, size_t length, const std::string& name,
+	                             const FormatOptions& options, ParseInfo& info)
 	{
-		object.make_object();
+		if (!options.allow_macro || options.include_threads == 0) { return; }
 
-		Comments next_prefix_comments;
+		std::vector<std::string> queue;
+		find_includes(str, length, name, queue);
+		if (queue.empty()) { return; }
 
-		for (;;)
-		{
-			Config value;
-			if (!next_prefix_comments.empty()) {
-				std::swap(value.comments().prefix, next_prefix_comments);
-			}
-			int line_indentation;
-			skip_pre_white(&value, line_indentation);
+		std::set<std::string>   seen(queue.begin(), queue.end());
+		std::mutex              mutex;
+		std::condition_variable cv;
+		unsigned                num_busy = 0;
 
-			if (_ptr[0] == '}') {
-				if (line_indentation >= 0 && _indentation - 1 != line_indentation) {
-					throw_indentation_error(_indentation - 1, line_indentation);
+		auto work = [&]() {
+			std::unique_lock<std::mutex> lock(mutex);
+			for (;;) {
+				if (queue.empty()) {
+					if (num_busy == 0) { return; }
+					cv.wait(lock); // Until someone finds more files, or is done
+					continue;
 				}
-				if (value.has_comments()) {
-					object.comments().pre_end_brace = value.comments().prefix;
+				const std::string path = std::move(queue.back());
+				queue.pop_back();
+				num_busy += 1;
+				lock.unlock();
+
+				std::string error;
+				std::shared_ptr<const FileContents> file = std::make_shared<const FileContents>(path.c_str(), &error);
+				std::vector<std::string> found;
+				if (error.empty()) {
+					find_includes(file->data(), file->size(), path, found);
+				} else {
+					file.reset(); // The parser reads it again, and reports the error.
 				}
-				break;
-			}
 
-			if (!_ptr[0]) {
-				if (value.has_comments()) {
-					object.comments().pre_end_brace = value.comments().prefix;
+				lock.lock();
+				num_busy -= 1;
+				if (file) {
+					info.preloaded_files.emplace(path, std::move(file));
 				}
-				break;
-			}
-
-			if (line_indentation >= 0 && _indentation != line_indentation) {
-				throw_indentation_error(_indentation, line_indentation);
-			}
-
-			auto pre_key_state = get_state();
-			std::string key;
-
-			if (IDENT_STARTERS[static_cast<uint8_t>(_ptr[0])] && !is_reserved_identifier(_ptr)) {
-				parse_assert(_options.identifiers_keys, "You need to surround keys with quotes");
-				while (IDENT_CHARS[static_cast<uint8_t>(_ptr[0])]) {
-					key += _ptr[0];
-					_ptr += 1;
+				for (auto& child : found) {
+					if (seen.insert(child).second) {
+						queue.push_back(std::move(child));
+					}
 				}
+				cv.notify_all();
 			}
-			else if (_ptr[0] == '"' || _ptr[0] == '@') {
-				key = parse_string();
-			} else {
-				throw_error("Object key expected (either an identifier or a quoted string), got " + quote(_ptr[0]));
-			}
-
-			if (!_options.object_duplicate_keys && object.has_key(key)) {
-				set_state(pre_key_state);
-				throw_error("Duplicate key: \"" + key + "\". Already set at " + object[key].where());
-			}
+		};
 
-			bool space_after_key = skip_white_ignore_comments();
+		run_on_threads(options.include_threads, work);
+	}
 
-			if (_ptr[0] == ':' || (_options.object_separator_equal && _ptr[0] == '=')) {
-				parse_assert(_options.allow_space_before_colon || _ptr[0] != ':' || !space_after_key, "No space allowed before colon");
-				_ptr += 1;
-				skip_white_ignore_comments();
-			} else if (_options.omit_colon_before_object && (_ptr[0] == '{' || _ptr[0] == '#')) {
-				// Ok to omit : in this case
-			} else {
-				if (_options.object_separator_equal && _options.omit_colon_before_object) {
-					throw_error("Expected one of '=', ':', '{' or '#' after object key");
-				} else {
-					throw_error("Expected : after object key");
-				}
-			}
+	bool try_parse_file(const std::string& path, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info,
+	                    Config& out, ParseFailure& out_failure)
+	{
+		auto it = info.preloaded_files.find(path);
+		if (it != info.preloaded_files.end()) {
+			const auto file = std::move(it->second);
+			info.preloaded_files.erase(it);
+			return try_parse_string(file->data(), file->size(), options, doc, info, out, out_failure);
+		}
+
+		std::string error;
+		FileContents file(path.c_str(), &error);
+		if (!error.empty()) {
+			out_failure.doc         = doc;
+			out_failure.line        = 0;
+			out_failure.column      = 0;
+			out_failure.description = error;
+			return false;
+		}
+		return try_parse_string(file.data(), file.size(), options, doc, info, out, out_failure);
+	}
 
-			bool has_separator;
-			parse_value(value, &has_separator);
-			int ignore;
-			skip_white(&next_prefix_comments, ignore, false);
+	Config parse_file(const std::string& path, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info)
+	{
+		Config result;
+		ParseFailure failure;
+		if (!try_parse_file(path, options, doc, info, result, failure)) {
+			throw_parse_error(failure);
+		}
+		return result;
+	}
 
-			auto comma_state = get_state();
-			bool has_comma = _ptr[0] == ',';
+	Config parse_file(const std::string& path, const FormatOptions& options)
+	{
+		FileContents file(path.c_str());
+		ParseInfo info;
+		preload_includes(file.data(), file.size(), path, options, info);
+		return parse_string(file.data(), file.size(), options, std::make_shared<DocInfo>(path), info);
+	}
 
-			if (has_comma) {
-				_ptr += 1;
-				skip_post_white(&value);
-				has_separator = true;
-			}
+	void parse_file(const std::string& path, const FormatOptions& options, ParseHandler& handler)
+	{
+		FileContents file(path.c_str());
+		ParseInfo info;
+		preload_includes(file.data(), file.size(), path, options, info);
+		parse_string(file.data(), file.size(), options, std::make_shared<DocInfo>(path), info, handler);
+	}
 
-			object.emplace(std::move(key), std::move(value));
+	ParseResult parse_file_noexcept(const std::string& path, const FormatOptions& options)
+	{
+		auto doc = std::make_shared<DocInfo>(path);
+		ParseFailure failure;
 
-			bool is_last_element = !_ptr[0] || _ptr[0] == '}';
+		std::string error;
+		FileContents file(path.c_str(), &error);
+		if (!error.empty()) {
+			failure.doc         = doc;
+			failure.description = error;
+			return failed_result(failure);
+		}
 
-			if (is_last_element) {
-				parse_assert(!has_comma || _options.object_trailing_comma,
-					"Trailing comma forbidden.", comma_state);
-			} else {
-				if (_options.object_omit_comma) {
-					parse_assert(has_separator, "Expected a space, newline, comma or }");
-				} else {
-					parse_assert(has_comma, "Expected a comma or }");
-				}
-			}
+		ParseInfo info;
+		preload_includes(file.data(), file.size(), path, options, info);
+		ParseResult result;
+		if (!try_parse_string(file.data(), file.size(), options, doc, info, result.config, failure)) {
+			return failed_result(failure);
 		}
+		result.ok = true;
+		return result;
 	}
 
-	void Parser::parse_int(Config& out)
+	static Config parse_lazy_source(const std::shared_ptr<const LazySource>& source)
 	{
-		const auto start = _ptr;
-		const auto result = strtoll(start, const_cast<char**>(&_ptr), 10);
-		parse_assert(start < _ptr, "Invalid integer");
-		parse_assert(start[0] != '0' || result == 0, "Integer may not start with a zero");
-		out = result;
+		ParseInfo info;
+		ConfigBuilder builder(source->doc, source->options);
+		Parser p(source->begin, static_cast<size_t>(source->end - source->begin), source->options, source->doc, info, builder);
+		p.set_lazy_source(source);
+		if (!p.top_level()) {
+			throw_parse_error(p.failure());
+		}
+		return builder.result();
 	}
 
-	void Parser::parse_float(Config& out)
+	Config parse_file_lazy(const std::string& path, const FormatOptions& options)
 	{
-		const auto start = _ptr;
-		const double result = strtod(start, const_cast<char**>(&_ptr));
-		parse_assert(start < _ptr, "Invalid number");
-		out = result;
+		auto file = std::make_shared<FileContents>(path.c_str());
+		return parse_lazy_source(std::make_shared<LazySource>(LazySource{
+			file, file->data(), file->data() + file->size(), options, std::make_shared<DocInfo>(path)}));
 	}
 
-	void Parser::parse_finite_number(Config& out)
+	Config parse_string_lazy(std::string str, const FormatOptions& options, const char* name)
 	{
-		const auto pre_sign = _ptr;
-		int sign = +1;
+		auto text = std::make_shared<std::string>(std::move(str));
+		return parse_lazy_source(std::make_shared<LazySource>(LazySource{
+			text, text->data(), text->data() + text->size(), options, std::make_shared<DocInfo>(name)}));
+	}
 
-		if (_ptr[0] == '+') {
-			parse_assert(_options.unary_plus, "Prefixing numbers with + is forbidden.");
-			_ptr += 1;
+	void Config::parse_lazy(bool recursive) const
+	{
+		ParseInfo info;
+		ParseFailure failure;
+		if (!try_parse_lazy(recursive, info, failure)) {
+			throw_parse_error(failure);
 		}
-		if (_ptr[0] == '-') {
-			_ptr += 1;
-			sign = -1;
+	}
+
+	bool Config::try_parse_lazy(bool recursive, ParseInfo& info, ParseFailure& out_failure) const
+	{
+		// Another thread may be parsing us right now. If so, we wait for it and are done.
+		// The lock is never held while taking another one, since the mutexes are shared.
+		const void* container = is_object() ? static_cast<const void*>(_u.object) : static_cast<const void*>(_u.array);
+		std::unique_lock<std::mutex> lock(lazy_mutex(container));
+		const LazyRange_SP range = is_object() ? _u.object->_lazy : _u.array->_lazy;
+		if (!range) { return true; }
+		const LazySource& source = *range->source;
+
+		ConfigBuilder builder(source.doc, source.options);
+		Parser p(source.begin, static_cast<size_t>(source.end - source.begin), source.options, source.doc, info, builder);
+		if (!recursive) {
+			p.set_lazy_source(range->source);
+		}
+		if (!p.parse_range(*range)) {
+			out_failure = p.failure();
+			return false;
 		}
+		Config contents = builder.result();
+		const bool accessed = is_object() ? _u.object->_lazy_accessed : _u.array->_lazy_accessed;
 
-		parse_assert(_ptr[0] != '+' && _ptr[0] != '-', "Duplicate sign");
+		if (contents.has_comments()) {
+			// Comments before the closing brace:
+			const_cast<Config*>(this)->comments().append(std::move(contents.comments()));
+		}
 
-		// Check if it's an integer:
-		if (_ptr[0] == '0' && _ptr[1] == 'x') {
-			parse_assert(_options.hexadecimal_integers, "Hexadecimal numbers forbidden.");
-			_ptr += 2;
-			auto start = _ptr;
-			out = sign * static_cast<int64_t>(strtoull(start, const_cast<char**>(&_ptr), 16));
-			parse_assert(start < _ptr, "Missing hexaxdecimal digits after 0x");
-			return;
+		// Shallow copies share the contents, so they see them parsed too.
+		// Threads that see _is_lazy cleared also see the new _impl:
+		if (is_object()) {
+			_u.object->_impl.swap(contents._u.object->_impl);
+			_u.object->_lazy.reset();
+			_u.object->_is_lazy.store(false, std::memory_order_release);
+		} else {
+			_u.array->_impl.swap(contents._u.array->_impl);
+			_u.array->_lazy.reset();
+			_u.array->_is_lazy.store(false, std::memory_order_release);
 		}
+		lock.unlock();
 
-		if (_ptr[0] == '0' && _ptr[1] == 'b') {
-			parse_assert(_options.binary_integers, "Binary numbers forbidden.");
-			_ptr += 2;
-			auto start = _ptr;
-			out = sign * static_cast<int64_t>(strtoull(start, const_cast<char**>(&_ptr), 2));
-			parse_assert(start < _ptr, "Missing binary digits after 0b");
-			return;
+		if (accessed) {
+			mark_accessed(true);
 		}
+		return true;
+	}
 
-		const char* p = _ptr;
+	void Config::parse_lazy_children(unsigned num_threads) const
+	{
+		std::vector<const Config*> lazy;
+		auto add = [&](const Config& value) {
+			if ((value.is_object() && value._u.object->_is_lazy) || (value.is_array() && value._u.array->_is_lazy)) {
+				lazy.push_back(&value);
+			}
+		};
+		if (is_object()) {
+			for (const auto& p : _u.object->_impl) { add(p.second._value); }
+		} else if (is_array()) {
+			for (const auto& value : _u.array->_impl) { add(value); }
+		}
 
-		while ('0' <= *p && *p <= '9') {
-			p += 1;
+		// Threads claim small batches in document order, so they stay busy even if the sizes vary a lot:
+		const size_t batch_size = 16;
+		const size_t num_batches = (lazy.size() + batch_size - 1) / batch_size;
+		if (num_threads == 0) {
+			num_threads = std::max(1u, std::thread::hardware_concurrency());
 		}
+		num_threads = static_cast<unsigned>(std::min<size_t>(num_threads, num_batches));
 
-		if (*p == '.' || *p == 'e' || *p == 'E') {
-			_ptr = pre_sign;
-			return parse_float(out);
+		std::atomic<size_t> next{0};
+		std::mutex          error_mutex;
+		size_t              error_index = lazy.size();
+		ParseFailure        error;
+
+		auto work = [&]() {
+			ParseInfo    info; // Shared by the records of this thread, so each #include:d file is parsed once per thread
+			ParseFailure failure;
+			for (;;) {
+				const size_t begin = next.fetch_add(batch_size);
+				if (begin >= lazy.size()) { return; }
+				const size_t end = std::min(begin + batch_size, lazy.size());
+				for (size_t i = begin; i < end; ++i) {
+					if (!lazy[i]->try_parse_lazy(true, info, failure)) {
+						// Any earlier error is in a batch claimed before this one, so it is found too.
+						std::lock_guard<std::mutex> lock(error_mutex);
+						if (i < error_index) {
+							error_index = i;
+							error = std::move(failure);
+						}
+						return;
+					}
+				}
+			}
+		};
+
+		run_on_threads(num_threads, work);
+
+		if (error_index < lazy.size()) {
+			throw_parse_error(error); // The first error in the document, just like parse_file
 		}
+	}
+
+	static Config parse_parallel(const std::shared_ptr<const LazySource>& source, unsigned num_threads)
+	{
+		// Only the top level is parsed here. The arrays/objects in it are skipped over and remembered as ranges:
+		Config root = parse_lazy_source(source);
+		root.parse_lazy_children(num_threads);
+		return root;
+	}
+
+	Config parse_file_parallel(const std::string& path, const FormatOptions& options, unsigned num_threads)
+	{
+		auto file = std::make_shared<FileContents>(path.c_str());
+		return parse_parallel(std::make_shared<LazySource>(LazySource{
+			file, file->data(), file->data() + file->size(), options, std::make_shared<DocInfo>(path)}), num_threads);
+	}
 
-		// It looks like an integer - but it may be too long to represent as one!
-		const auto MAX_INT_STR = (sign == +1 ? "9223372036854775807" : "9223372036854775808");
+	Config parse_string_parallel(std::string str, const FormatOptions& options, const char* name, unsigned num_threads)
+	{
+		auto text = std::make_shared<std::string>(std::move(str));
+		return parse_parallel(std::make_shared<LazySource>(LazySource{
+			text, text->data(), text->data() + text->size(), options, std::make_shared<DocInfo>(name)}), num_threads);
+	}
 
-		const auto length = p - _ptr;
+	// ----------------------------------------------------------------------------------------
 
-		if (length < 19) {
-			_ptr = pre_sign;
-			return parse_int(out);
+	// Which file a path leads to, and what it looked like when we read it.
+	struct FileStamp
+	{
+		std::string canonical_path;
+		uint64_t    device   = 0;
+		uint64_t    inode    = 0;
+		int64_t     mtime_ns = 0;
+		uint64_t    size     = 0;
+
+		bool operator==(const FileStamp& o) const
+		{
+			return canonical_path == o.canonical_path && device == o.device && inode == o.inode
+			    && mtime_ns == o.mtime_ns && size == o.size;
 		}
+	};
 
-		if (length > 19) {
-			_ptr = pre_sign;
-			return parse_float(out); // Uncommon case optimization
+	// Returns false if there is no such file (or we cannot tell on this platform).
+	static bool stamp_file(const std::string& path, FileStamp& stamp)
+	{
+	#if CONFIGURU_HAS_MMAP
+		char* canonical = realpath(path.c_str(), nullptr);
+		if (canonical == nullptr) {
+			return false;
 		}
+		stamp.canonical_path = canonical;
+		free(canonical);
 
-		// Compare fast:
-		for (int i = 0; i < 19; ++i)
-		{
-			if (_ptr[i] > MAX_INT_STR[i]) {
-				_ptr = pre_sign;
-				return parse_float(out);
-			}
-			if (_ptr[i] < MAX_INT_STR[i]) {
-				_ptr = pre_sign;
-				return parse_int(out);
-			}
+		struct stat info;
+		if (stat(stamp.canonical_path.c_str(), &info) != 0) {
+			return false;
 		}
-		_ptr = pre_sign;
-		return parse_int(out); // Exactly max int
+		stamp.device = static_cast<uint64_t>(info.st_dev);
+		stamp.inode  = static_cast<uint64_t>(info.st_ino);
+		stamp.size   = static_cast<uint64_t>(info.st_size);
+		#if defined(__APPLE__)
+			stamp.mtime_ns = static_cast<int64_t>(info.st_mtimespec.tv_sec) * 1000000000 + info.st_mtimespec.tv_nsec;
+		#else
+			stamp.mtime_ns = static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+		#endif
+		return true;
+	#else
+		(void)path;
+		(void)stamp;
+		return false;
+	#endif
 	}
 
-	std::string Parser::parse_c_sharp_string()
+	struct IncludeCache::Impl
 	{
-		// C# style verbatim string - everything until the next " except "" which is ":
-		auto state = get_state();
-		parse_assert(_options.str_csharp_verbatim, "C# @-style verbatim strings forbidden.");
-		swallow('@');
-		swallow('"');
+		struct Entry
+		{
+			Config                 value;      // Our own copy, never handed out, so changing a result does not change it.
+			DocInfo_SP             doc;        // What value is tagged with.
+			DocInfo_SP             result_doc; // What the copies of the last parse_file that used it are tagged with.
+			std::vector<FileStamp> files;      // This file and all files it #includes, recursively.
+			unsigned               generation; // Of the last parse_file that used it.
+		};
 
-		std::string str;
+		std::map<std::string, Entry>        entries;  // By canonical path.
+		std::vector<std::vector<FileStamp>> building; // What each of the files being parsed depends on, innermost last.
+		unsigned                            generation = 0;
 
-		for (;;) {
-			if (_ptr[0] == 0) {
-				set_state(state);
-				throw_error("Unterminated verbatim string");
-			}
-			else if (_ptr[0] == '\n') {
-				throw_error("Newline in verbatim string");
-			}
-			else if (_ptr[0] == '"' && _ptr[1] == '"') {
-				// Escaped quote
-				_ptr += 2;
-				str.push_back('"');
-			}
-			else if (_ptr[0] == '"') {
-				_ptr += 1;
-				return str;
-			}
-			else {
-				str += _ptr[0];
-				_ptr += 1;
+		static bool is_current(const Entry& entry)
+		{
+			FileStamp now;
+			for (const auto& file : entry.files) {
+				if (!stamp_file(file.canonical_path, now) || !(now == file)) {
+					return false;
+				}
 			}
+			return true;
 		}
-	}
 
-	std::string Parser::parse_string()
-	{
-		if (_ptr[0] == '@') {
-			return parse_c_sharp_string();
+		void depend_on(const std::vector<FileStamp>& files)
+		{
+			if (!building.empty()) {
+				building.back().insert(building.back().end(), files.begin(), files.end());
+			}
 		}
 
-		auto state = get_state();
-		parse_assert(_ptr[0] == '"', "Quote (\") expected");
-
-		if (_ptr[1] == '"' && _ptr[2] == '"') {
-			// Python style multiline string - everything until the next """:
-			parse_assert(_options.str_python_multiline, "Python \"\"\"-style multiline strings forbidden.");
-			_ptr += 3;
-			const char* start = _ptr;
-			for (;;) {
-				if (_ptr[0]==0 || _ptr[1]==0 || _ptr[2]==0) {
-					set_state(state);
-					throw_error("Unterminated multiline string");
-				}
+		// Deep copies a tree, tagged with copies of the DocInfos of the old one, so that where
+		// a new result #includes things does not change the error messages of earlier results.
+		struct DocCopier
+		{
+			std::map<const DocInfo*, DocInfo_SP> copies; // Old doc -> new doc
 
-				if (_ptr[0] == '"' && _ptr[1] == '"' && _ptr[2] == '"' && _ptr[3] != '"') {
-					std::string str(start, _ptr);
-					_ptr += 3;
-					return str;
+			DocInfo_SP copy_doc(const DocInfo_SP& doc)
+			{
+				auto& copy = copies[doc.get()];
+				if (!copy) {
+					copy = std::make_shared<DocInfo>(doc->filename);
+					for (const auto& includer : doc->includers) {
+						// Includers outside of the copied tree belong to earlier results:
+						auto it = copies.find(includer.doc.get());
+						if (it != copies.end()) {
+							copy->includers.emplace_back(it->second, includer.line);
+						}
+					}
 				}
+				return copy;
+			}
 
-				if (_ptr[0] == '\n') {
-					_ptr += 1;
-					_line_nr += 1;
-					_line_start = _ptr;
+			Config copy_tree(const Config& value)
+			{
+				const DocInfo_SP old_doc = value.doc();
+				const DocInfo_SP new_doc = old_doc ? copy_doc(old_doc) : nullptr; // Before the children, who may be included from it
+				Config copy;
+				if (value.is_object()) {
+					copy = Config::object(copy_resource(value.memory_resource()));
+					for (const auto& p : value.as_object()._impl) {
+						auto& dst = copy.as_object()._impl[p.first];
+						dst._nr       = p.second._nr;
+						dst._accessed = p.second._accessed;
+						dst._value    = copy_tree(p.second._value);
+					}
+				} else if (value.is_array()) {
+					copy = Config::array(copy_resource(value.memory_resource()));
+					for (const auto& element : value.as_array()) {
+						copy.push_back(copy_tree(element));
+					}
 				} else {
-					_ptr += 1;
+					copy = value;
 				}
+				if (value.has_comments()) {
+					copy.comments() = value.comments();
+				}
+				copy.tag(new_doc, value.line(), 0);
+				return copy;
 			}
-		} else {
-			// Normal string
-			_ptr += 1; // Swallow quote
+		};
+	};
 
-			std::string str;
+	IncludeCache::IncludeCache(const FormatOptions& options) : _options(options), _impl(new Impl()) {}
+	IncludeCache::~IncludeCache() = default;
 
-			for (;;) {
-				// Handle larges swats of safe characters at once:
-				auto safe_end = _ptr;
-				while (!SPECIAL_CHARACTERS[static_cast<uint8_t>(*safe_end)]) {
-					++safe_end;
-				}
+	Config IncludeCache::parse_file(const std::string& path)
+	{
+		_impl->generation += 1;
+		_impl->building.clear();
+		ParseInfo info;
+		info.include_cache = this;
+		return configuru::parse_file(path, _options, std::make_shared<DocInfo>(path), info);
+	}
 
-				if (_ptr != safe_end) {
-					str.append(_ptr, safe_end - _ptr);
-					_ptr = safe_end;
-				}
+	size_t IncludeCache::size() const
+	{
+		return _impl->entries.size();
+	}
 
-				if (_ptr[0] == 0) {
-					set_state(state);
-					throw_error("Unterminated string");
-				}
-				if (_ptr[0] == '"') {
-					_ptr += 1;
-					return str;
-				}
-				if (_ptr[0] == '\n') {
-					throw_error("Newline in string");
-				}
-				if (_ptr[0] == '\t') {
-					parse_assert(_options.str_allow_tab, "Un-escaped tab not allowed in string");
-				}
+	void IncludeCache::clear()
+	{
+		_impl->entries.clear();
+	}
 
-				if (_ptr[0] == '\\') {
-					// Escape sequence
-					_ptr += 1;
+	bool IncludeCache::include(const std::string& path, const DocInfo_SP& includer, Index line, ParseInfo& info,
+	                           Config& out, ParseFailure& out_failure)
+	{
+		FileStamp stamp;
+		const bool exists = stamp_file(path, stamp);
+		if (exists) {
+			auto it = _impl->entries.find(stamp.canonical_path);
+			if (it != _impl->entries.end() && Impl::is_current(it->second)) {
+				auto& entry = it->second;
+				if (entry.generation != _impl->generation) {
+					// Earlier results keep their DocInfo, this parse gets one with its own includers:
+					entry.result_doc = std::make_shared<DocInfo>(entry.doc->filename);
+					entry.generation = _impl->generation;
+				}
+				entry.result_doc->includers.emplace_back(includer, line);
+				_impl->depend_on(entry.files);
+				Impl::DocCopier copier;
+				copier.copies[entry.doc.get()] = entry.result_doc;
+				out = copier.copy_tree(entry.value);
+				return true;
+			}
+		}
 
-					if (_ptr[0] == '"') {
-						str.push_back('"');
-						_ptr += 1;
-					} else if (_ptr[0] == '\\') {
-						str.push_back('\\');
-						_ptr += 1;
-					} else if (_ptr[0] == '/') {
-						str.push_back('/');
-						_ptr += 1;
-					} else if (_ptr[0] == 'b') {
-						str.push_back('\b');
-						_ptr += 1;
-					} else if (_ptr[0] == 'f') {
-						str.push_back('\f');
-						_ptr += 1;
-					} else if (_ptr[0] == 'n') {
-						str.push_back('\n');
-						_ptr += 1;
-					} else if (_ptr[0] == 'r') {
-						str.push_back('\r');
-						_ptr += 1;
-					} else if (_ptr[0] == 't') {
-						str.push_back('\t');
-						_ptr += 1;
-					} else if (_ptr[0] == 'u') {
-						// Four hexadecimal characters
-						_ptr += 1;
-						uint64_t codepoint = parse_hex(4);
+		auto doc = std::make_shared<DocInfo>(path);
+		doc->includers.emplace_back(includer, line);
+		if (!exists) {
+			return try_parse_file(path, _options, doc, info, out, out_failure); // Reports the error
+		}
 
-						if (0xD800 <= codepoint && codepoint <= 0xDBFF)
-						{
-							// surrogate pair
-							parse_assert(_ptr[0] == '\\' && _ptr[1] == 'u',
-										 "Missing second unicode surrogate.");
-							_ptr += 2;
-							uint64_t codepoint2 = parse_hex(4);
-							parse_assert(0xDC00 <= codepoint2 && codepoint2 <= 0xDFFF, "Invalid second unicode surrogate");
-							codepoint = (codepoint << 10) + codepoint2 - 0x35FDC00;
-						}
+		_impl->building.emplace_back(1, stamp);
+		const bool ok = try_parse_file(path, _options, doc, info, out, out_failure);
+		auto files = std::move(_impl->building.back());
+		_impl->building.pop_back();
+		if (!ok) {
+			return false;
+		}
+		std::sort(files.begin(), files.end(), [](const FileStamp& a, const FileStamp& b) {
+			return a.canonical_path < b.canonical_path;
+		});
+		files.erase(std::unique(files.begin(), files.end()), files.end());
+		_impl->depend_on(files);
+		Impl::DocCopier copier;
+		Config value = copier.copy_tree(out);
+		const DocInfo_SP own_doc = copier.copy_doc(doc); // Made by copy_tree, unless out has no location
+		_impl->entries[stamp.canonical_path] = Impl::Entry{std::move(value), own_doc, doc, std::move(files), _impl->generation};
+		return true;
+	}
 
-						auto num_bytes_written = encode_utf8(str, codepoint);
-						parse_assert(num_bytes_written > 0, "Bad unicode codepoint");
-					} else if (_ptr[0] == 'U') {
-						// Eight hexadecimal characters
-						parse_assert(_options.str_32bit_unicode, "\\U 32 bit unicodes forbidden.");
-						_ptr += 1;
-						uint64_t unicode = parse_hex(8);
-						auto num_bytes_written = encode_utf8(str, unicode);
-						parse_assert(num_bytes_written > 0, "Bad unicode codepoint");
-					} else {
-						throw_error("Unknown escape character " + quote(_ptr[0]));
-					}
-				} else {
-					str.push_back(_ptr[0]);
-					_ptr += 1;
-				}
+	void IncludeCache::include_again(const std::string& path)
+	{
+		FileStamp stamp;
+		if (!_impl->building.empty() && stamp_file(path, stamp)) {
+			auto it = _impl->entries.find(stamp.canonical_path);
+			if (it != _impl->entries.end()) {
+				_impl->depend_on(it->second.files);
 			}
 		}
 	}
 
-	uint64_t Parser::parse_hex(int count)
+	Config ParseSession::parse_string(const char* str, const char* name)
 	{
-		uint64_t ret = 0;
-		for (int i=0; i<count; ++i) {
-			ret *= 16;
-			char c = _ptr[i];
-			if ('0' <= c && c <= '9') {
-				ret += static_cast<uint64_t>(c - '0');
-			} else if ('a' <= c && c <= 'f') {
-				ret += static_cast<uint64_t>(10 + c - 'a');
-			} else if ('A' <= c && c <= 'F') {
-				ret += static_cast<uint64_t>(10 + c - 'A');
-			} else {
-				throw_error("Expected hexadecimal digit, got " + quote(_ptr[0]));
-			}
+		return parse_string(str, strlen(str), name);
+	}
+
+	Config ParseSession::parse_string(const char* str, size_t length, const char* name)
+	{
+		if (!_doc || _doc->filename != name) {
+			_doc = std::make_shared<DocInfo>(name);
 		}
-		_ptr += count;
-		return ret;
+		_info.parsed_files.clear();
+		_info.preloaded_files.clear();
+		return configuru::parse_string(str, length, _options, _doc, _info);
 	}
 
-	void Parser::parse_macro(Config& dst)
+	Config ParseSession::parse_file(const std::string& path)
 	{
-		parse_assert(_options.allow_macro, "#macros forbidden.");
+		_info.parsed_files.clear();
+		_info.preloaded_files.clear();
+		FileContents file(path.c_str());
+		preload_includes(file.data(), file.size(), path, _options, _info);
+		return configuru::parse_string(file.data(), file.size(), _options, std::make_shared<DocInfo>(path), _info);
+	}
 
-		swallow("#include", "Expected '#include'");
-		skip_white_ignore_comments();
+	// ----------------------------------------------------------------------------------------
 
-		bool absolute;
-		char terminator;
+	struct IncrementalParser::Impl
+	{
+		FormatOptions           options;
+		DocInfo_SP              doc;
+		ParseInfo               info;
+		ConfigBuilder           builder;
+		std::string             buffer;
+		std::unique_ptr<Parser> parser;   // Created on the first attempt
+		bool                    began        = false;
+		bool                    contents_end = false;
+		bool                    finished     = false;
+		size_t                  retry_size   = 0; // Try parsing when the buffer is this big
+
+		Impl(const FormatOptions& options_, const char* name)
+			: options(options_), doc(std::make_shared<DocInfo>(name)), builder(doc, options) {}
+
+		void advance(bool is_final);
+
+		// Lets go of the input that has been parsed.
+		void release_parsed();
+	};
 
-		if (_ptr[0] == '"') {
-			absolute = false;
-			terminator = '"';
-		} else if (_ptr[0] == '<') {
-			absolute = true;
-			terminator = '>';
-		} else {
-			throw_error("Expected \" or <");
+	void IncrementalParser::Impl::advance(bool is_final)
+	{
+		// We only parse up to this far from the end of what we have received,
+		// so that no token is cut short by the end of a chunk.
+		const size_t margin = 16;
+
+		// Parsing is retried once we have received this much beyond this attempt, or
+		// as much again as is waiting to be parsed, whichever is larger.
+		// The latter keeps the work linear even when a single value spans many chunks.
+		const size_t min_retry_bytes = 4096;
+
+		const char* end = buffer.data() + buffer.size();
+		if (!parser) {
+			parser.reset(new Parser(buffer.data(), buffer.size(), options, doc, info, builder));
 		}
+		parser->set_input_end(end, is_final ? 0 : margin);
 
-		auto state = get_state();
-		_ptr += 1;
-		auto start = _ptr;
-		std::string path;
-		for (;;) {
-			if (_ptr[0] == 0) {
-				set_state(state);
-				throw_error("Unterminated include path");
-			} else if (_ptr[0] == terminator) {
-				path = std::string(start, static_cast<size_t>(_ptr - start));
-				_ptr += 1;
-				break;
-			} else if (_ptr[0] == '\n') {
-				throw_error("Newline in string");
-			} else {
-				_ptr += 1;
-			}
+		auto checkpoint = parser->checkpoint();
+		if (!began) {
+			began = parser->begin_top_level();
+		}
+		while (began && !contents_end) {
+			checkpoint = parser->checkpoint();
+			contents_end = !parser->parse_step() && !parser->failed();
+			if (parser->failed()) { break; }
 		}
 
-		if (!absolute) {
-			auto my_path = _doc->filename;
-			auto pos = my_path.find_last_of('/');
-			if (pos != std::string::npos) {
-				auto my_dir = my_path.substr(0, pos+1);
-				path = my_dir + path;
+		if (parser->failed()) {
+			if (is_final) {
+				throw_parse_error(parser->failure());
 			}
+			// We ran out of input, or perhaps the rest of the value has not arrived yet
+			parser->restore(checkpoint);
 		}
 
-		auto it = _info.parsed_files.find(path);
-		if (it == _info.parsed_files.end()) {
-			auto child_doc = std::make_shared<DocInfo>(path);
-			child_doc->includers.emplace_back(_doc, _line_nr);
-			dst = parse_file(path.c_str(), _options, child_doc, _info);
-			_info.parsed_files[path] = dst;
-		} else {
-			auto child_doc = it->second.doc();
-			child_doc->includers.emplace_back(_doc, _line_nr);
-			dst = it->second;
+		if (!is_final) {
+			release_parsed();
 		}
-	}
 
-	// ----------------------------------------------------------------------------------------
+		const size_t unparsed = static_cast<size_t>(buffer.data() + buffer.size() - parser->position());
+		retry_size = buffer.size() + std::max(unparsed, min_retry_bytes);
+	}
 
-	Config parse_string(const char* str, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info)
+	void IncrementalParser::Impl::release_parsed()
 	{
-		Parser p(str, options, doc, info);
-		return p.top_level();
+		// A bit of the current line is kept, for error messages:
+		const size_t max_context = 256;
+
+		const char*  begin      = buffer.data();
+		const size_t position   = static_cast<size_t>(parser->position() - begin);
+		const size_t line_start = static_cast<size_t>(std::max(parser->start_of_line(), begin) - begin);
+		const size_t keep_from  = std::max(position - std::min(position, max_context), line_start);
+
+		// Moving the rest down costs as much as it keeps, so only do it once that is no more than what we let go of:
+		if (keep_from == 0 || keep_from < buffer.size() - keep_from) {
+			return;
+		}
+		const char* old_begin = buffer.data() + keep_from;
+		parser->keep_open_lines(old_begin);
+		buffer.erase(0, keep_from);
+		parser->relocate(old_begin, buffer.data());
 	}
 
-	Config parse_string(const char* str, const FormatOptions& options, const char* name)
+	IncrementalParser::IncrementalParser(const FormatOptions& options, const char* name)
+		: _impl(new Impl(options, name))
 	{
-		ParseInfo info;
-		return parse_string(str, options, std::make_shared<DocInfo>(name), info);
 	}
 
-	std::string read_text_file(const char* path)
+	IncrementalParser::~IncrementalParser() = default;
+
+	void IncrementalParser::feed(const char* data, size_t length)
 	{
-		FILE* fp = fopen(path, "rb");
-		if (fp == nullptr) {
-			CONFIGURU_ONERROR(std::string("Failed to open '") + path + "' for reading: " + strerror(errno));
+		Impl& impl = *_impl;
+		if (impl.finished) {
+			CONFIGURU_ONERROR("IncrementalParser::feed called after finish");
 		}
-		std::string contents;
-		fseek(fp, 0, SEEK_END);
-		const auto size = ftell(fp);
-		if (size < 0) {
-			fclose(fp);
-			CONFIGURU_ONERROR(std::string("Failed to find out size of '") + path + "': " + strerror(errno));
-		}
-		contents.resize(static_cast<size_t>(size));
-		rewind(fp);
-		const auto num_read = fread(&contents[0], 1, contents.size(), fp);
-		fclose(fp);
-		if (num_read != contents.size()) {
-			CONFIGURU_ONERROR(std::string("Failed to read from '") + path + "': " + strerror(errno));
+		std::string& buffer = impl.buffer;
+
+		if (impl.parser && buffer.capacity() - buffer.size() < length) {
+			// Grow by hand so the parser can follow its input to the new buffer:
+			std::string bigger;
+			bigger.reserve(std::max(2 * buffer.capacity(), buffer.size() + length));
+			bigger.append(buffer);
+			impl.parser->relocate(buffer.data(), bigger.data());
+			buffer.swap(bigger);
 		}
-		return contents;
-	}
+		buffer.append(data, length);
 
-	Config parse_file(const std::string& path, const FormatOptions& options, DocInfo_SP doc, ParseInfo& info)
-	{
-		// auto file = util::FILEWrapper::read_text_file(path);
-		auto file = read_text_file(path.c_str());
-		return parse_string(file.c_str(), options, doc, info);
+		if (buffer.size() >= impl.retry_size) {
+			impl.advance(false);
+		}
 	}
 
-	Config parse_file(const std::string& path, const FormatOptions& options)
+	Config IncrementalParser::finish()
 	{
-		ParseInfo info;
-		return parse_file(path, options, std::make_shared<DocInfo>(path), info);
+		if (_impl->finished) {
+			CONFIGURU_ONERROR("IncrementalParser::finish called twice");
+		}
+		_impl->finished = true;
+		_impl->advance(true);
+		if (!_impl->parser->end_top_level()) {
+			throw_parse_error(_impl->parser->failure());
+		}
+		return _impl->builder.result();
 	}
 }
 
@@ -3145,60 +8590,30 @@ namespace configuru
 
 namespace configuru
 {
-	bool is_identifier(const char* p)
+	bool has_pre_end_brace_comments(const Config& cfg)
 	{
-		if (*p == '_'
-			 || ('a' <= *p && *p <= 'z')
-			 || ('A' <= *p && *p <= 'Z'))
-		{
-			++p;
-			while (*p) {
-				if (*p == '_'
-					 || ('a' <= *p && *p <= 'z')
-					 || ('A' <= *p && *p <= 'Z')
-					 || ('0' <= *p && *p <= '9'))
-				{
-					++p;
-				} else {
-					return false;
-				}
-			}
-			return true;
-		} else {
-			return false;
-		}
+		return cfg.has_comments() && !cfg.comments().pre_end_brace.empty();
 	}
 
-	bool has_pre_end_brace_comments(const Config& cfg)
+	constexpr uint64_t safe_characters(int w)
 	{
-		return cfg.has_comments() && !cfg.comments().pre_end_brace.empty();
+		return byte_range(w, 0x20, 0xFF) & ~byte_range(w, '\\', '\\') & ~byte_range(w, '"', '"');
 	}
 
+	// Characters that can be written as-is inside a string.
+	constexpr CharTable SAFE_CHARACTERS = {{ safe_characters(0), safe_characters(1), safe_characters(2), safe_characters(3) }};
+
 	struct Writer
 	{
-		std::string   _out;
-		bool          _compact;
-		FormatOptions _options;
-		bool          SAFE_CHARACTERS[256];
-		DocInfo_SP    _doc;
+		std::string          _out;
+		bool                 _compact;
+		const FormatOptions& _options;
+		uint32_t             _doc_id;
 
-		Writer(const FormatOptions& options, DocInfo_SP doc)
-			: _options(options), _doc(std::move(doc))
+		Writer(const FormatOptions& options, uint32_t doc_id)
+			: _options(options), _doc_id(doc_id)
 		{
 			_compact = _options.compact();
-
-			for (int i = 0; i < 256; ++i) {
-				SAFE_CHARACTERS[i] = i >= 0x20;
-			}
-
-			SAFE_CHARACTERS[static_cast<uint8_t>('\\')] = false;
-			SAFE_CHARACTERS[static_cast<uint8_t>('\"')] = false;
-			SAFE_CHARACTERS[static_cast<uint8_t>('\0')] = false;
-			SAFE_CHARACTERS[static_cast<uint8_t>('\b')] = false;
-			SAFE_CHARACTERS[static_cast<uint8_t>('\f')] = false;
-			SAFE_CHARACTERS[static_cast<uint8_t>('\n')] = false;
-			SAFE_CHARACTERS[static_cast<uint8_t>('\r')] = false;
-			SAFE_CHARACTERS[static_cast<uint8_t>('\t')] = false;
 		}
 
 		inline void write_indent(unsigned indent)
@@ -3248,12 +8663,14 @@ namespace configuru
 		void write_value(unsigned indent, const Config& config,
 							  bool write_prefix, bool write_postfix)
 		{
-			if (_options.allow_macro && config.doc() && config.doc() != _doc) {
-				dump_file(config.doc()->filename, config, _options);
-				_out += "#include <";
-				_out += config.doc()->filename;
-				_out.push_back('>');
-				return;
+			if (_options.allow_macro && config.doc_id() != 0 && config.doc_id() != _doc_id) {
+				if (auto doc = config.doc()) {
+					dump_file(doc->filename, config, _options);
+					_out += "#include <";
+					_out += doc->filename;
+					_out.push_back('>');
+					return;
+				}
 			}
 
 			if (write_prefix) {
@@ -3271,7 +8688,7 @@ namespace configuru
 			} else if (config.is_float()) {
 				write_number( config.as_double() );
 			} else if (config.is_string()) {
-				write_string(config.as_string());
+				write_string(config.c_str(), config.string_size());
 			} else if (config.is_array()) {
 				if (config.array_size() == 0 && !has_pre_end_brace_comments(config)) {
 					if (_compact) {
@@ -3369,7 +8786,7 @@ namespace configuru
 				std::sort(begin(pairs), end(pairs), [](const ObjIterator& a, const ObjIterator& b) {
 					return a->first < b->first;
 				});
-			} else {
+			} else if (!CONFIGURU_FLAT_OBJECTS) { // Else already in the order they were added
 				std::sort(begin(pairs), end(pairs), [](const ObjIterator& a, const ObjIterator& b) {
 					return a->second._nr < b->second._nr;
 				});
@@ -3409,12 +8826,12 @@ namespace configuru
 			write_pre_brace_comments(indent, config.comments().pre_end_brace);
 		}
 
-		void write_key(const std::string& str)
+		void write_key(const Key& key)
 		{
-			if (_options.identifiers_keys && is_identifier(str.c_str())) {
-				_out += str;
+			if (_options.identifiers_keys && key.is_identifier()) {
+				_out += key.str();
 			} else {
-				write_string(str);
+				write_string(key.str());
 			}
 		}
 
@@ -3496,17 +8913,24 @@ namespace configuru
 		}
 
 		void write_string(const std::string& str)
+		{
+			write_string(str.data(), str.size());
+		}
+
+		void write_string(const char* str, size_t size)
 		{
 			const size_t LONG_LINE = 240;
+			const char* end = str + size;
+			const char* triple_quote = "\"\"\"";
 
-			if (!_options.str_python_multiline      ||
-				str.find('\n') == std::string::npos ||
-				str.length() < LONG_LINE            ||
-				str.find("\"\"\"") != std::string::npos)
+			if (!_options.str_python_multiline              ||
+				size < LONG_LINE                            ||
+				std::find(str, end, '\n') == end            ||
+				std::search(str, end, triple_quote, triple_quote + 3) != end)
 			{
-				write_quoted_string(str);
+				write_quoted_string(str, size);
 			} else {
-				write_verbatim_string(str);
+				write_verbatim_string(str, size);
 			}
 		}
 
@@ -3531,12 +8955,12 @@ namespace configuru
 			write_hex_16(c);
 		}
 
-		void write_quoted_string(const std::string& str)
+		void write_quoted_string(const char* str, size_t size)
 		{
 			_out.push_back('"');
 
-			const char* ptr = str.c_str();
-			const char* end = ptr + str.size();
+			const char* ptr = str;
+			const char* end = ptr + size;
 			while (ptr < end) {
 				// Output large swats of safe characters at once:
 				auto start = ptr;
@@ -3565,10 +8989,10 @@ namespace configuru
 			_out.push_back('"');
 		}
 
-		void write_verbatim_string(const std::string& str)
+		void write_verbatim_string(const char* str, size_t size)
 		{
 			_out += "\"\"\"";
-			_out += str;
+			_out.append(str, size);
 			_out += "\"\"\"";
 		}
 
@@ -3603,7 +9027,7 @@ namespace configuru
 					return false;
 				}
 				if (v.is_string()) {
-					estimated_width += 2 + v.as_string().size();
+					estimated_width += 2 + v.string_size();
 				} else {
 					estimated_width += 5;
 				}
@@ -3615,7 +9039,7 @@ namespace configuru
 
 	std::string dump_string(const Config& config, const FormatOptions& options)
 	{
-		Writer w(options, config.doc());
+		Writer w(options, config.doc_id());
 
 		if (options.implicit_top_object && config.is_object()) {
 			w.write_object_contents(0, config);
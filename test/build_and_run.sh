@@ -31,4 +31,16 @@ cmake -DCMAKE_BUILD_TYPE="Debug" -DCONFIGURU_VALUE_SEMANTICS="OFF" -DCONFIGURU_I
 make
 ./configuru_test $@
 
+echo "Testing CONFIGURU_FLAT_OBJECTS=ON"
+rm -rf *
+cmake -DCMAKE_BUILD_TYPE="Debug" -DCONFIGURU_VALUE_SEMANTICS="OFF" -DCONFIGURU_IMPLICIT_CONVERSIONS="OFF" -DCONFIGURU_FLAT_OBJECTS="ON" ..
+make
+./configuru_test $@
+
+echo "Testing CONFIGURU_LOCATIONS=OFF"
+rm -rf *
+cmake -DCMAKE_BUILD_TYPE="Debug" -DCONFIGURU_VALUE_SEMANTICS="ON" -DCONFIGURU_IMPLICIT_CONVERSIONS="ON" -DCONFIGURU_LOCATIONS="OFF" ..
+make
+./configuru_test $@
+
 echo "All tests passed!"
@@ -21,7 +21,9 @@
 
 #include "simple_test.hpp"
 
+#include <clocale>
 #include <iostream>
+#include <thread>
 
 #include <boost/filesystem.hpp>
 
@@ -168,6 +170,28 @@ void test_strings()
 	test_string("\"\\u00A2\"",                  "\xC2\xA2");         // Cents sign U+00A2
 	test_string("\"\\u20AC\"",                  "\xE2\x82\xAC");     // Euro sign U+20AC
 	test_string("\"\\uD834\\uDD1E\"",           "\xF0\x9D\x84\x9E"); // G clef sign U+1D11E
+
+	// Short strings are stored inside of the Config, longer ones on the heap:
+	for (size_t length = 0; length < 20; ++length) {
+		const std::string str(length, 'x');
+		Config config = str;
+		Config copy = config;
+		Config moved = std::move(config);
+		TEST_EQ(moved.string_size(), length);
+		TEST_EQ(strlen(moved.c_str()), length);
+		TEST_EQ(copy.as_string(), str);
+		TEST(copy == moved);
+	}
+	TEST_EQ(Config("a\0b", 3).as_string(), std::string("a\0b", 3));
+	TEST(Config("a\0b", 3) != Config("a\0c", 3));
+
+	// Reading a string without copying it:
+	const Config long_string = "long enough to be on the heap";
+	TEST_EQ(long_string.get<const char*>(), long_string.c_str());
+	TEST_EQ(strcmp(long_string.c_str(), "long enough to be on the heap"), 0);
+	const FrozenConfig frozen = long_string.freeze();
+	TEST_EQ(frozen.get<const char*>(), frozen.c_str());
+	TEST_EQ(frozen.string_size(), long_string.string_size());
 }
 
 void test_doubles()
@@ -290,6 +314,1134 @@ void test_doubles()
 		"7567186443383770486037861622771738545623065874679014086723327636718751234567890123456789012345678901"
 		"e-308",
 		2.2250738585072014e-308);
+
+	// Digits past those we keep still count towards the exponent:
+	for (const std::string& str : {
+		std::string(850, '9') + "e-530",
+		std::string(850, '1') + "e-1170",
+		std::string(850, '1') + ".25e-849",
+		"0.000" + std::string(900, '7') + "e-300",
+	}) {
+		test_double(str, strtod(str.c_str(), nullptr));
+	}
+
+	{
+		// Must survive a round trip bit-exact:
+		const auto path = "../../test_suite/json_pass/double_precision_floating_point.json";
+		const double max_double = 1.7976931348623157E308;
+		const double parsed = (double)parse_file(path, JSON)["v"];
+		TEST_EQ(parsed, max_double);
+		Config reparsed = parse_string(dump_string(Config{{"v", parsed}}, JSON).c_str(), JSON, "roundtrip");
+		TEST_EQ((double)reparsed["v"], max_double);
+	}
+
+	// The parser must not care about the decimal separator of the current locale:
+	bool tested_locale = false;
+	for (const char* locale : {"de_DE.UTF-8", "de_DE", "fr_FR.UTF-8", "sv_SE.UTF-8"}) {
+		if (setlocale(LC_NUMERIC, locale)) {
+			test_double("3.1416", 3.1416);
+			test_double("-1.234E-10", -1.234E-10);
+			setlocale(LC_NUMERIC, "C");
+			tested_locale = true;
+			break;
+		}
+	}
+	if (!tested_locale) {
+		std::cout << "SKIPPED: decimal comma locale test (no de_DE, fr_FR or sv_SE locale installed)" << std::endl;
+	}
+}
+
+void test_integers()
+{
+	auto test_int = [&](const char* str, int64_t expected)
+	{
+		test_code(__FILE__, __LINE__, str, true, [&]{
+			const Config value = parse_string(str, CFG, "string");
+			TEST(value.is_int());
+			TEST_EQ((int64_t)value, expected);
+		});
+	};
+
+	test_int("0",                             0);
+	test_int("-0",                            0);
+	test_int("7",                             7);
+	test_int("-12345678",                     -12345678);
+	test_int("123456789",                     123456789);
+	test_int("1234567890123456",              1234567890123456ll);
+	test_int("9223372036854775807",           INT64_MAX);
+	test_int("-9223372036854775808",          INT64_MIN);
+	test_int("0xff",                          255);
+	test_int("0xDeadBeef",                    0xDEADBEEFll);
+	test_int("-0x10",                         -16);
+	test_int("0xFFFFFFFFFFFFFFFF",            -1);
+	test_int("0b101",                         5);
+	test_int("-0b11",                         -3);
+
+	// Too large for an int64_t - falls back to a double:
+	for (const char* str : {"9223372036854775808", "-9223372036854775809", "12345678901234567890123"}) {
+		test_code(__FILE__, __LINE__, str, true, [&]{
+			const Config value = parse_string(str, CFG, "string");
+			TEST(value.is_float());
+			TEST_EQ((double)value, strtod(str, nullptr));
+		});
+	}
+
+	// Hexadecimal/binary too large for 64 bits - saturates like strtoull:
+	test_int("0x10000000000000000",           -1);
+	test_int("-0x123456789ABCDEF01",          1);
+	test_int(("0b1" + std::string(64, '0')).c_str(), -1);
+	test_int(("0x" + std::string(20, '0') + "12").c_str(), 0x12);
+
+	test_code(__FILE__, __LINE__, "leading_zero",   false, [&]{ parse_string("0123", CFG, "string"); });
+	test_code(__FILE__, __LINE__, "missing_hex_digits", false, [&]{ parse_string("0xg", CFG, "string"); });
+}
+
+void test_parse_session()
+{
+	ParseSession session(JSON);
+	for (int i = 0; i < 3; ++i) {
+		const std::string message = "{\"id\": " + std::to_string(i) + ", \"text\": \"message with \\\"escapes\\\"\"}";
+		const Config config = session.parse_string(message.c_str(), "message");
+		TEST_EQ((int)config["id"], i);
+		TEST_EQ((std::string)config["text"], "message with \"escapes\"");
+	}
+
+	test_code(__FILE__, __LINE__, "session_parse_error", false, [&]{ session.parse_string("{\"a\": }", "message"); });
+	TEST_EQ((int)session.parse_string("[1, 2]", "message")[1], 2);
+
+	const auto path = "../../test_suite/json_pass/escaping_and_unicode.json";
+	TEST_EQ(dump_string(session.parse_file(path), JSON), dump_string(parse_file(path, JSON), JSON));
+}
+
+void test_bounded_input()
+{
+	// Nothing after the given length may be read:
+	const std::string buffer = "[1, 2, 3.5e2]123456 \"unterminated";
+	const Config array = parse_string(buffer.data(), 13, JSON, "buffer");
+	TEST_EQ(array.array_size(), 3u);
+	TEST_EQ((double)array[2], 350.0);
+
+	TEST_EQ((int)parse_string(buffer.data() + 13, 2, JSON, "buffer"), 12);
+	TEST_EQ((bool)parse_string("truest", 4, JSON, "buffer"), true);
+
+	test_code(__FILE__, __LINE__, "bounded_unterminated_string", false, [&]{ parse_string("\"abc\"", 4, JSON, "buffer"); });
+	test_code(__FILE__, __LINE__, "bounded_cut_keyword",         false, [&]{ parse_string("true", 3, JSON, "buffer"); });
+	test_code(__FILE__, __LINE__, "bounded_embedded_zero",       false, [&]{ parse_string("[1]\0[2]", 7, JSON, "buffer"); });
+
+#if __cplusplus >= 201703L
+	TEST_EQ((int)parse_string(std::string_view(buffer).substr(1, 1), JSON, "buffer"), 1);
+#endif
+}
+
+// Feeds the document in chunks of the given size.
+Config parse_in_chunks(const std::string& str, size_t chunk_size, const FormatOptions& options)
+{
+	IncrementalParser parser(options, "chunks");
+	for (size_t pos = 0; pos < str.size(); pos += chunk_size) {
+		parser.feed(str.data() + pos, std::min(chunk_size, str.size() - pos));
+	}
+	return parser.finish();
+}
+
+void test_incremental_parser()
+{
+	const std::string cfg =
+		"// Settings\n"
+		"pi: 3.14 // Roughly\n"
+		"list: [ 1 2 \"three\" ]\n"
+		"nested: {\n"
+		"\tkey: \"value\" /* block */\n"
+		"}\n";
+	const auto cfg_options = []{ auto options = CFG; options.mark_accessed = false; return options; }();
+	const std::string expected = dump_string(parse_string(cfg.c_str(), cfg_options, "whole"), cfg_options);
+	for (size_t chunk_size : {1, 2, 7, 64, 10000}) {
+		TEST_EQ(dump_string(parse_in_chunks(cfg, chunk_size, cfg_options), cfg_options), expected);
+	}
+
+	std::string json = "[";
+	for (int i = 0; i < 10000; ++i) {
+		json += (i == 0 ? "" : ", ") + std::string("{\"id\": ") + std::to_string(i) + ", \"name\": \"item\"}";
+	}
+	json += "]";
+	const Config array = parse_in_chunks(json, 1000, JSON);
+	TEST_EQ(array.array_size(), 10000u);
+	TEST_EQ((int)array[9999]["id"], 9999);
+	TEST_EQ((int)parse_in_chunks("[42]", 1, JSON)[0], 42);
+	TEST_EQ((int)parse_in_chunks("42", 1, JSON), 42);
+	TEST_EQ(parse_in_chunks("", 1, FORGIVING).object_size(), 0u);
+
+	test_code(__FILE__, __LINE__, "incremental_unterminated", false, [&]{ parse_in_chunks("[1, 2", 1, JSON); });
+	test_code(__FILE__, __LINE__, "incremental_bad_value",    false, [&]{ parse_in_chunks(json + "x", 100, JSON); });
+	test_code(__FILE__, __LINE__, "incremental_bad_key",      false, [&]{ parse_in_chunks("{\"a\": 1, b: 2}", 3, JSON); });
+
+	// Parsed input is let go of, but errors still know where they are:
+	try {
+		parse_in_chunks(json + "x", 100, JSON);
+		TEST_FAIL("incremental_column");
+	} catch (const ParseError& e) {
+		TEST_EQ(e.line(), 1u);
+		TEST_EQ(e.column(), json.size() + 1);
+		TEST(std::string(e.what()).find("...") != std::string::npos);
+	}
+	std::string lines;
+	for (int i = 0; i < 10000; ++i) {
+		lines += "key_" + std::to_string(i) + ": " + std::to_string(i) + "\n";
+	}
+	TEST_EQ((int)parse_in_chunks(lines, 10, CFG)["key_9999"], 9999);
+	try {
+		parse_in_chunks(lines + "bad: [1, 2", 100, CFG);
+		TEST_FAIL("incremental_line");
+	} catch (const ParseError& e) {
+		TEST_EQ(e.line(), 10001u);
+	}
+
+	// An array that never ends is reported where it began, even when that line is long gone:
+	std::string unterminated = "{\"a\": [1, 2, 3,\n";
+	for (int i = 0; i < 3000; ++i) {
+		unterminated += "4,\n";
+	}
+	unterminated += "5]";
+	std::string whole_error = "no error";
+	try {
+		parse_string(unterminated.c_str(), JSON, "chunks");
+	} catch (const ParseError& e) {
+		whole_error = e.what();
+	}
+	try {
+		parse_in_chunks(unterminated, 100, JSON);
+		TEST_FAIL("incremental_unterminated_far");
+	} catch (const ParseError& e) {
+		TEST_EQ(std::string(e.what()), whole_error);
+	}
+
+	IncrementalParser twice(JSON, "twice");
+	twice.feed("42", 2);
+	TEST_EQ((int)twice.finish(), 42);
+	test_code(__FILE__, __LINE__, "incremental_finish_twice", false, [&]{ twice.finish(); });
+	test_code(__FILE__, __LINE__, "incremental_feed_after_finish", false, [&]{ twice.feed("1", 1); });
+}
+
+// Writes down the events it gets, one per line.
+struct EventRecorder : public ParseHandler
+{
+	std::string events;
+
+	void null_value(Index) override                             { events += "null\n"; }
+	void bool_value(Index, bool value) override                 { events += value ? "true\n" : "false\n"; }
+	void int_value(Index, int64_t value) override               { events += "int " + std::to_string(value) + "\n"; }
+	void float_value(Index, double value) override              { events += "float " + std::to_string(value) + "\n"; }
+	void string_value(Index, const std::string& value) override { events += "string " + value + "\n"; }
+	void begin_object(Index) override                           { events += "{\n"; }
+	void key(const std::string& key) override                   { events += "key " + key + "\n"; }
+	void end_object() override                                  { events += "}\n"; }
+	void begin_array(Index line) override                       { events += "[ line " + std::to_string(line) + "\n"; }
+	void end_array() override                                   { events += "]\n"; }
+	void comment(CommentKind kind, const std::string& comment) override
+	{
+		events += "comment " + std::to_string(kind) + " " + comment + "\n";
+	}
+};
+
+void test_parse_handler()
+{
+	EventRecorder recorder;
+	const char* json = "{\"a\": [1, 2.5, \"x\", null, true]}";
+	parse_string(json, strlen(json), JSON, "events", recorder);
+	TEST_EQ(recorder.events, "{\nkey a\n[ line 1\nint 1\nfloat 2.500000\nstring x\nnull\ntrue\n]\n}\n");
+
+	EventRecorder cfg_recorder;
+	const std::string cfg = "// Top\nkey: [\n\tfalse // After\n\t// End\n]\n";
+	parse_string(cfg.c_str(), cfg.size(), CFG, "events", cfg_recorder);
+	TEST_EQ(cfg_recorder.events, "{\ncomment 0 // Top\nkey key\n[ line 2\nfalse\ncomment 1 // After\ncomment 2 // End\n]\n}\n");
+
+	// The default handler ignores everything, including duplicate keys:
+	ParseHandler ignore;
+	const char* duplicate = "{\"a\": 1, \"a\": 2}";
+	parse_string(duplicate, strlen(duplicate), JSON, "events", ignore);
+	test_code(__FILE__, __LINE__, "handler_parse_error", false, [&]{ parse_string("[1, }", 5, JSON, "events", ignore); });
+	test_code(__FILE__, __LINE__, "builder_duplicate_key", false, [&]{ parse_string(duplicate, JSON, "events"); });
+}
+
+using ParseFileFun = std::function<Config(const std::string&, const FormatOptions&)>;
+
+// Parsing lazily/in parallel and then reading everything must give the same result as parsing it all at once.
+void test_lazy_all_in(FormatOptions options, bool should_pass, fs::path dir, std::string extension,
+                      const ParseFileFun& parse = parse_file_lazy)
+{
+	options.mark_accessed = false;
+	for (auto path : list_files(dir, extension)) {
+		test_code(__FILE__, __LINE__, "lazy_" + path.filename().string(), should_pass, [&](){
+			const Config lazy = parse(path.string(), options);
+			TEST_EQ(dump_string(lazy, options), dump_string(parse_file(path.string(), options), options));
+		});
+	}
+}
+
+void test_lazy_parsing()
+{
+	test_lazy_all_in(JSON, true,  "../../test_suite/json_pass", ".json");
+	test_lazy_all_in(CFG,  true,  "../../test_suite/cfg_pass",  ".cfg");
+	test_lazy_all_in(JSON, false, "../../test_suite/json_fail", ".json");
+	test_lazy_all_in(CFG,  false, "../../test_suite/cfg_fail",  ".cfg");
+
+	const std::string cfg =
+		"a: {\n"
+		"\ttext: \"}]\" // ]\n"
+		"\tlist: [ 1, @\"[\"\"\", \"\"\"\n{\"\"\" ]\n"
+		"\tbad: [ 1 2 }\n"
+		"}\n"
+		"b: { /* { */ x: 2 }\n";
+	const Config config = parse_string_lazy(cfg, CFG, "lazy");
+	TEST_EQ((int)config["b"]["x"], 2);
+	#if CONFIGURU_LOCATIONS
+		TEST_EQ(config["a"]["list"].line(), 3u);
+	#endif
+	TEST_EQ((std::string)config["a"]["list"][1], "[\"");
+	TEST_EQ((std::string)config["a"]["list"][2], "\n{");
+	TEST_EQ((std::string)config["a"]["text"], "}]");
+	TEST_EQ(config["a"]["text"].comments().postfix.size(), 1u);
+
+	// The error is found when we reach into the array:
+	const Config& bad = config["a"]["bad"];
+	TEST(bad.is_array());
+	try {
+		bad.as_array();
+		TEST_FAIL("lazy_error");
+	} catch (const ParseError& e) {
+		TEST_EQ(e.line(), 5u);
+		TEST_EQ(e.column(), 13u);
+	}
+
+	// Escaped quotes and brackets in strings, at every offset within the 64-byte blocks skip_json_container looks at:
+	std::string json = "{\"skipped\": [\n";
+	for (int i = 0; i < 130; ++i) {
+		json += "\t[\"" + std::string(static_cast<size_t>(i), 'x') + "\\\\\\\"]{\", \"\\\\\"],\n";
+	}
+	json += "\t[]\n], \"last\": \"[\"}";
+	auto json_options = JSON;
+	json_options.mark_accessed = false;
+	const Config lazy_json = parse_string_lazy(json, json_options, "lazy_json");
+	#if CONFIGURU_LOCATIONS
+		TEST_EQ(lazy_json["last"].line(), 133u);
+	#endif
+	TEST_EQ((std::string)lazy_json["skipped"][129][0], std::string(129, 'x') + "\\\"]{");
+	TEST_EQ(dump_string(lazy_json, json_options), dump_string(parse_string(json.c_str(), json_options, "json"), json_options));
+
+	// An unmatched brace is reported right away:
+	test_code(__FILE__, __LINE__, "lazy_unterminated", false, [&]{ parse_string_lazy("a: { b: [ }", CFG, "lazy"); });
+
+	// Many threads reach into (and copy) the same lazy arrays at once. Each is still parsed just once:
+	std::string records = "[";
+	for (int i = 0; i < 200; ++i) {
+		records += (i == 0 ? "[" : ", [") + std::to_string(i) + ", [" + std::to_string(2 * i) + "]]";
+	}
+	records += "]";
+	const Config shared = parse_string_lazy(records, json_options, "shared");
+	std::vector<std::thread> threads;
+	bool ok[4] = {true, true, true, true};
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&ok, &shared, t]() {
+			for (size_t i = 0; i < 200; ++i) {
+				const size_t ix = (i + 50 * static_cast<size_t>(t)) % 200;
+				const Config copy = shared[ix];
+				ok[t] = ok[t] && (int)shared[ix][0] == (int)ix && (int)copy[1][0] == 2 * (int)ix;
+			}
+		});
+	}
+	for (int t = 0; t < 4; ++t) {
+		threads[static_cast<size_t>(t)].join();
+		TEST(ok[t]);
+	}
+}
+
+void test_parallel_parsing()
+{
+	const ParseFileFun parse_parallel = [](const std::string& path, const FormatOptions& options) {
+		return parse_file_parallel(path, options, 4);
+	};
+	test_lazy_all_in(JSON, true,  "../../test_suite/json_pass", ".json", parse_parallel);
+	test_lazy_all_in(CFG,  true,  "../../test_suite/cfg_pass",  ".cfg",  parse_parallel);
+	test_lazy_all_in(JSON, false, "../../test_suite/json_fail", ".json", parse_parallel);
+	test_lazy_all_in(CFG,  false, "../../test_suite/cfg_fail",  ".cfg",  parse_parallel);
+
+	// Many records, so every thread gets some:
+	std::string cfg;
+	for (int i = 0; i < 1000; ++i) {
+		cfg += "// Record " + std::to_string(i) + "\n";
+		cfg += "r" + std::to_string(i) + ": { z: " + std::to_string(i) + ", a: [ \"}\" ] } // after\n";
+	}
+	auto options = CFG;
+	options.mark_accessed = false;
+	const Config config = parse_string_parallel(cfg, options, "parallel", 4);
+	// The same keys in the same order, with the same comments:
+	TEST_EQ(dump_string(config, options), dump_string(parse_string(cfg.c_str(), options, "eager"), options));
+	#if CONFIGURU_LOCATIONS
+		TEST_EQ(config["r999"]["a"].line(), 2000u);
+	#endif
+	TEST_EQ(config["r500"].comments().prefix.size(), 1u);
+
+	// With several errors, the first one in the file is reported:
+	cfg += "bad_1: { y }\n";
+	for (int i = 0; i < 100; ++i) {
+		cfg += "more" + std::to_string(i) + ": [ 1, 2 ]\n";
+	}
+	cfg += "bad_2: { x }\n";
+	try {
+		parse_string_parallel(cfg, options, "parallel", 4);
+		TEST_FAIL("parallel_error");
+	} catch (const ParseError& e) {
+		TEST_EQ(e.line(), 2001u);
+	}
+}
+
+void test_file_loading()
+{
+	// Large enough to be memory mapped:
+	std::string json = "[\n";
+	for (int i = 0; i < 20000; ++i) {
+		json += "\t{\"index\": " + std::to_string(i) + ", \"name\": \"item\"},\n";
+	}
+	json += "\t\"last\"\n]";
+
+	const auto path = "large_file_test.json";
+	{
+		FILE* fp = fopen(path, "wb");
+		TEST(fp != nullptr);
+		fwrite(json.data(), 1, json.size(), fp);
+		fclose(fp);
+	}
+
+	test_code(__FILE__, __LINE__, "large_file", true, [&]{
+		const Config from_file = parse_file(path, JSON);
+		TEST_EQ(from_file.array_size(), 20001u);
+		TEST_EQ((int)from_file[19999]["index"], 19999);
+		TEST_EQ((std::string)from_file[20000], "last");
+		TEST_EQ(dump_string(from_file, JSON), dump_string(parse_string(json.c_str(), JSON, path), JSON));
+	});
+	remove(path);
+
+	test_code(__FILE__, __LINE__, "missing_file", false, [&]{ parse_file("no_such_file.json", JSON); });
+
+	// A directory can be opened, but not read:
+	const ParseResult unreadable = parse_file_noexcept(".", JSON);
+	TEST(!unreadable);
+	TEST_EQ(unreadable.message.find("Failed to read from '.'"), 0u);
+
+	test_code(__FILE__, __LINE__, "include_key", true, [&]{
+		FILE* fp = fopen("included_test.cfg", "wb");
+		TEST(fp != nullptr);
+		fputs("{ inner: 1 }", fp);
+		fclose(fp);
+		const char* cfg = "outer: #include \"included_test.cfg\"";
+		const Config config = parse_string(cfg, CFG, "include_key");
+		remove("included_test.cfg");
+		TEST_EQ((int)config["outer"]["inner"], 1);
+	});
+
+#if defined(__unix__) || defined(__APPLE__)
+	// Not a regular file:
+	test_code(__FILE__, __LINE__, "special_file", true, [&]{
+		TEST(parse_file("/dev/null", FORGIVING).is_object());
+	});
+#endif
+}
+
+void write_file(const std::string& path, const std::string& contents)
+{
+	FILE* fp = fopen(path.c_str(), "wb");
+	TEST(fp != nullptr);
+	fwrite(contents.data(), 1, contents.size(), fp);
+	fclose(fp);
+}
+
+std::string read_file(const std::string& path)
+{
+	std::string contents;
+	FILE* fp = fopen(path.c_str(), "rb");
+	TEST(fp != nullptr);
+	char buffer[4096];
+	while (size_t n = fread(buffer, 1, sizeof(buffer), fp)) {
+		contents.append(buffer, n);
+	}
+	fclose(fp);
+	return contents;
+}
+
+void test_include_preloading()
+{
+	fs::create_directories("include_test/sub");
+	write_file("include_test/root.cfg",
+		"first: #include \"sub/a.cfg\"\n"
+		"second: #include \"b.cfg\"\n"
+		"third: #include \"sub/a.cfg\"\n"
+		"text: \"#include \\\"no_such_file.cfg\\\"\"\n");
+	write_file("include_test/b.cfg", "{ nested: #include \"sub/a.cfg\", c: #include \"sub/c.cfg\" }");
+	write_file("include_test/sub/a.cfg", "{ a: 1 }");
+	write_file("include_test/sub/c.cfg", "[ 1, 2 ]");
+	write_file("include_test/bad.cfg", "x: #include \"sub/c.cfg\"\ny: #include \"sub/bad_child.cfg\"\n");
+	write_file("include_test/sub/bad_child.cfg", "[ 1, }");
+
+	auto options = CFG;
+	options.mark_accessed = false;
+	const Config serial = parse_file("include_test/root.cfg", options);
+	options.include_threads = 4;
+	const Config preloaded = parse_file("include_test/root.cfg", options);
+	TEST_EQ(dump_string(preloaded, options), dump_string(serial, options));
+	#if CONFIGURU_LOCATIONS
+		TEST_EQ(preloaded["first"].doc()->includers.size(), 3u);
+		TEST_EQ(preloaded["second"]["nested"].doc()->includers[1].line, 1u);
+		TEST_EQ(preloaded["second"]["c"].doc()->filename, "include_test/sub/c.cfg");
+	#endif
+
+	ParseSession session(options);
+	TEST_EQ(dump_string(session.parse_file("include_test/root.cfg"), options), dump_string(serial, options));
+
+	// The error is the same as without preloading:
+	test_code(__FILE__, __LINE__, "preloaded_include_error", false, [&]{ parse_file("include_test/bad.cfg", options); });
+
+	// Records parsed on the same thread share a file they both #include:
+	write_file("include_test/records.cfg", "r1: { v: #include \"sub/a.cfg\" }\nr2: { v: #include \"sub/a.cfg\" }\n");
+	const Config records = parse_file_parallel("include_test/records.cfg", options, 1);
+	#if CONFIGURU_LOCATIONS
+		TEST_EQ(records["r1"]["v"].doc(), records["r2"]["v"].doc());
+		TEST_EQ(records["r2"]["v"].doc()->includers.size(), 2u);
+	#endif
+
+	fs::remove_all("include_test");
+}
+
+void test_include_cache()
+{
+	fs::create_directories("include_test/sub");
+	write_file("include_test/root.cfg", "a: #include \"sub/../a.cfg\"\nb: #include \"b.cfg\"\nalso_a: #include \"a.cfg\"\n");
+	write_file("include_test/other.cfg", "b: #include \"b.cfg\"\n");
+	write_file("include_test/a.cfg", "{ x: 1 }");
+	write_file("include_test/b.cfg", "{ c: #include \"sub/c.cfg\" }");
+	write_file("include_test/sub/c.cfg", "[ 1, 2 ]");
+
+	IncludeCache cache(CFG);
+	const Config first = cache.parse_file("include_test/root.cfg");
+	TEST_EQ(cache.size(), 3u);
+	#if CONFIGURU_LOCATIONS
+		TEST_EQ(first["a"].doc(), first["also_a"].doc()); // The same file
+		TEST_EQ(first["a"].doc()->includers.size(), 2u);
+	#endif
+
+	const Config other = cache.parse_file("include_test/other.cfg");
+	#if CONFIGURU_LOCATIONS
+		TEST_EQ(other["b"].doc()->filename, "include_test/b.cfg");
+		TEST_EQ(other["b"].doc()->includers.size(), 1u);
+		TEST_EQ(other["b"].doc()->includers[0].doc->filename, "include_test/other.cfg");
+		TEST_EQ(other["b"]["c"].doc()->includers[0].doc, other["b"].doc());
+
+		// The earlier result still says where it included b.cfg:
+		TEST_EQ(first["b"].doc()->includers.size(), 1u);
+		TEST_EQ(first["b"].doc()->includers[0].doc->filename, "include_test/root.cfg");
+		TEST_EQ(first["b"]["c"].doc()->includers[0].doc, first["b"].doc());
+		try {
+			first["b"]["c"].as_object();
+			TEST_FAIL("Should have thrown");
+		} catch (std::exception& e) {
+			TEST_EQ(std::string(e.what()), std::string("include_test/sub/c.cfg:1, included at:\n"
+			                                           "    include_test/b.cfg:1, included at:\n"
+			                                           "        include_test/root.cfg:2: Expected object, got array"));
+		}
+	#endif
+
+	// A change in c.cfg means b.cfg must be parsed again, but not a.cfg:
+	write_file("include_test/sub/c.cfg", "[ 1, 2, 3 ]");
+	const Config second = cache.parse_file("include_test/root.cfg");
+	TEST_EQ(second["b"]["c"].array_size(), 3u);
+	#if CONFIGURU_LOCATIONS
+		TEST(second["b"].doc() != first["b"].doc());
+		TEST_EQ(second["a"].doc(), second["also_a"].doc());
+		TEST_EQ(second["a"].doc()->includers.size(), 2u);
+	#endif
+	TEST_EQ((int)second["a"]["x"], 1);
+
+	// Changing a result does not change the cache, whether the file was parsed for it or copied from the cache:
+	write_file("include_test/a.cfg", "{ x: 22 }");
+	Config parsed = cache.parse_file("include_test/root.cfg");
+	Config copied = cache.parse_file("include_test/root.cfg");
+	for (Config* result : {&parsed, &copied}) {
+		(*result)["a"]["x"] = 999;
+		(*result)["a"]["y"] = true;
+	}
+	const Config third = cache.parse_file("include_test/root.cfg");
+	TEST_EQ((int)third["a"]["x"], 22);
+	TEST(!third["a"].has_key("y"));
+
+	fs::remove("include_test/a.cfg");
+	test_code(__FILE__, __LINE__, "cached_include_removed", false, [&]{ cache.parse_file("include_test/root.cfg"); });
+
+	cache.clear();
+	TEST_EQ(cache.size(), 0u);
+	fs::remove_all("include_test");
+}
+
+// The noexcept functions find the same errors as the throwing ones.
+void test_noexcept_all_in(FormatOptions options, fs::path dir, std::string extension)
+{
+	for (auto path : list_files(dir, extension)) {
+		std::string expected = "ok";
+		try {
+			parse_file(path.string(), options);
+		} catch (const std::exception& e) {
+			expected = e.what();
+		}
+		const ParseResult result = parse_file_noexcept(path.string(), options);
+		TEST_EQ(result.ok ? std::string("ok") : result.message, expected);
+	}
+}
+
+void test_parse_noexcept()
+{
+	test_noexcept_all_in(JSON, "../../test_suite/json_pass", ".json");
+	test_noexcept_all_in(JSON, "../../test_suite/json_fail", ".json");
+	test_noexcept_all_in(CFG,  "../../test_suite/cfg_pass",  ".cfg");
+	test_noexcept_all_in(CFG,  "../../test_suite/cfg_fail",  ".cfg");
+
+	const std::string good = "{ \"a\": [1, 2] }";
+	const ParseResult ok = parse_string_noexcept(good.data(), good.size(), JSON, "good");
+	TEST(ok);
+	TEST_EQ((int)ok.config["a"][1], 2);
+
+	const std::string bad = "{\n\t\"a\": [1, 2,, 3]\n}";
+	const ParseResult error = parse_string_noexcept(bad.data(), bad.size(), JSON, "bad");
+	TEST(!error);
+	TEST(!error.config.is_object());
+	TEST_EQ(error.filename, "bad");
+	TEST_EQ(error.line, 2u);
+	TEST_EQ(error.column, 13u);
+	TEST_EQ(error.message, "bad:2:13: Expected value\n    \"a\": [1, 2,, 3]\n               ^");
+
+	// The same forms as parse_string:
+	TEST_EQ((int)parse_string_noexcept("[1, 2]", JSON, "zero_ended").config[1], 2);
+	TEST(!parse_string_noexcept("[1, 2,, 3]", JSON, "zero_ended"));
+#if __cplusplus >= 201703L
+	TEST_EQ((int)parse_string_noexcept(std::string_view(good).substr(7, 6), JSON, "view").config[1], 2);
+#endif
+
+	// An error in an #include:d file is in that file. A missing file is an error at the #include:
+	fs::create_directories("include_test");
+	write_file("include_test/root.cfg", "a: #include \"child.cfg\"\nb: #include \"missing.cfg\"\n");
+	write_file("include_test/child.cfg", "x: 1\ny: [ 2 3 }\n");
+	const ParseResult in_child = parse_file_noexcept("include_test/root.cfg", CFG);
+	TEST_EQ(in_child.filename, "include_test/child.cfg");
+	TEST_EQ(in_child.line, 2u);
+
+	write_file("include_test/child.cfg", "x: 1\n");
+	const ParseResult missing = parse_file_noexcept("include_test/root.cfg", CFG);
+	TEST_EQ(missing.filename, "include_test/root.cfg");
+	TEST_EQ(missing.line, 2u);
+	TEST_EQ(missing.column, 13u);
+
+	const ParseResult no_file = parse_file_noexcept("include_test/no_such_file.cfg", CFG);
+	TEST(!no_file);
+	TEST_EQ(no_file.line, 0u);
+	TEST_EQ(no_file.message.find("Failed to open 'include_test/no_such_file.cfg'"), 0u);
+	fs::remove_all("include_test");
+}
+
+void test_deep_indentation()
+{
+	// Long runs of whitespace and comments, longer than any SIMD block:
+	std::string cfg_text;
+	const int DEPTH = 40;
+	for (int i = 0; i < DEPTH; ++i) {
+		cfg_text += std::string(i, '\t') + "a: {\n\n\n";
+	}
+	cfg_text += std::string(DEPTH, '\t') + "leaf: 42 // " + std::string(100, '-') + "\n";
+	for (int i = DEPTH - 1; i >= 0; --i) {
+		cfg_text += std::string(i, '\t') + "}\n";
+	}
+
+	const auto cfg = parse_string(cfg_text.c_str(), CFG, "deep");
+	const Config* leaf = &cfg;
+	for (int i = 0; i < DEPTH; ++i) {
+		leaf = &(*leaf)["a"];
+	}
+	TEST_EQ((int)(*leaf)["leaf"], 42);
+	#if CONFIGURU_LOCATIONS
+		TEST_EQ((*leaf)["leaf"].line(), 3u * DEPTH + 1u);
+	#endif
+	TEST_EQ((*leaf)["leaf"].comments().postfix.size(), 1u);
+
+	auto two_spaces = CFG;
+	two_spaces.indentation = "  ";
+	std::string spaces_text = "a: {\n" + std::string(2 * 20, ' ') + "b: 1\n}\n";
+	test_code(__FILE__, __LINE__, "too_deep_spaces", false, [&]{
+		parse_string(spaces_text.c_str(), two_spaces, "spaces");
+	});
+	spaces_text = "a: {\n" + std::string(2 * 17 + 1, ' ') + "b: 1\n}\n";
+	try {
+		parse_string(spaces_text.c_str(), two_spaces, "spaces");
+		TEST_FAIL("Should have thrown");
+	} catch (ParseError& e) {
+		TEST_EQ(e.line(), 2u);
+		TEST_EQ(e.column(), 2u * 17 + 1);
+	}
+}
+
+#if CONFIGURU_LOCATIONS
+void test_locations()
+{
+	Config array;
+	Config value;
+	{
+		const Config config = parse_string("a: 1\nb: { c: [ true ] }\n", CFG, "locations.cfg");
+		TEST_EQ(config["b"]["c"][0].where(), "locations.cfg:2: ");
+		TEST_EQ(config["a"].doc_id(), config["b"].doc_id());
+		TEST_EQ(config["b"].doc()->filename, "locations.cfg");
+		array = config["b"]["c"];
+		value = config["a"];
+	}
+
+	// The document is kept alive by every value parsed from it:
+	TEST_EQ(array[0].where(), "locations.cfg:2: ");
+	TEST_EQ(value.where(), "locations.cfg:1: ");
+	array = Config();
+	TEST_EQ(value.where(), "locations.cfg:1: ");
+
+	// ...so its id is not given to another document, though the ids of those that are gone are reused:
+	for (int i = 0; i < 0x10000 + 10; ++i) {
+		parse_string("x: 1", CFG, "other.cfg");
+	}
+	TEST_EQ(value.where(), "locations.cfg:1: ");
+	TEST(parse_string("x: 1", CFG, "other.cfg")["x"].doc_id() != 0);
+	TEST_EQ(value.doc()->filename, "locations.cfg");
+
+	// Including a value that is the whole document, and its copies:
+	Config scalar = parse_string("42", CFG, "scalar.cfg");
+	TEST_EQ(scalar.where(), "scalar.cfg:1: ");
+	Config copy = scalar;
+	const Config moved = std::move(scalar);
+	scalar = Config();
+	TEST_EQ(moved.where(), "scalar.cfg:1: ");
+	try {
+		moved.as_string();
+		TEST_FAIL("Should have thrown");
+	} catch (std::exception& e) {
+		TEST_EQ(std::string(e.what()).find("scalar.cfg:1: Expected string"), 0u);
+	}
+	copy = 7;
+	TEST_EQ(copy.where(), "scalar.cfg:1: ");
+	copy.tag(nullptr, 2, 0);
+	TEST_EQ(copy.where(), "line 2: ");
+	TEST_EQ(moved.freeze().root().where(), "scalar.cfg:1: ");
+}
+#endif // CONFIGURU_LOCATIONS
+
+void test_compact_config()
+{
+	TEST_EQ(sizeof(Config), 16u);
+
+	// Comments are kept outside of the Config, and follow it as it moves around:
+	Config array = Config::array();
+	for (int i = 0; i < 100; ++i) {
+		Config value = i;
+		value.comments().postfix.push_back("// " + std::to_string(i));
+		array.push_back(std::move(value));
+	}
+	TEST_EQ(array[0].comments().postfix[0], "// 0");
+	TEST_EQ(array[99].comments().postfix[0], "// 99");
+
+	Config copy = array[7];
+	copy.comments().postfix[0] = "// copy";
+	TEST_EQ(array[7].comments().postfix[0], "// 7");
+
+	Config other = "other";
+	other.swap(copy);
+	TEST(!copy.has_comments());
+	TEST_EQ(other.comments().postfix[0], "// copy");
+	TEST_EQ((int)other, 7);
+
+	#if CONFIGURU_LOCATIONS
+		// They are stored with the document of the value (along with its line), and go with it to another:
+		Config first = parse_string("// about a\na: 1\n", CFG, "first.cfg");
+		Config moved = std::move(first["a"]);
+		TEST_EQ(moved.line(), 2u);
+		moved.tag(std::make_shared<DocInfo>("second.cfg"), 5, 0);
+		first = Config();
+		TEST_EQ(moved.where(), "second.cfg:5: ");
+		TEST_EQ(moved.comments().prefix[0], "// about a");
+
+		Config third = parse_string("// about b\nb: 2\nc: 3\n", CFG, "third.cfg");
+		third["b"] = std::move(moved); // Takes its location and its comments
+		TEST_EQ(third["b"].where(), "second.cfg:5: ");
+		TEST_EQ(third["b"].comments().prefix[0], "// about a");
+		third["b"] = std::move(third["c"]); // Takes its location, but keeps its comments
+		TEST_EQ(third["b"].where(), "third.cfg:3: ");
+		TEST_EQ(third["b"].comments().prefix[0], "// about a");
+		Config copied = third["b"];
+		third = Config();
+		TEST_EQ(copied.where(), "third.cfg:3: ");
+		TEST_EQ(copied.comments().prefix[0], "// about a");
+	#endif
+}
+
+// Enough keys for a CONFIGURU_FLAT_OBJECTS object to be indexed, and to grow its index a few times.
+void test_large_objects()
+{
+	Config object = Config::object();
+	for (int i = 0; i < 100; ++i) {
+		object["key_" + std::to_string(i)] = i;
+	}
+	TEST(object.emplace("key_42", 0) == false);
+	TEST(object.emplace("key_100", 100));
+	TEST_EQ(object.object_size(), 101u);
+	for (int i = 0; i <= 100; ++i) {
+		TEST_EQ((int)object["key_" + std::to_string(i)], i);
+	}
+	TEST(!object.has_key("key_101"));
+
+	for (int i = 0; i <= 100; i += 2) {
+		TEST(object.erase("key_" + std::to_string(i)));
+	}
+	TEST(!object.erase("key_0"));
+	TEST_EQ(object.object_size(), 50u);
+	for (int i = 0; i <= 100; ++i) {
+		TEST_EQ(object.has_key("key_" + std::to_string(i)), i % 2 == 1);
+	}
+
+	// Written in the order they were added:
+	std::string expected = "{";
+	for (int i = 1; i <= 99; i += 2) {
+		expected += "\"key_" + std::to_string(i) + "\":" + std::to_string(i) + (i < 99 ? "," : "}");
+	}
+	FormatOptions compact = JSON;
+	compact.indentation = "";
+	TEST_EQ(dump_string(object, compact), expected);
+
+	int sum = 0;
+	for (auto&& p : object.as_object()) {
+		TEST_EQ("key_" + std::to_string((int)p.value()), p.key());
+		sum += (int)p.value();
+	}
+	TEST_EQ(sum, 50 * 50);
+
+	const Config parsed = parse_string(expected.c_str(), JSON, "large");
+	TEST(parsed == object);
+	test_code(__FILE__, __LINE__, "duplicate_key", false, [&]{
+		parse_string((expected.substr(0, expected.size() - 1) + ",\"key_51\":1}").c_str(), JSON, "large");
+	});
+
+	object.insert_or_assign("key_0", Config(0));
+	TEST_EQ((int)object["key_0"], 0);
+	TEST(parsed != object);
+}
+
+void test_arena()
+{
+	const std::string json = R"({
+		"name": "A name too long to fit in a Config",
+		"tags": ["short", "a somewhat longer tag"],
+		"nested": {"list": [1, 2, {"deep": "the deepest of strings"}]}
+	})";
+
+	FormatOptions options = JSON;
+	options.arena = true;
+	const Config plain = parse_string(json.c_str(), JSON, "arena");
+
+	Config moved_string, copied_object;
+	{
+		Config config = parse_string(json.c_str(), options, "arena");
+		TEST(config == plain);
+		moved_string  = std::move(config["name"]);
+		copied_object = config["nested"];
+
+		// Changing the document after the parse is fine:
+		config["tags"].push_back("yet another long string");
+		config["tags"][1] = "a replacement for the long tag";
+		config["nested"]["list"][0] = "no longer a number";
+		TEST(config.erase("name"));
+		TEST_EQ(config["tags"][1].as_string(), "a replacement for the long tag");
+		TEST_EQ(config["tags"][2].as_string(), "yet another long string");
+		TEST_EQ(config["nested"]["list"][0].as_string(), "no longer a number");
+	}
+	// Values taken out of the document outlive it:
+	TEST_EQ(moved_string.as_string(), "A name too long to fit in a Config");
+	TEST_EQ(copied_object["list"][2]["deep"].as_string(), "the deepest of strings");
+	copied_object = Config();
+
+	options.arena_huge_pages = true;
+	TEST(parse_string_parallel(json, options, "arena") == plain);
+	TEST(parse_string_lazy(json, options, "arena") == plain);
+}
+
+// Counts what is live, to check that all of it is given back, and at the size it was allocated with:
+struct CountingResource : public configuru::MemoryResource
+{
+	size_t allocations = 0;
+	size_t live_blocks = 0;
+	size_t live_bytes  = 0;
+
+	void* allocate(size_t size, size_t /*alignment*/) override
+	{
+		allocations += 1;
+		live_blocks += 1;
+		live_bytes  += size;
+		return ::operator new(size);
+	}
+
+	void deallocate(void* ptr, size_t size, size_t /*alignment*/) override
+	{
+		live_blocks -= 1;
+		live_bytes  -= size;
+		::operator delete(ptr);
+	}
+};
+
+void test_memory_resource()
+{
+	const std::string json = R"({
+		"name": "A name too long to fit in a Config",
+		"tags": ["short", "a somewhat longer tag"],
+		"nested": {"list": [1, 2, {"deep": "the deepest of strings"}]}
+	})";
+	const Config plain = parse_string(json.c_str(), JSON, "resource");
+
+	CountingResource counter;
+	FormatOptions options = JSON;
+	options.memory_resource = &counter;
+	{
+		Config config = parse_string(json.c_str(), options, "resource");
+		TEST(config == plain);
+		TEST(config.memory_resource() == &counter);
+		TEST(config["name"].memory_resource() == &counter);
+		TEST(config["tags"][0].memory_resource() == nullptr); // Fits in the Config
+		TEST(config["nested"]["list"].memory_resource() == &counter);
+		const size_t parsed = counter.allocations;
+		TEST(parsed > 0u);
+
+		// Copies and changes stay in the resource:
+		#if CONFIGURU_VALUE_SEMANTICS
+			Config clone = config;
+		#else
+			Config clone = config.deep_clone();
+		#endif
+		TEST(clone == plain);
+		TEST(clone["nested"]["list"][2].memory_resource() == &counter);
+		config["tags"].push_back("yet another long string");
+		config["nested"]["list"][2]["deeper"] = Config::array(&counter);
+		config["nested"]["list"][2]["deeper"].push_back(3.14);
+		TEST(counter.allocations > parsed);
+
+		// Our own values:
+		Config own = Config::object(&counter);
+		own["values"] = Config::array(&counter);
+		for (int i = 0; i < 100; ++i) {
+			own["values"].push_back(i);
+		}
+		own["missing"] = Config();
+		TEST_EQ(own["values"].array_size(), 100u);
+	}
+	TEST_EQ(counter.live_blocks, 0u);
+	TEST_EQ(counter.live_bytes,  0u);
+
+	// The chunks of an arena come from the resource too:
+	options.arena = true;
+	Config from_arena = parse_string(json.c_str(), options, "resource");
+	TEST(from_arena == plain);
+	TEST(counter.live_blocks > 0u);
+
+	// What is freed after the parse is reused, so a document that keeps changing does not keep growing:
+	const size_t chunks = counter.live_blocks;
+	for (int i = 0; i < 10000; ++i) {
+		from_arena["nested"]["extra"] = i; // Into the arena, as part of the object
+		from_arena["nested"].erase("extra");
+
+		// ...as is a whole tree of the document deleted at once:
+		Config tree = Config::object(from_arena.memory_resource());
+		tree["list"] = Config::array(from_arena.memory_resource());
+		tree["list"].push_back("a string too long to fit in a Config");
+		from_arena["nested"]["tree"] = std::move(tree);
+		from_arena["nested"].erase("tree");
+	}
+	TEST_EQ(counter.live_blocks, chunks);
+
+	// Copies out of the document come from the resource itself, so they do not keep the arena alive:
+	#if CONFIGURU_VALUE_SEMANTICS
+		Config copied = from_arena["nested"];
+	#else
+		Config copied = from_arena["nested"].deep_clone();
+	#endif
+	TEST(copied.memory_resource() == &counter);
+	TEST(copied["list"][2]["deep"].memory_resource() == &counter);
+	const size_t copied_blocks = counter.live_blocks - chunks;
+	from_arena = Config();
+	TEST_EQ(counter.live_blocks, copied_blocks);
+	TEST_EQ(copied["list"][2]["deep"].as_string(), "the deepest of strings");
+	copied = Config();
+	TEST_EQ(counter.live_blocks, 0u);
+	TEST_EQ(counter.live_bytes,  0u);
+}
+
+void test_freeze()
+{
+	const std::string cfg_text =
+		"name:   \"A name too long to fit in a Config\"\n"
+		"nick:   \"A name too long to fit in a Config\"\n"
+		"port:   8080\n"
+		"ratio:  0.5\n"
+		"debug:  true\n"
+		"nothing: null\n"
+		"tags:   [\"a\", \"b\", { deep: [1, 2, 3] }]\n"
+		"\"\":    \"empty key\"\n"
+		"nested: { a: { b: { c: 42 } } }\n";
+
+	FrozenConfig frozen;
+	TEST(frozen.is_uninitialized());
+	{
+		const Config config = parse_string(cfg_text.c_str(), CFG, "frozen.cfg");
+		frozen = config.freeze();
+		TEST(frozen.to_config() == config);
+		TEST_EQ(frozen["tags"][2]["deep"].where(), config["tags"][2]["deep"].where());
+	}
+
+	// Still readable, and still knows where it came from, when the Config is gone:
+	TEST_EQ(frozen.object_size(), 9u);
+	TEST_EQ(frozen["port"].get<int>(), 8080);
+	TEST_EQ(frozen.get<int>("port"), 8080);
+	TEST_EQ(static_cast<unsigned>(frozen["port"]), 8080u);
+	TEST_EQ(frozen["ratio"].as_double(), 0.5);
+	TEST_EQ(frozen["port"].as_float(), 8080.0f);
+	TEST(frozen["debug"].as_bool());
+	TEST(frozen["nothing"].is_null());
+	TEST_EQ(frozen["name"].as_string(), "A name too long to fit in a Config");
+	TEST_EQ(frozen[""].as_string(), "empty key");
+	TEST_EQ(frozen["nested"]["a"]["b"]["c"].get<int>(), 42);
+
+	// A key in a char buffer ends at its first zero, like with Config:
+	char key[32] = "port";
+	TEST_EQ(frozen[key].get<int>(), 8080);
+	TEST_EQ(frozen.to_config()[key].get<int>(), 8080);
+	key[0] = '\0';
+	TEST_EQ(frozen[key].as_string(), "empty key");
+	#if CONFIGURU_LOCATIONS
+		TEST_EQ(frozen["tags"][2]["deep"].where(), "frozen.cfg:7: ");
+		TEST_EQ(frozen["nested"].where(), "frozen.cfg:9: ");
+	#endif
+
+	// Each string is stored once:
+	TEST(frozen["name"].c_str() == frozen["nick"].c_str());
+
+	TEST(frozen.has_key("tags"));
+	TEST(!frozen.has_key("tag"));
+	TEST_EQ(frozen.count("nested"), 1u);
+	TEST_EQ(frozen.get_or("port", 0), 8080);
+	TEST_EQ(frozen.get_or("missing", 7), 7);
+	TEST_EQ(frozen.get_or({"nested", "a", "b", "c"}, 0), 42);
+	TEST_EQ(frozen.get_or({"nested", "a", "x", "c"}, 0), 0);
+	TEST_EQ(frozen.get_or("missing", "default"), "default");
+
+	std::string keys;
+	for (const auto& p : frozen.as_object()) {
+		keys += p.key() + ",";
+	}
+	TEST_EQ(keys, ",debug,name,nested,nick,nothing,port,ratio,tags,");
+
+	int sum = 0;
+	for (FrozenValue value : frozen["tags"][2]["deep"].as_array()) {
+		sum += value.get<int>();
+	}
+	TEST_EQ(sum, 6);
+	TEST_EQ(frozen["tags"].array_size(), 3u);
+	TEST_EQ(frozen["tags"].as_array()[1].as_string(), "b");
+
+	test_code(__FILE__, __LINE__, "frozen_missing_key", false, [&]{ frozen["nested"]["a"]["x"]; });
+	test_code(__FILE__, __LINE__, "frozen_wrong_type", false, [&]{ frozen["port"].as_string(); });
+	test_code(__FILE__, __LINE__, "frozen_out_of_range", false, [&]{ frozen["tags"][3]; });
+
+	// Copies share the block:
+	const FrozenConfig copy = frozen;
+	frozen = FrozenConfig();
+	TEST_EQ(copy["tags"][0].as_string(), "a");
+
+	// Many keys sharing their first bytes, and keys shorter than the prefix:
+	Config big = Config::object();
+	for (int i = 0; i < 1000; ++i) {
+		big["key_" + std::to_string(i)] = i;
+		big[std::string(static_cast<size_t>(i % 5), 'k') + std::to_string(i)] = -i;
+	}
+	const FrozenConfig frozen_big = big.freeze();
+	TEST_EQ(frozen_big.object_size(), big.object_size());
+	bool all_found = true;
+	for (const auto& p : big.as_object()) {
+		all_found = all_found && frozen_big[p.key()].get<int>() == p.value().get<int>();
+	}
+	TEST(all_found);
+	TEST(!frozen_big.has_key("key_1000"));
+	TEST(!frozen_big.has_key("key_"));
+	TEST(!frozen_big.has_key(""));
+
+	// Lazy arrays and objects are parsed while freezing:
+	const std::string json = R"({"records": [{"id": 1}, {"id": 2, "tags": ["x"]}]})";
+	const FrozenConfig lazy = parse_string_lazy(json, JSON, "lazy").freeze();
+	TEST_EQ(lazy["records"][1]["tags"][0].as_string(), "x");
+	TEST(lazy.to_config() == parse_string(json.c_str(), JSON, "lazy"));
+}
+
+void test_deep_nesting()
+{
+	auto nested = [](size_t depth) { return std::string(depth, '[') + std::string(depth, ']'); };
+
+	FormatOptions options = JSON;
+	options.max_depth = 100;
+	TEST_EQ(dump_string(parse_string(nested(100).c_str(), options, "deep"), JSON), dump_string(parse_string(nested(100).c_str(), JSON, "deep"), JSON));
+	try {
+		parse_string(nested(101).c_str(), options, "deep");
+		TEST_FAIL("Should have thrown");
+	} catch (ParseError& e) {
+		TEST_EQ(e.line(), 1u);
+		TEST_EQ(e.column(), 101u);
+	}
+
+	// A top-level object without braces is one level too:
+	FormatOptions cfg = CFG;
+	cfg.max_depth = 2;
+	TEST_EQ((int)parse_string("a: { b: 1 }", cfg, "deep")["a"]["b"], 1);
+	test_code(__FILE__, __LINE__, "too_deep_cfg", false, [&]{ parse_string("a: { b: [] }", cfg, "deep"); });
+
+	// Parsing in parallel finds the same error, though the second record is parsed on its own:
+	const std::string wide = "[" + nested(99) + ", " + nested(100) + "]";
+	TEST_EQ(parse_string_parallel("[" + nested(99) + "]", options, "deep").array_size(), 1u);
+	test_code(__FILE__, __LINE__, "too_deep_parallel", false, [&]{ parse_string_parallel(wide, options, "deep"); });
+
+	// No limit. Neither parsing nor destroying uses a stack frame per level:
+	options.max_depth = 0;
+	const std::string deep = nested(1000000);
+	ParseHandler handler;
+	parse_string(deep.data(), deep.size(), options, "deep", handler);
+	TEST_EQ(parse_string(deep.data(), deep.size(), options, "deep").array_size(), 1u);
+}
+
+void test_long_strings()
+{
+	// Strings and comments much longer than a SIMD block:
+	const std::string filler = "Lorem ipsum dolor sit amet, consectetur adipiscing elit. ";
+	const std::string cfg_text =
+		"normal: \"" + filler + "\\n\\\"" + filler + "\"\n"
+		"/* " + filler + "\n" + filler + "\n*/\n"
+		"python: \"\"\"" + filler + "\n" + filler + "\"\"\"\n"
+		"csharp: @\"" + filler + "\"\"" + filler + "\"\n"
+		"last: 1\n";
+
+	const auto cfg = parse_string(cfg_text.c_str(), CFG, "long_strings");
+	TEST_EQ(cfg["normal"].as_string(), filler + "\n\"" + filler);
+	TEST_EQ(cfg["python"].as_string(), filler + "\n" + filler);
+	TEST_EQ(cfg["csharp"].as_string(), filler + "\"" + filler);
+	#if CONFIGURU_LOCATIONS
+		TEST_EQ(cfg["python"].line(), 5u);
+		TEST_EQ(cfg["last"].line(), 8u);
+	#endif
+
+	test_code(__FILE__, __LINE__, "unterminated_long_string", false, [&]{
+		parse_string(("\"" + filler + filler).c_str(), CFG, "unterminated");
+	});
+	test_code(__FILE__, __LINE__, "unterminated_long_comment", false, [&]{
+		parse_string(("a: 1 /* " + filler + filler).c_str(), CFG, "unterminated");
+	});
 }
 
 void test_bad_usage()
@@ -350,9 +1502,31 @@ void run_unit_tests()
 	test_all_in(CFG,  false, "../../test_suite/cfg_fail",       ".cfg");
 
 	test_special();
+	test_deep_indentation();
+	test_deep_nesting();
+	test_long_strings();
 	test_bad_usage();
 	test_strings();
 	test_doubles();
+	test_integers();
+	test_parse_session();
+	test_bounded_input();
+	test_incremental_parser();
+	test_parse_handler();
+	test_lazy_parsing();
+	test_parallel_parsing();
+	test_file_loading();
+	test_include_preloading();
+	test_include_cache();
+	test_parse_noexcept();
+	#if CONFIGURU_LOCATIONS
+		test_locations();
+	#endif
+	test_compact_config();
+	test_large_objects();
+	test_arena();
+	test_memory_resource();
+	test_freeze();
 	test_roundtrip_string();
 }
 
@@ -576,7 +1750,33 @@ void test_comments()
 	};
 	rearranged.erase("object");
 	rearranged.erase("array");
+	// The same with CONFIGURU_FLAT_OBJECTS as with a std::map:
+	TEST_EQ(dump_string(rearranged, CFG), read_file(out_2_path));
 	dump_file(out_2_path, rearranged, CFG);
+
+	// The comments of an erased key go with it:
+	Config erased = parse_string("// about a\na: 1\n// about b\nb: 2\nc: 3\n", CFG, "erased");
+	erased.erase("a");
+	TEST_EQ(dump_string(erased, CFG), dump_string(parse_string("// about b\nb: 2\nc: 3\n", CFG, "expected"), CFG));
+	erased.erase("b");
+	TEST_EQ(dump_string(erased, CFG), dump_string(parse_string("c: 3\n", CFG, "expected"), CFG));
+
+	// Comments are still allowed, but not stored:
+	auto options = CFG;
+	options.keep_comments  = false;
+	options.write_comments = false;
+	options.mark_accessed  = false;
+	const Config without = parse_file(in_path, options);
+	TEST_EQ(dump_string(without, options), dump_string(parse_file(in_path, CFG), options));
+	std::function<void(const Config&)> check_no_comments = [&](const Config& value) {
+		TEST(!value.has_comments());
+		if (value.is_object()) {
+			for (const auto& p : value.as_object()) { check_no_comments(p.value()); }
+		} else if (value.is_array()) {
+			for (const auto& element : value.as_array()) { check_no_comments(element); }
+		}
+	};
+	check_no_comments(without);
 }
 
 void test_conversions()
@@ -682,6 +1882,43 @@ void test_swap()
 	TEST_EQ(b["salute"], "goodbye");
 }
 
+void test_interned_keys()
+{
+	const Config a = parse_string(R"({"some_key": 1, "another key": 2})", JSON, "a");
+	const Config b = parse_string(R"({"another key": 3})", JSON, "b");
+	for (auto&& p : a.as_object()) {
+		if (p.key() == "another key") {
+			TEST_EQ(&p.key(), &b.as_object().begin().key()); // One string for both
+		}
+	}
+
+	TEST(Key("foo") == Key(std::string("foo")));
+	TEST(Key("foo") != Key("bar"));
+	TEST(Key("bar") < Key("foo"));
+	TEST(Key("foo_bar").is_identifier());
+	TEST(!Key("another key").is_identifier());
+	TEST(!Key::lookup("another key").is_identifier());
+	TEST_EQ(dump_string(a, CFG), "some_key:    1\n\"another key\": 2\n");
+
+	// Keys come and go on many threads at once:
+	std::vector<std::thread> threads;
+	bool ok[4] = {true, true, true, true};
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&ok, t]() {
+			for (int i = 0; i < 10000; ++i) {
+				Config object = Config::object();
+				object["key_" + std::to_string(i % 100)] = i;
+				const Key key("key_" + std::to_string(i % 7));
+				ok[t] = ok[t] && key.str() == "key_" + std::to_string(i % 7) && object.object_size() == 1;
+			}
+		});
+	}
+	for (int t = 0; t < 4; ++t) {
+		threads[static_cast<size_t>(t)].join();
+		TEST(ok[t]);
+	}
+}
+
 void test_get_or()
 {
 	const Config cfg = parse_string(R"({
@@ -701,7 +1938,11 @@ void test_get_or()
 		cfg.get_or({"a", "b", "c", "key", "not_ok"}, 0);
 		TEST_FAIL("Should have thrown");
 	} catch (std::exception& e) {
-		TEST_EQ(std::string(e.what()), std::string("test_get_or:5: Expected object, got integer"));
+		#if CONFIGURU_LOCATIONS
+			TEST_EQ(std::string(e.what()), std::string("test_get_or:5: Expected object, got integer"));
+		#else
+			TEST_EQ(std::string(e.what()), std::string("Expected object, got integer"));
+		#endif
 	}
 }
 
@@ -794,6 +2035,7 @@ int main()
 	run_unit_tests();
 	test_copy_semantics();
 	test_swap();
+	test_interned_keys();
 	test_get_or();
 	test_serialize_deserialize();
 